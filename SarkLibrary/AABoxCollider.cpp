@@ -1,7 +1,5 @@
 #include "AABoxCollider.h"
 #include "tools.h"
-#include "SphereCollider.h"
-#include "OBoxCollider.h"
 #include "ASceneComponent.h"
 
 namespace sark {
@@ -26,31 +24,35 @@ namespace sark {
 		return ACollider::AABOX;
 	}
 
-	bool AABoxCollider::IntersectWith(const ACollider* coll) const {
-		switch (coll->GetType()) {
-		case ACollider::SPHERE:{
-				const SphereCollider& sphere = reinterpret_cast<const SphereCollider&>(*coll);
-				return tool::Sphere_AABoxIntersection(sphere.pos, sphere.r, min, max);
-			}
-			break;
-		case ACollider::AABOX:{
-				const AABoxCollider& aabB = reinterpret_cast<const AABoxCollider&>(*coll);
-				return tool::AABox_AABoxIntersection(min, max, aabB.min, aabB.max);
-			}
-			break;
-		case ACollider::OBOX:{
-				const OBoxCollider& ob = reinterpret_cast<const OBoxCollider&>(*coll);
-				return tool::AABox_OBoxIntersection(min, max, ob.pos, ob.ext, ob.axis);
-			}
-			break;
-		case ACollider::CONVEXHULL:
-			break;
-		}
-		return false;
-	}
-
 	// update aabox
 	void AABoxCollider::Update() {
 	}
 
+	// get world space bounding box.
+	void AABoxCollider::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		out_min = min - Vector3(GetMargin());
+		out_max = max + Vector3(GetMargin());
+	}
+
+	// the eight corners.
+	uinteger AABoxCollider::GetVertexCount() const {
+		return 8;
+	}
+
+	// get the corner.
+	const Vector3 AABoxCollider::GetWorldPoint(uinteger index) const {
+		return Vector3(
+			(index & 1) ? max.x : min.x,
+			(index & 2) ? max.y : min.y,
+			(index & 4) ? max.z : min.z);
+	}
+
+	// the corner on the side of the direction.
+	const Vector3 AABoxCollider::CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const {
+		const uinteger index = (direction.x >= 0 ? 1 : 0) | (direction.y >= 0 ? 2 : 0) | (direction.z >= 0 ? 4 : 0);
+		if (inout_vertex != NULL)
+			*inout_vertex = index;
+		return GetWorldPoint(index);
+	}
+
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "core.h"
 #include "ACollider.h"
+#include "ASupportShape.h"
 
 namespace sark {
 
@@ -10,7 +11,11 @@ namespace sark {
 	// box that its faces are aligned with
 	// standard coordinates axis orientation.
 	// it is represented as min, max position.
-	class AABoxCollider : public ACollider {
+	class AABoxCollider : public ACollider, public ASupportShape {
+	protected:
+		// the corner on the side of the direction.
+		const Vector3 CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const override;
+
 	public:
 		// minimum position
 		Vector3 min;
@@ -28,11 +33,17 @@ namespace sark {
 		// get type
 		const Type GetType() const override;
 
-		// intersection test
-		bool IntersectWith(const ACollider* coll) const override;
-
 		// update aabox
 		void Update() override;
+
+		// get world space bounding box.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const override;
+
+		// the eight corners.
+		uinteger GetVertexCount() const override;
+
+		// get the corner. the bits of index choose max on x, y, z.
+		const Vector3 GetWorldPoint(uinteger index) const override;
 	};
 
 }
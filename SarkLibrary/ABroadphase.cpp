@@ -0,0 +1,53 @@
+#include "ABroadphase.h"
+
+namespace sark {
+
+	ABroadphase::ABroadphase() {}
+
+	ABroadphase::~ABroadphase() {}
+
+	uint64 ABroadphase::PairKey(ProxyID a, ProxyID b) {
+		return (a < b ? ((uint64)a << 32) | b : ((uint64)b << 32) | a);
+	}
+
+	// add a pair of proxy ids. it does nothing for the existing pair.
+	void ABroadphase::AddPair(ProxyID a, ProxyID b) {
+		auto res = mPairIndices.insert(std::make_pair(PairKey(a, b), (uinteger)mProxyPairs.size()));
+		if (res.second) {
+			ProxyPair pair = { a, b };
+			mProxyPairs.push_back(pair);
+		}
+	}
+
+	// remove a pair of proxy ids.
+	void ABroadphase::RemovePair(ProxyID a, ProxyID b) {
+		auto itr = mPairIndices.find(PairKey(a, b));
+		if (itr != mPairIndices.end())
+			RemovePairAt(itr->second);
+	}
+
+	// remove the pair at the index, and move the last pair into the hole.
+	void ABroadphase::RemovePairAt(uinteger index) {
+		const ProxyPair removed = mProxyPairs[index];
+		mPairIndices.erase(PairKey(removed.a, removed.b));
+		const ProxyPair last = mProxyPairs.back();
+		mProxyPairs.pop_back();
+		if (index < mProxyPairs.size()) {
+			mProxyPairs[index] = last;
+			mPairIndices[PairKey(last.a, last.b)] = index;
+		}
+	}
+
+	// remove all pairs.
+	void ABroadphase::ClearPairs() {
+		mProxyPairs.clear();
+		mPairIndices.clear();
+		mPairs.clear();
+	}
+
+	// get pairs of the last FindPairs.
+	const ABroadphase::PairArray& ABroadphase::GetPairs() const {
+		return mPairs;
+	}
+
+}
@@ -0,0 +1,93 @@
+#ifndef __ABROADPHASE_H__
+#define __ABROADPHASE_H__
+
+#include <vector>
+#include <unordered_map>
+#include "core.h"
+
+namespace sark {
+
+	// abstract broad-phase.
+	// it keeps the bounding boxes (proxies) of the objects, and finds
+	// the pairs of overlapping proxies which are tested by narrow-phase.
+	//   proxy = broadphase->AddProxy(min, max, userData);
+	//   ... every frame ...
+	//   broadphase->UpdateProxy(proxy, min, max);
+	//   const ABroadphase::PairArray& pairs = broadphase->FindPairs();
+	class ABroadphase {
+	public:
+		typedef uinteger ProxyID;
+
+		// overlapping pair of proxies, as their user data.
+		// 'a' is less than 'b'.
+		struct Pair {
+			uinteger a, b;
+		};
+		typedef std::vector<Pair> PairArray;
+
+		static const ProxyID INVALID_PROXY = (ProxyID)-1;
+
+	protected:
+		// overlapping pairs of proxy ids and the index of each pair.
+		struct ProxyPair {
+			ProxyID a, b;
+		};
+		std::vector<ProxyPair> mProxyPairs;
+		std::unordered_map<uint64, uinteger> mPairIndices;
+
+		// pairs of the last FindPairs.
+		PairArray mPairs;
+
+		// add a pair of proxy ids. it does nothing for the existing pair.
+		void AddPair(ProxyID a, ProxyID b);
+
+		// remove a pair of proxy ids. the last pair is moved into the hole.
+		void RemovePair(ProxyID a, ProxyID b);
+
+		// remove the pair at the index of mProxyPairs.
+		void RemovePairAt(uinteger index);
+
+		// remove all pairs.
+		void ClearPairs();
+
+		static uint64 PairKey(ProxyID a, ProxyID b);
+
+	public:
+		ABroadphase();
+		virtual ~ABroadphase();
+
+		// add proxy.
+		// *param:
+		//     min,max  - world space bounding box.
+		//     userData - value which is emitted as the pair.
+		// *return: id of the proxy.
+		virtual ProxyID AddProxy(const Vector3& min, const Vector3& max, uinteger userData) = 0;
+
+		// remove proxy.
+		virtual void RemoveProxy(ProxyID proxy) = 0;
+
+		// update bounding box of proxy.
+		virtual void UpdateProxy(ProxyID proxy, const Vector3& min, const Vector3& max) = 0;
+
+		// change user data of proxy.
+		virtual void SetUserData(ProxyID proxy, uinteger userData) = 0;
+
+		// get user data of proxy.
+		virtual uinteger GetUserData(ProxyID proxy) const = 0;
+
+		// get the number of proxies.
+		virtual uinteger GetProxyCount() const = 0;
+
+		// remove all proxies.
+		virtual void Clear() = 0;
+
+		// get the pairs whose bounding boxes overlap.
+		// the pairs are not sorted.
+		virtual const PairArray& FindPairs() = 0;
+
+		// get pairs of the last FindPairs.
+		const PairArray& GetPairs() const;
+	};
+
+}
+#endif
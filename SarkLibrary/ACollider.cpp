@@ -1,11 +1,205 @@
 #include "ACollider.h"
+#include "ASupportShape.h"
+#include "tools.h"
+#include "GJK_EPA.h"
+#include "SphereCollider.h"
+#include "AABoxCollider.h"
+#include "OBoxCollider.h"
+#include "ConvexHull.h"
+#include "CapsuleCollider.h"
 
 namespace sark {
 
+	namespace {
+
+		bool Sphere_Sphere(const ACollider* a, const ACollider* b) {
+			const SphereCollider* sphereA = static_cast<const SphereCollider*>(a);
+			const SphereCollider* sphereB = static_cast<const SphereCollider*>(b);
+			return tool::Sphere_SphereIntersection(sphereA->pos, sphereA->r, sphereB->pos, sphereB->r);
+		}
+
+		bool Sphere_AABox(const ACollider* a, const ACollider* b) {
+			const SphereCollider* sphere = static_cast<const SphereCollider*>(a);
+			const AABoxCollider* aab = static_cast<const AABoxCollider*>(b);
+			return tool::Sphere_AABoxIntersection(sphere->pos, sphere->r, aab->min, aab->max);
+		}
+
+		bool Sphere_OBox(const ACollider* a, const ACollider* b) {
+			const SphereCollider* sphere = static_cast<const SphereCollider*>(a);
+			const OBoxCollider* ob = static_cast<const OBoxCollider*>(b);
+			Vector3 ext, axis[3];
+			ob->GetOrthonormal(ext, axis);
+			return tool::Sphere_OBoxIntersection(sphere->pos, sphere->r, ob->pos, ext, axis);
+		}
+
+		bool AABox_AABox(const ACollider* a, const ACollider* b) {
+			const AABoxCollider* aabA = static_cast<const AABoxCollider*>(a);
+			const AABoxCollider* aabB = static_cast<const AABoxCollider*>(b);
+			return tool::AABox_AABoxIntersection(aabA->min, aabA->max, aabB->min, aabB->max);
+		}
+
+		bool AABox_OBox(const ACollider* a, const ACollider* b) {
+			const AABoxCollider* aab = static_cast<const AABoxCollider*>(a);
+			const OBoxCollider* ob = static_cast<const OBoxCollider*>(b);
+			Vector3 ext, axis[3];
+			ob->GetOrthonormal(ext, axis);
+			return tool::AABox_OBoxIntersection(aab->min, aab->max, ob->pos, ext, axis);
+		}
+
+		bool OBox_OBox(const ACollider* a, const ACollider* b) {
+			const OBoxCollider* obA = static_cast<const OBoxCollider*>(a);
+			const OBoxCollider* obB = static_cast<const OBoxCollider*>(b);
+			Vector3 extA, axisA[3], extB, axisB[3];
+			obA->GetOrthonormal(extA, axisA);
+			obB->GetOrthonormal(extB, axisB);
+			return tool::OBox_OBoxIntersection(obA->pos, extA, axisA, obB->pos, extB, axisB);
+		}
+
+		// the pair of the support shapes. _A and _B are the collider classes
+		// of the types, so the pointers are adjusted to their support shapes.
+		template<class _A, class _B>
+		bool Support_Support(const ACollider* a, const ACollider* b) {
+			return GJK_EPA::DoGJK(static_cast<const _A*>(a), static_cast<const _B*>(b));
+		}
+
+		// the test of the reversed pair.
+		template<ACollider::IntersectFunc _Func>
+		bool Swapped(const ACollider* a, const ACollider* b) {
+			return _Func(b, a);
+		}
+
+		// intersection tests by the types of the pair.
+		// 'supportFuncs' are GJK tests of all the pairs, for the shapes
+		// with margin.
+		struct DispatchTable {
+			ACollider::IntersectFunc funcs[ACollider::TYPE_COUNT][ACollider::TYPE_COUNT];
+			ACollider::IntersectFunc supportFuncs[ACollider::TYPE_COUNT][ACollider::TYPE_COUNT];
+
+			DispatchTable() {
+				// collider classes of the types. the support shapes are
+				// tested by GJK unless the pair has the analytic test.
+				Set<SphereCollider, SphereCollider>(ACollider::SPHERE, ACollider::SPHERE);
+				Set<SphereCollider, AABoxCollider>(ACollider::SPHERE, ACollider::AABOX);
+				Set<SphereCollider, OBoxCollider>(ACollider::SPHERE, ACollider::OBOX);
+				Set<SphereCollider, ConvexHull>(ACollider::SPHERE, ACollider::CONVEXHULL);
+				Set<SphereCollider, CapsuleCollider>(ACollider::SPHERE, ACollider::CAPSULE);
+				Set<AABoxCollider, AABoxCollider>(ACollider::AABOX, ACollider::AABOX);
+				Set<AABoxCollider, OBoxCollider>(ACollider::AABOX, ACollider::OBOX);
+				Set<AABoxCollider, ConvexHull>(ACollider::AABOX, ACollider::CONVEXHULL);
+				Set<AABoxCollider, CapsuleCollider>(ACollider::AABOX, ACollider::CAPSULE);
+				Set<OBoxCollider, OBoxCollider>(ACollider::OBOX, ACollider::OBOX);
+				Set<OBoxCollider, ConvexHull>(ACollider::OBOX, ACollider::CONVEXHULL);
+				Set<OBoxCollider, CapsuleCollider>(ACollider::OBOX, ACollider::CAPSULE);
+				Set<ConvexHull, ConvexHull>(ACollider::CONVEXHULL, ACollider::CONVEXHULL);
+				Set<ConvexHull, CapsuleCollider>(ACollider::CONVEXHULL, ACollider::CAPSULE);
+				Set<CapsuleCollider, CapsuleCollider>(ACollider::CAPSULE, ACollider::CAPSULE);
+				for (uinteger a = 0; a < ACollider::TYPE_COUNT; a++) {
+					for (uinteger b = 0; b < ACollider::TYPE_COUNT; b++)
+						supportFuncs[a][b] = funcs[a][b];
+				}
+
+				// analytic tests.
+				Set<Sphere_Sphere>(ACollider::SPHERE, ACollider::SPHERE);
+				Set<Sphere_AABox>(ACollider::SPHERE, ACollider::AABOX);
+				Set<Sphere_OBox>(ACollider::SPHERE, ACollider::OBOX);
+				Set<AABox_AABox>(ACollider::AABOX, ACollider::AABOX);
+				Set<AABox_OBox>(ACollider::AABOX, ACollider::OBOX);
+				Set<OBox_OBox>(ACollider::OBOX, ACollider::OBOX);
+			}
+
+			// set the test of the pair, and of the reversed pair.
+			template<ACollider::IntersectFunc _Func>
+			void Set(ACollider::Type a, ACollider::Type b) {
+				funcs[a][b] = _Func;
+				if (a != b)
+					funcs[b][a] = Swapped<_Func>;
+			}
+
+			template<class _A, class _B>
+			void Set(ACollider::Type a, ACollider::Type b) {
+				Set<Support_Support<_A, _B> >(a, b);
+			}
+		};
+
+		const DispatchTable DISPATCH_TABLE;
+
+	}
+
 	ACollider::ACollider(ASceneComponent* reference)
-		: mReference(reference)
+		: mReference(reference), mCategory(1), mMask(ALL_CATEGORIES), mTrigger(false)
 	{}
 
 	ACollider::~ACollider() {}
 
+	// get category bits.
+	uinteger ACollider::GetCategory() const {
+		return mCategory;
+	}
+
+	// set category bits.
+	void ACollider::SetCategory(uinteger category) {
+		mCategory = category;
+	}
+
+	// get mask bits.
+	uinteger ACollider::GetMask() const {
+		return mMask;
+	}
+
+	// set mask bits.
+	void ACollider::SetMask(uinteger mask) {
+		mMask = mask;
+	}
+
+	// whether it is trigger.
+	bool ACollider::IsTrigger() const {
+		return mTrigger;
+	}
+
+	// set trigger mode.
+	void ACollider::SetTrigger(bool trigger) {
+		mTrigger = trigger;
+	}
+
+	// whether the pair passes the category and the mask bits.
+	bool ACollider::CanCollide(const ACollider* a, const ACollider* b) {
+		return (a->mCategory & b->mMask) != 0 && (b->mCategory & a->mMask) != 0;
+	}
+
+	// intersection test.
+	bool ACollider::IntersectWith(const ACollider* coll) const {
+		return Intersect(this, coll);
+	}
+
+	// intersection test of two colliders.
+	bool ACollider::Intersect(const ACollider* a, const ACollider* b) {
+		if (HasMargin(a, b))
+			return DISPATCH_TABLE.supportFuncs[a->GetType()][b->GetType()](a, b);
+		return DISPATCH_TABLE.funcs[a->GetType()][b->GetType()](a, b);
+	}
+
+	// get support mapping of the collider.
+	const ASupportShape* ACollider::GetSupportShape(const ACollider* coll) {
+		switch (coll->GetType()) {
+		case SPHERE:
+			return static_cast<const SphereCollider*>(coll);
+		case AABOX:
+			return static_cast<const AABoxCollider*>(coll);
+		case OBOX:
+			return static_cast<const OBoxCollider*>(coll);
+		case CONVEXHULL:
+			return static_cast<const ConvexHull*>(coll);
+		case CAPSULE:
+			return static_cast<const CapsuleCollider*>(coll);
+		case TYPE_COUNT:
+			break;
+		}
+		return NULL;
+	}
+
+	// whether either of the pair has margin.
+	bool ACollider::HasMargin(const ACollider* a, const ACollider* b) {
+		return GetSupportShape(a)->GetMargin() != 0 || GetSupportShape(b)->GetMargin() != 0;
+	}
+
 }
\ No newline at end of file
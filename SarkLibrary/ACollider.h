@@ -6,15 +6,38 @@
 namespace sark {
 
 	class ASceneComponent;
+	class ASupportShape;
 
 	// interface of collider.
+	// the pairs are filtered by the category and the mask bits before
+	// any test. two colliders collide only if the category of each one
+	// is in the mask of the other.
+	// the trigger collider does not make contacts. its overlaps are
+	// reported by the boolean test. (see Collision::GetTriggerOverlaps)
+	//   coll->SetCategory(1 << 2);
+	//   coll->SetMask(ACollider::ALL_CATEGORIES & ~(1 << 2));
 	class ACollider {
 	public:
-		enum Type { SPHERE, AABOX, OBOX, CONVEXHULL };
+		enum Type { SPHERE, AABOX, OBOX, CONVEXHULL, CAPSULE, TYPE_COUNT };
+
+		// intersection test of a pair of colliders, whose types are
+		// the row and the column of the dispatch table.
+		typedef bool(*IntersectFunc)(const ACollider* a, const ACollider* b);
+
+		// the mask of all the categories.
+		static const uinteger ALL_CATEGORIES = 0xffffffff;
 
 	protected:
 		// refernece pointer.
 		ASceneComponent* mReference;
+
+		// category bits of the collider, and the categories which it
+		// collides with.
+		uinteger mCategory;
+		uinteger mMask;
+
+		// whether it only reports the overlaps.
+		bool mTrigger;
 		
 	public:
 		ACollider(ASceneComponent* reference);
@@ -24,11 +47,51 @@ namespace sark {
 		// get type of collider
 		virtual const Type GetType() const = 0;
 
+		// get category bits. (1 by default)
+		uinteger GetCategory() const;
+
+		// set category bits.
+		void SetCategory(uinteger category);
+
+		// get mask bits. (ALL_CATEGORIES by default)
+		uinteger GetMask() const;
+
+		// set mask bits.
+		void SetMask(uinteger mask);
+
+		// whether it is trigger. (false by default)
+		bool IsTrigger() const;
+
+		// set trigger mode.
+		void SetTrigger(bool trigger);
+
+		// whether the pair passes the category and the mask bits.
+		static bool CanCollide(const ACollider* a, const ACollider* b);
+
 		// intersection test.
-		virtual bool IntersectWith(const ACollider* coll) const = 0;
+		// it is dispatched by the types of the pair. (see Intersect)
+		bool IntersectWith(const ACollider* coll) const;
+
+		// intersection test of two colliders.
+		// the pairs of the basic shapes have the analytic tests, and the
+		// others are tested by GJK with the support mappings of them.
+		// the pairs with margin are always tested by GJK, since the
+		// analytic tests do not round the shapes.
+		static bool Intersect(const ACollider* a, const ACollider* b);
+
+		// get support mapping of the collider, for GJK and EPA.
+		static const ASupportShape* GetSupportShape(const ACollider* coll);
+
+		// whether either of the pair has margin. (see ASupportShape::SetMargin)
+		static bool HasMargin(const ACollider* a, const ACollider* b);
 
 		// update collider.
 		virtual void Update() = 0;
+
+		// get world space axis aligned bounding box of the last update.
+		// it is for broad-phase, so it can be larger than the shape.
+		// it includes the margin of the support shape.
+		virtual void GetBounds(Vector3& out_min, Vector3& out_max) const = 0;
 	};
 
 }
@@ -3,6 +3,7 @@
 #include "Material.h"
 #include "RigidBody.h"
 #include "ACollider.h"
+#include "CollisionGeometry.h"
 
 namespace sark {
 
@@ -37,6 +38,27 @@ namespace sark {
 		return mMesh;
 	}
 
+	// get triangle geometry for the mesh level collision detection.
+	const CollisionGeometry* AModel::GetCollisionGeometry() {
+		if (mCollisionGeometry == NULL) {
+			// the empty one is kept, so the mesh is mapped only once
+			// even if it is not a triangle mesh.
+			mCollisionGeometry = s_ptr<CollisionGeometry>(new CollisionGeometry());
+#ifndef SARKLIB_HEADLESS
+			if (mMesh != NULL)
+				mCollisionGeometry->Build(mMesh);
+#endif
+		}
+		if (mCollisionGeometry->Empty())
+			return NULL;
+		return mCollisionGeometry.get();
+	}
+
+	// set triangle geometry for collision detection.
+	void AModel::SetCollisionGeometry(const s_ptr<CollisionGeometry>& geometry) {
+		mCollisionGeometry = geometry;
+	}
+
 	Material* AModel::GetMaterial() {
 		return mMaterial;
 	}
@@ -12,6 +12,7 @@ namespace sark {
 	class Material;
 	class RigidBody;
 	class ACollider;
+	class CollisionGeometry;
 
 	// renderable model component.
 	// for simplification, it uses single mesh model.
@@ -29,6 +30,10 @@ namespace sark {
 		// model can have its own collider.
 		ACollider* mCollider;
 
+		// triangle geometry for collision detection.
+		// it can be shared with the other models.
+		s_ptr<CollisionGeometry> mCollisionGeometry;
+
 	public:
 		AModel(const std::string& name, ASceneComponent* parent, bool activate);
 
@@ -44,6 +49,17 @@ namespace sark {
 		// get mesh object of scene component.
 		Mesh* GetMesh() override;
 
+		// get triangle geometry for the mesh level collision detection.
+		// if it is not set, it is built once from the mesh on the first
+		// call, which maps the buffers of the mesh.
+		// *return: NULL if it is not set and the mesh is not an indexed
+		//          triangle mesh.
+		const CollisionGeometry* GetCollisionGeometry() override;
+
+		// set triangle geometry for collision detection.
+		// set NULL to build it again from the mesh on the next request.
+		void SetCollisionGeometry(const s_ptr<CollisionGeometry>& geometry);
+
 		// get material reference of model
 		Material* GetMaterial();
 
@@ -1,5 +1,11 @@
 #include "AScene.h"
 #include <algorithm>
+#include "ACollider.h"
+#include "ASupportShape.h"
+#include "GJK_EPA.h"
+#include "ThreadPool.h"
+#include "Ray.h"
+#include "tools.h"
 
 namespace sark {
 
@@ -25,6 +31,7 @@ namespace sark {
 		ReplicaArray::iterator end = mReplicas.end();
 		for (; itr != end; itr++) {
 			if ((*itr)->GetComponentID() == componentId) {
+				RemoveProxy(*itr);
 				mReplicas.erase(itr);
 				break;
 			}
@@ -32,6 +39,7 @@ namespace sark {
 	}
 	// pop component from this layer
 	void AScene::Layer::Pop(ReplicaArrayIterator itrator) {
+		RemoveProxy(*itrator);
 		mReplicas.erase(itrator);
 	}
 
@@ -64,6 +72,215 @@ namespace sark {
 	// clear layer
 	void AScene::Layer::Clear() {
 		mReplicas.clear();
+		mTree.Clear();
+		mProxies.clear();
+		mProxyOwners.clear();
+	}
+
+	void AScene::Layer::RemoveProxy(ASceneComponent* component) {
+		auto itr = mProxies.find(component);
+		if (itr != mProxies.end()) {
+			mTree.RemoveProxy(itr->second);
+			mProxyOwners[itr->second] = NULL;
+			mProxies.erase(itr);
+		}
+	}
+
+	// update the bounding boxes of the colliders in the tree.
+	// the leaves are reinserted only for the components which moved
+	// out of their fat boxes.
+	void AScene::Layer::UpdateBounds() {
+		Vector3 min, max;
+		ReplicaArray::iterator itr = mReplicas.begin();
+		ReplicaArray::iterator end = mReplicas.end();
+		for (; itr != end; itr++) {
+			ACollider* coll = (*itr)->GetCollider();
+			if (coll == NULL) {
+				RemoveProxy(*itr);
+				continue;
+			}
+
+			coll->GetBounds(min, max);
+			auto res = mProxies.insert(std::make_pair(*itr, DynamicAABBTree::INVALID_PROXY));
+			if (res.second) {
+				const DynamicAABBTree::ProxyID id = mTree.AddProxy(min, max, 0);
+				if (id >= mProxyOwners.size())
+					mProxyOwners.resize(id + 1, NULL);
+				mProxyOwners[id] = *itr;
+				res.first->second = id;
+			}
+			else {
+				mTree.MoveProxy(res.first->second, min, max);
+			}
+		}
+	}
+
+	// find the nearest component whose collider intersects with the ray.
+	// the ray is clipped by the nearest hit, so the farther subtrees are skipped.
+	ASceneComponent* AScene::Layer::RayCast(const Ray& ray, Vector3* out_P) const {
+		ASceneComponent* nearest = NULL;
+		const real dirSq = ray.dir.MagnitudeSq();
+		if (dirSq <= 0)
+			return NULL;
+
+		mTree.RayCast(ray.pos, ray.dir, ray.limit, [&](DynamicAABBTree::ProxyID id, real limit)->real {
+			ASceneComponent* component = mProxyOwners[id];
+			const ACollider* coll = component->GetCollider();
+			Vector3 P;
+			if (coll == NULL || !Ray(ray.pos, ray.dir, limit).IntersectWith(coll, &P))
+				return limit;
+
+			const real t = (P - ray.pos).Dot(ray.dir) / dirSq;
+			if (t > limit)
+				return limit;
+			nearest = component;
+			if (out_P != NULL)
+				*out_P = P;
+			return t;
+		});
+		return nearest;
+	}
+
+	// find the nearest hit of each ray.
+	// each chunk of the batch is cast in the packets, and the lanes of
+	// the packet are clipped by their own nearest hits.
+	void AScene::Layer::RayCastBatch(const Ray* rays, uinteger count, Hit* out_hits,
+		ThreadPool* pool) const
+	{
+		const uinteger PACKET_SIZE = DynamicAABBTree::PACKET_SIZE;
+		auto body = [&](uinteger begin, uinteger end, uinteger) {
+			Vector3 pos[PACKET_SIZE], dir[PACKET_SIZE];
+			real limits[PACKET_SIZE];
+			for (uinteger i = begin; i < end; i += PACKET_SIZE) {
+				// the empty lanes of the last packet have 0 limit.
+				for (uinteger k = 0; k < PACKET_SIZE; k++) {
+					pos[k] = 0;
+					dir[k] = Vector3::Forward;
+					limits[k] = 0;
+					if (i + k >= end)
+						continue;
+					const Ray& ray = rays[i + k];
+					out_hits[i + k].component = NULL;
+					out_hits[i + k].t = ray.limit;
+					if (ray.dir.MagnitudeSq() <= 0)
+						continue;
+					pos[k] = ray.pos;
+					dir[k] = ray.dir;
+					limits[k] = ray.limit;
+				}
+
+				mTree.RayCastPacket(pos, dir, limits,
+					[&](DynamicAABBTree::ProxyID id, uinteger mask, real* limits) {
+					ASceneComponent* component = mProxyOwners[id];
+					const ACollider* coll = component->GetCollider();
+					if (coll == NULL)
+						return;
+
+					Vector3 P, N;
+					for (uinteger k = 0; k < PACKET_SIZE; k++) {
+						if ((mask & (1 << k)) == 0
+							|| !Ray(pos[k], dir[k], limits[k]).IntersectWith(coll, &P, &N))
+							continue;
+						const real t = (P - pos[k]).Dot(dir[k]) / dir[k].MagnitudeSq();
+						if (t > limits[k])
+							continue;
+						Hit& hit = out_hits[i + k];
+						hit.component = component;
+						hit.point = P;
+						hit.normal = N;
+						hit.t = t;
+						limits[k] = t;
+					}
+				});
+			}
+		};
+
+		// the chunks are the multiple of the packet size.
+		if (pool != NULL && count > QUERY_GRAIN)
+			pool->ParallelFor(count, QUERY_GRAIN, body);
+		else
+			body(0, count, 0);
+	}
+
+	// find the nearest hit of each sweep.
+	void AScene::Layer::SweepBatch(const Sweep* sweeps, uinteger count, Hit* out_hits,
+		ThreadPool* pool) const
+	{
+		auto body = [&](uinteger begin, uinteger end, uinteger) {
+			for (uinteger i = begin; i < end; i++) {
+				const Sweep& sweep = sweeps[i];
+				Hit& hit = out_hits[i];
+				hit.component = NULL;
+				hit.t = sweep.limit;
+				if (sweep.shape == NULL || sweep.dir.MagnitudeSq() <= 0 || sweep.limit <= 0)
+					continue;
+
+				// bounding box of the shape by its support points.
+				Vector3 min, max;
+				for (uinteger a = 0; a < 3; a++) {
+					Vector3 axis(0.f);
+					axis.v[a] = 1;
+					max.v[a] = sweep.shape->SupportPoint(axis).v[a];
+					min.v[a] = sweep.shape->SupportPoint(-axis).v[a];
+				}
+
+				mTree.BoxCast((min + max) / 2.f, (max - min) / 2.f, sweep.dir, sweep.limit,
+					[&](DynamicAABBTree::ProxyID id, real limit)->real {
+					ASceneComponent* component = mProxyOwners[id];
+					const ACollider* coll = component->GetCollider();
+					real toi;
+					Vector3 P, N;
+					if (coll == NULL || !GJK_EPA::DoLinearCast(sweep.shape, ACollider::GetSupportShape(coll),
+						sweep.dir * limit, &toi, &N, &P))
+						return limit;
+
+					hit.component = component;
+					hit.point = P;
+					hit.normal = N;
+					hit.t = limit * toi;
+					return hit.t;
+				});
+			}
+		};
+
+		if (pool != NULL && count > QUERY_GRAIN)
+			pool->ParallelFor(count, QUERY_GRAIN, body);
+		else
+			body(0, count, 0);
+	}
+
+	// find all the components whose collider intersects with the ray.
+	void AScene::Layer::RayCastAll(const Ray& ray, std::vector<ASceneComponent*>& out_components,
+		std::vector<Vector3>* out_points) const
+	{
+		mTree.RayCast(ray.pos, ray.dir, ray.limit, [&](DynamicAABBTree::ProxyID id, real limit)->real {
+			ASceneComponent* component = mProxyOwners[id];
+			const ACollider* coll = component->GetCollider();
+			Vector3 P;
+			if (coll != NULL && ray.IntersectWith(coll, &P)) {
+				out_components.push_back(component);
+				if (out_points != NULL)
+					out_points->push_back(P);
+			}
+			return limit;
+		});
+	}
+
+	// find the components whose bounding box of collider overlaps with given box.
+	void AScene::Layer::Query(const Vector3& min, const Vector3& max,
+		std::vector<ASceneComponent*>& out_components) const
+	{
+		Vector3 cmin, cmax;
+		mTree.Query(min, max, [&](DynamicAABBTree::ProxyID id)->bool {
+			ASceneComponent* component = mProxyOwners[id];
+			const ACollider* coll = component->GetCollider();
+			if (coll == NULL)
+				return true;
+			coll->GetBounds(cmin, cmax);
+			if (tool::AABox_AABoxIntersection(min, max, cmin, cmax))
+				out_components.push_back(component);
+			return true;
+		});
 	}
 
 	
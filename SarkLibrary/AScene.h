@@ -5,12 +5,18 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <unordered_map>
 #include "core.h"
 #include "ASceneComponent.h"
 #include "Camera.h"
+#include "DynamicAABBTree.h"
 
 namespace sark {
 
+	class Ray;
+	class ASupportShape;
+	class ThreadPool;
+
 	// pure abstract scene class.
 	// 'scene' is one of a major element of the engine.
 	// it is generally though of as the action in a single location(scene space)
@@ -29,9 +35,47 @@ namespace sark {
 		public:
 			typedef std::list<ASceneComponent*> ReplicaArray;
 			typedef ReplicaArray::iterator ReplicaArrayIterator;
+
+			// nearest hit of a ray or a sweep.
+			struct Hit {
+				// the component which is hit, or NULL if there is no hit.
+				ASceneComponent* component;
+
+				// the point on the collider.
+				Vector3 point;
+
+				// unit normal of the collider at the point.
+				Vector3 normal;
+
+				// the ray or the shape is at (pos + dir * t) on the hit.
+				// it is the limit if there is no hit.
+				real t;
+			};
+
+			// sweep of a convex shape along the direction.
+			// the shape is at its position by the last update.
+			// (e.g. SphereCollider or OBoxCollider without reference)
+			struct Sweep {
+				const ASupportShape* shape;
+				Vector3 dir;
+				real limit;
+			};
+
+			// the number of queries in a chunk of the parallel batches.
+			static const uinteger QUERY_GRAIN = 64;
+
 		private:
 			ReplicaArray mReplicas;
 
+			// bounding volume tree of the colliders for the scene queries.
+			// the proxies are updated by UpdateBounds.
+			DynamicAABBTree mTree;
+			std::unordered_map<ASceneComponent*, DynamicAABBTree::ProxyID> mProxies;
+			// component of each proxy id.
+			std::vector<ASceneComponent*> mProxyOwners;
+
+			void RemoveProxy(ASceneComponent* component);
+
 		public:
 			Layer();
 			~Layer();
@@ -55,6 +99,61 @@ namespace sark {
 
 			// clear layer
 			void Clear();
+
+			// update the bounding boxes of the colliders in the tree.
+			// it should be called after the components moved, before the
+			// queries. the components without collider are not queried.
+			void UpdateBounds();
+
+			// find the nearest component whose collider intersects with the ray.
+			// *param:
+			//     ray   - ray in world space.
+			//     out_P - intersected point of the nearest component.
+			// *return: the nearest component, or NULL if there is no hit.
+			ASceneComponent* RayCast(const Ray& ray, Vector3* out_P = NULL) const;
+
+			// find the nearest hit of each ray.
+			// the rays are cast on the tree in the packets of four (see
+			// DynamicAABBTree::RayCastPacket), so the coherent rays share
+			// the traversal.
+			// *param:
+			//     rays     - rays in world space.
+			//     count    - the number of rays.
+			//     out_hits - the nearest hit of each ray.
+			//     pool     - workers which run the chunks of the batch in
+			//                parallel. NULL runs it on the calling thread.
+			void RayCastBatch(const Ray* rays, uinteger count, Hit* out_hits,
+				ThreadPool* pool = NULL) const;
+
+			// find the nearest hit of each sweep.
+			// the bounding box of the shape is cast on the tree, and the
+			// colliders are tested by GJK linear cast. (see GJK_EPA::DoLinearCast)
+			// the shape which overlaps a collider at the start does not hit it.
+			// *param:
+			//     sweeps   - sweeps in world space.
+			//     count    - the number of sweeps.
+			//     out_hits - the nearest hit of each sweep. the point is
+			//                on the collider.
+			//     pool     - workers of the batch. (see RayCastBatch)
+			void SweepBatch(const Sweep* sweeps, uinteger count, Hit* out_hits,
+				ThreadPool* pool = NULL) const;
+
+			// find all the components whose collider intersects with the ray.
+			// the results are not sorted.
+			// *param:
+			//     ray            - ray in world space.
+			//     out_components - intersected components. (appended)
+			//     out_points     - intersected point of each component. (appended)
+			void RayCastAll(const Ray& ray, std::vector<ASceneComponent*>& out_components,
+				std::vector<Vector3>* out_points = NULL) const;
+
+			// find the components whose bounding box of collider
+			// overlaps with given box.
+			// *param:
+			//     min,max        - world space bounding box.
+			//     out_components - overlapped components. (appended)
+			void Query(const Vector3& min, const Vector3& max,
+				std::vector<ASceneComponent*>& out_components) const;
 		};
 		
 		typedef std::map<ASceneComponent::ComponentID, ASceneComponent*> ComponentMap;
@@ -12,6 +12,7 @@ namespace sark {
 
 	class ACollider;
 	class Mesh;
+	class CollisionGeometry;
 	class RigidBody;
 
 	// pure abstract scene components class.
@@ -124,6 +125,10 @@ namespace sark {
 		// it can be NULL for the shapeless component like light.
 		virtual Mesh* GetMesh() = 0;
 
+		// get triangle geometry for the mesh level collision detection.
+		// it can be NULL for the component which is not collidable.
+		virtual const CollisionGeometry* GetCollisionGeometry() = 0;
+
 		// get rigid body. it can be NULL for the non-rigid body.
 		virtual RigidBody* GetRigidBody() = 0;
 
@@ -0,0 +1,30 @@
+#include "ASupportShape.h"
+
+namespace sark {
+
+	ASupportShape::ASupportShape()
+		: mMargin(0) {}
+
+	ASupportShape::~ASupportShape() {}
+
+	// get margin.
+	real ASupportShape::GetMargin() const {
+		return mMargin;
+	}
+
+	// set margin.
+	void ASupportShape::SetMargin(real margin) {
+		mMargin = margin;
+	}
+
+	// get the farthest point in given direction, with margin.
+	const Vector3 ASupportShape::SupportPoint(const Vector3& direction, uinteger* inout_vertex) const {
+		if (mMargin == 0)
+			return CoreSupportPoint(direction, inout_vertex);
+		const real len = direction.Magnitude();
+		if (len == 0)
+			return CoreSupportPoint(direction, inout_vertex);
+		return CoreSupportPoint(direction, inout_vertex) + direction * (mMargin / len);
+	}
+
+}
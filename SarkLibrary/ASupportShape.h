@@ -0,0 +1,59 @@
+#ifndef __A_SUPPORT_SHAPE_H__
+#define __A_SUPPORT_SHAPE_H__
+
+#include "core.h"
+
+namespace sark {
+
+	// interface of convex shape by its support mapping.
+	// GJK and EPA only ask the farthest point in a direction, so the
+	// shapes need not be point sets. the curved shapes (sphere, capsule)
+	// answer it analytically by one evaluation.
+	// the shape can be inflated by the margin, which rounds its corners
+	// and edges off. (e.g. convex hull of a few points with margin)
+	// the bounds of the colliders include it, and the pairs with margin
+	// are tested by GJK instead of the analytic tests. (see ACollider::Intersect)
+	//   const Vector3 P = shape->SupportPoint(direction, &vertex);
+	class ASupportShape {
+	protected:
+		// radius of the rounding.
+		real mMargin;
+
+		// get the farthest point of the shape without margin.
+		// *param:
+		//     direction    - world space search direction. (not normalized)
+		//     inout_vertex - start and output vertex index. the shapes
+		//                    without vertices ignore it.
+		virtual const Vector3 CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const = 0;
+
+	public:
+		ASupportShape();
+
+		virtual ~ASupportShape();
+
+		// get margin. (0 by default)
+		real GetMargin() const;
+
+		// set margin.
+		void SetMargin(real margin);
+
+		// get the number of vertices which the support points are on.
+		// the curved shapes have no vertex.
+		virtual uinteger GetVertexCount() const = 0;
+
+		// get world space position of a vertex by the last update.
+		// the margin is not added.
+		virtual const Vector3 GetWorldPoint(uinteger index) const = 0;
+
+		// get the farthest point in given direction, with margin.
+		// *note: direction and returned point are in world space.
+		// *param:
+		//     direction    - search direction.
+		//     inout_vertex - start vertex index of the search, and output
+		//                    index of the found vertex. the last result of
+		//                    the same shape makes the search short.
+		const Vector3 SupportPoint(const Vector3& direction, uinteger* inout_vertex = NULL) const;
+	};
+
+}
+#endif
@@ -50,6 +50,13 @@ namespace sark {
 		return mAttribFeats[attribSemantic]->dataCount;
 	}
 
+	// get element type of specific attribute.
+	const ArrayBuffer::ElementType ArrayBuffer::GetElementType(AttributeSemantic attribSemantic) const {
+		if (mAttribFeats[attribSemantic] == NULL)
+			return ElementType::NONE;
+		return mAttribFeats[attribSemantic]->elementType;
+	}
+
 	
 	// bind this vertex buffer object.
 	void ArrayBuffer::BindAttribBuffers() const {
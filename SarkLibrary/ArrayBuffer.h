@@ -185,6 +185,10 @@ namespace sark {
 		// it'll return 0 if given attribute buffer is not exists.
 		const uinteger GetDataCount(AttributeSemantic attribSemantic) const;
 
+		// get element type of specific attribute.
+		// it'll return NONE if given attribute buffer is not exists.
+		const ElementType GetElementType(AttributeSemantic attribSemantic) const;
+
 
 		// generate attribute buffer with relative informations.
 		//
@@ -1,5 +1,7 @@
 #include "Camera.h"
+#ifndef SARKLIB_HEADLESS
 #include <GL/glew.h>
+#endif
 
 namespace sark{
 
@@ -100,6 +102,12 @@ namespace sark{
 		return mViewMatrix;
 	}
 
+	// get inverse of view transformation matrix.
+	// view matrix is always rigid, inv(R x T) = inv(T) x transp(R)
+	const Matrix4 Camera::GetInvViewMatrix() const {
+		return mViewMatrix.RigidInverse();
+	}
+
 	// get projection transformation matrix
 	const Matrix4& Camera::GetProjMatrix() const {
 		return mVolume.projMatrix;
@@ -135,12 +143,16 @@ namespace sark{
 	}
 	// set viewport again. it just calls graphic api with its properties
 	void Camera::SetViewport(){
+#ifndef SARKLIB_HEADLESS
 		glViewport(mViewport.x, mViewport.y, mViewport.width, mViewport.height);
 		glDepthRange(mViewport.minZ, mViewport.maxZ);
+#endif
 	}
 	// set viewport
 	void Camera::SetViewport(integer x, integer y, integer width, integer height){
+#ifndef SARKLIB_HEADLESS
 		glViewport(x, y, width, height);
+#endif
 
 		mViewport.x = (real)x;
 		mViewport.y = (real)y;
@@ -149,8 +161,10 @@ namespace sark{
 	}
 	// set viewport with depth range.
 	void Camera::SetViewport(integer x, integer y, integer width, integer height, real minz, real maxz){
+#ifndef SARKLIB_HEADLESS
 		glViewport(x, y, width, height);
 		glDepthRange(minz, maxz);
+#endif
 
 		mViewport.x = (real)x;
 		mViewport.y = (real)y;
@@ -252,14 +266,8 @@ namespace sark{
 		//   = inv(T) x inv(R) x C
 		//   = inv(T) x transp(R) x C.
 		// and inv(T) is translation into Eye
-		// but, CS_dir's w factor is zero. so,
-		const Vector3& u = GetBasisU();
-		const Vector3& v = GetBasisV();
-		const Vector3& n = GetBasisN();
-		Vector3 WS_dir( // world space ray direction
-			u.x*CS_dir.x + v.x*CS_dir.y + n.x*CS_dir.z,
-			u.y*CS_dir.x + v.y*CS_dir.y + n.y*CS_dir.z,
-			u.z*CS_dir.x + v.z*CS_dir.y + n.z*CS_dir.z);
+		// but, CS_dir's w factor is zero, so it is rotated only.
+		Vector3 WS_dir = (GetInvViewMatrix() * CS_dir).xyz; // world space ray direction
 
 		return Ray(
 			// ray starts from zn plane
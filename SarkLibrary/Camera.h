@@ -96,6 +96,10 @@ namespace sark{
 		// get view transformation matrix
 		const Matrix4& GetViewMatrix() const;
 
+		// get inverse of view transformation matrix.
+		// it transforms camera space into world space.
+		const Matrix4 GetInvViewMatrix() const;
+
 		// get projection transformation matrix
 		const Matrix4& GetProjMatrix() const;
 
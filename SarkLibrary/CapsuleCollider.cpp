@@ -0,0 +1,54 @@
+#include "CapsuleCollider.h"
+#include "ASceneComponent.h"
+
+namespace sark {
+
+	CapsuleCollider::CapsuleCollider(ASceneComponent* reference)
+		: ACollider(reference), pos(0), axis(Vector3::Up), h(0.5f), r(0.5f)
+	{}
+
+	CapsuleCollider::CapsuleCollider(ASceneComponent* reference,
+		const Vector3& position, real halfLength, real radius)
+		: ACollider(reference), pos(position), axis(Vector3::Up), h(halfLength), r(radius)
+	{}
+
+	const ACollider::Type CapsuleCollider::GetType() const {
+		return ACollider::CAPSULE;
+	}
+
+	void CapsuleCollider::Update() {
+		const Matrix4& TM = mReference->GetTransform().GetMatrix();
+		axis = Vector3(TM.m[0][1], TM.m[1][1], TM.m[2][1]).Normal();
+		pos = mReference->GetTransform().GetPosition();
+	}
+
+	// get world space bounding box.
+	void CapsuleCollider::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		const Vector3 A = pos + axis * h;
+		const Vector3 B = pos - axis * h;
+		for (uinteger i = 0; i < 3; i++) {
+			out_min.v[i] = math::min(A.v[i], B.v[i]) - (r + GetMargin());
+			out_max.v[i] = math::max(A.v[i], B.v[i]) + (r + GetMargin());
+		}
+	}
+
+	// capsule has no vertex.
+	uinteger CapsuleCollider::GetVertexCount() const {
+		return 0;
+	}
+
+	// get the center.
+	const Vector3 CapsuleCollider::GetWorldPoint(uinteger) const {
+		return pos;
+	}
+
+	// the point at the radius in the direction from the farther end.
+	const Vector3 CapsuleCollider::CoreSupportPoint(const Vector3& direction, uinteger*) const {
+		const Vector3 end = pos + axis * (direction.Dot(axis) >= 0 ? h : -h);
+		const real len = direction.Magnitude();
+		if (len == 0)
+			return end;
+		return end + direction * (r / len);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef __CAPSULE_COLLIDER_H__
+#define __CAPSULE_COLLIDER_H__
+
+#include "core.h"
+#include "ACollider.h"
+#include "ASupportShape.h"
+
+namespace sark {
+
+	// capsule.
+	// the points within the radius from a line segment.
+	// it is represented as center position of the segment,
+	// its direction and its half length.
+	class CapsuleCollider : public ACollider, public ASupportShape {
+	protected:
+		// the point at the radius in the direction from the farther end.
+		const Vector3 CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const override;
+
+	public:
+		// center position of the segment.
+		Vector3 pos;
+
+		// unit direction of the segment.
+		Vector3 axis;
+
+		// half length of the segment.
+		real h;
+
+		// radius
+		real r;
+
+		CapsuleCollider(ASceneComponent* reference);
+		CapsuleCollider(ASceneComponent* reference,
+			const Vector3& position, real halfLength, real radius);
+
+		// get type.
+		const Type GetType() const override;
+
+		// update capsule.
+		// the segment is along the local y axis of the reference.
+		void Update() override;
+
+		// get world space bounding box.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const override;
+
+		// capsule has no vertex.
+		uinteger GetVertexCount() const override;
+
+		// get the center.
+		const Vector3 GetWorldPoint(uinteger index) const override;
+	};
+
+}
+#endif
\ No newline at end of file
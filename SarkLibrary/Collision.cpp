@@ -1,252 +1,743 @@
+#include <algorithm>
 #include "Collision.h"
 #include "GJK_EPA.h"
 #include "ConvexHull.h"
+#include "SphereCollider.h"
+#include "AABoxCollider.h"
+#include "OBoxCollider.h"
+#include "CapsuleCollider.h"
 #include "RigidBody.h"
-#include "Mesh.h"
+#include "SweepAndPrune.h"
+#include "DynamicAABBTree.h"
+#include "CollisionGeometry.h"
 #include "tools.h"
 #include "Debug.h"
 
 namespace sark {
 
 	real Collision::C_RESTITUT = 0.3f;
+	real Collision::C_FRICTION = 0.5f;
+	Collision::PairCacheMap Collision::mPairCaches;
+	Collision::Broadphase Collision::mMeshBroadphase;
+	Collision::Broadphase Collision::mConvexBroadphase;
+	ThreadPool* Collision::mThreadPool = NULL;
+	uinteger Collision::mThreadCount = 0;
+	std::vector<Collision::ConvexContactArray> Collision::mContactBuffers;
+	Collision::ConvexContactArray Collision::mContacts;
+	std::vector<Collision::ConvexContactArray> Collision::mTriggerBuffers;
+	Collision::TriggerOverlapArray Collision::mTriggerOverlaps;
+	std::vector<Collision::PairCache> Collision::mFrameCaches;
+	UnionFind Collision::mIslands;
+	ContactSolver Collision::mSolver;
+	const real Collision::BULLET_MOTION_RATIO = 0.5f;
+	ABroadphase::PairArray Collision::mImpacts;
+	std::vector<ContactManifold> Collision::mImpactManifolds;
+
+	namespace {
+
+		// the motion of the component after the last update of its collider.
+		inline Vector3 GetMotion(ASceneComponent* component) {
+			const Matrix4 from = Collision::GetColliderMatrix(component->GetCollider());
+			const Matrix4& to = component->GetTransform().GetMatrix();
+			return Vector3(to.m[0][3] - from.m[0][3], to.m[1][3] - from.m[1][3], to.m[2][3] - from.m[2][3]);
+		}
 
-	// process the collisions.
-	void Collision::ProcessCollision(AScene::Layer& physLayer) {
-		// temporal contact informations
-		Vector3 CN; // contact normal
-		Vector3 CP; // contact point
+		// contact generation of a pair of collider types.
+		typedef bool(*ContactFunc)(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint* hint);
+
+		bool Sphere_SphereContact(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint*)
+		{
+			const SphereCollider* sphere1 = static_cast<const SphereCollider*>(coll1);
+			const SphereCollider* sphere2 = static_cast<const SphereCollider*>(coll2);
+			Vector3 CN, CP;
+			real depth;
+			if (!tool::Sphere_SphereContact(sphere1->pos, sphere1->r, sphere2->pos, sphere2->r, CN, CP, depth))
+				return false;
+			out_manifold.Build(CN, &CP, &depth, 1,
+				Collision::GetColliderMatrix(coll1), Collision::GetColliderMatrix(coll2));
+			return true;
+		}
 
-		AScene::Layer::ReplicaArrayIterator itr = physLayer.Begin();
-		AScene::Layer::ReplicaArrayIterator jtr;
-		AScene::Layer::ReplicaArrayIterator end = physLayer.End();
-		for (; itr != end; itr++) {
-			if ((*itr)->GetRigidBody() == NULL
-				|| (*itr)->GetMesh() == NULL)
-				continue;
+		bool Sphere_OBoxContact(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint*)
+		{
+			const SphereCollider* sphere = static_cast<const SphereCollider*>(coll1);
+			Vector3 ext, axis[3];
+			static_cast<const OBoxCollider*>(coll2)->GetOrthonormal(ext, axis);
+			Vector3 CN, CP;
+			real depth;
+			if (!tool::Sphere_OBoxContact(sphere->pos, sphere->r,
+				static_cast<const OBoxCollider*>(coll2)->pos, ext, axis, CN, CP, depth))
+				return false;
+			out_manifold.Build(CN, &CP, &depth, 1,
+				Collision::GetColliderMatrix(coll1), Collision::GetColliderMatrix(coll2));
+			return true;
+		}
 
-			ArrayBuffer& arrbuf1 = (*itr)->GetMesh()->GetArrayBuffer();
-			if (arrbuf1.GetDrawMode() != ArrayBuffer::DrawMode::TRIANGLES) {
-				LogWarn("it supports only for the triangle mesh");
-				continue;
+		bool OBox_OBoxContact(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint*)
+		{
+			const OBoxCollider* ob1 = static_cast<const OBoxCollider*>(coll1);
+			const OBoxCollider* ob2 = static_cast<const OBoxCollider*>(coll2);
+			Vector3 ext1, axis1[3], ext2, axis2[3];
+			ob1->GetOrthonormal(ext1, axis1);
+			ob2->GetOrthonormal(ext2, axis2);
+			Vector3 CN;
+			Vector3 points[tool::OBOX_CONTACT_MAX_POINTS];
+			real depths[tool::OBOX_CONTACT_MAX_POINTS];
+			const uinteger count = tool::OBox_OBoxContact(ob1->pos, ext1, axis1, ob2->pos, ext2, axis2,
+				ContactManifold::CONTACT_MARGIN, CN, points, depths);
+			if (count == 0)
+				return false;
+			out_manifold.Build(CN, points, depths, count,
+				Collision::GetColliderMatrix(coll1), Collision::GetColliderMatrix(coll2));
+			return true;
+		}
+
+		// the hulls clip their polygons.
+		bool Hull_HullContact(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint* hint)
+		{
+			const ConvexHull* convex1 = static_cast<const ConvexHull*>(coll1);
+			const ConvexHull* convex2 = static_cast<const ConvexHull*>(coll2);
+			Vector3 CN, CP;
+			real depth;
+			if (!Collision::ConvexLevelDetection(convex1, convex2, CN, CP, depth, hint))
+				return false;
+			out_manifold.Build(convex1, convex2, CN, CP, depth);
+			return true;
+		}
+
+		// the single point of GJK and EPA.
+		// the support point on a face is any of its corners, so the point
+		// is taken on the shape of the fewer vertices. (e.g. the bottom of
+		// a capsule, rather than a corner of the floor)
+		bool Support_SupportContact(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint* hint)
+		{
+			const ASupportShape* convex1 = ACollider::GetSupportShape(coll1);
+			const ASupportShape* convex2 = ACollider::GetSupportShape(coll2);
+			Vector3 CN, CP;
+			real depth;
+			if (!Collision::ConvexLevelDetection(convex1, convex2, CN, CP, depth, hint))
+				return false;
+			if (convex2->GetVertexCount() < convex1->GetVertexCount())
+				CP = convex2->SupportPoint(CN, (hint != NULL ? &hint->b : NULL)) - CN * depth;
+			out_manifold.Build(CN, &CP, &depth, 1,
+				Collision::GetColliderMatrix(coll1), Collision::GetColliderMatrix(coll2));
+			return true;
+		}
+
+		// the contact of the reversed pair.
+		template<ContactFunc _Func>
+		bool SwappedContact(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint* hint)
+		{
+			if (!_Func(coll2, coll1, out_manifold, hint))
+				return false;
+			out_manifold.Flip();
+			return true;
+		}
+
+		// contact generations by the types of the pair.
+		// the pairs without the specialized one fall back to GJK and EPA.
+		struct ContactTable {
+			ContactFunc funcs[ACollider::TYPE_COUNT][ACollider::TYPE_COUNT];
+
+			ContactTable() {
+				for (uinteger a = 0; a < ACollider::TYPE_COUNT; a++) {
+					for (uinteger b = 0; b < ACollider::TYPE_COUNT; b++)
+						funcs[a][b] = Support_SupportContact;
+				}
+				Set<Sphere_SphereContact>(ACollider::SPHERE, ACollider::SPHERE);
+				Set<Sphere_OBoxContact>(ACollider::SPHERE, ACollider::OBOX);
+				Set<OBox_OBoxContact>(ACollider::OBOX, ACollider::OBOX);
+				Set<Hull_HullContact>(ACollider::CONVEXHULL, ACollider::CONVEXHULL);
 			}
 
-			if (arrbuf1.GetDataCount(AttributeSemantic::INDICES) == 0) {
-				LogWarn("it does not support indexless mesh");
-				continue;
+			// set the contact of the pair, and of the reversed pair.
+			template<ContactFunc _Func>
+			void Set(ACollider::Type a, ACollider::Type b) {
+				funcs[a][b] = _Func;
+				if (a != b)
+					funcs[b][a] = SwappedContact<_Func>;
 			}
+		};
+
+		const ContactTable CONTACT_TABLE;
+
+		// expand the bounding box by the motion.
+		inline void SweepBounds(const Vector3& motion, Vector3& inout_min, Vector3& inout_max) {
+			for (uinteger a = 0; a < 3; a++) {
+				if (motion.v[a] < 0)
+					inout_min.v[a] += motion.v[a];
+				else
+					inout_max.v[a] += motion.v[a];
+			}
+		}
+
+	}
+
+	Collision::Broadphase::Broadphase()
+		: detector(new SweepAndPrune()), frame(0) {}
+
+	Collision::Broadphase::~Broadphase() {
+		delete detector;
+	}
+
+	// replace the detector. the proxies are made again on next frame.
+	void Collision::Broadphase::Reset(BroadphaseType type) {
+		delete detector;
+		if (type == AABB_TREE)
+			detector = new DynamicAABBTree();
+		else
+			detector = new SweepAndPrune();
+		proxies.clear();
+		pairs.clear();
+	}
+
+	// select the algorithm of the broad-phase.
+	void Collision::SetBroadphaseType(BroadphaseType type) {
+		mMeshBroadphase.Reset(type);
+		mConvexBroadphase.Reset(type);
+	}
 
-			PositionAccessor positions1
-				= arrbuf1.GetAttributeAccessor<Position3>(AttributeSemantic::POSITION);
-			if (positions1.Empty())
+	// set the number of threads for narrow-phase of convex pairs.
+	// the pool is made again on the next frame.
+	void Collision::SetThreadCount(uinteger count) {
+		mThreadCount = count;
+		if (mThreadPool != NULL) {
+			delete mThreadPool;
+			mThreadPool = NULL;
+		}
+	}
+
+	// update the proxies and find the overlapping pairs.
+	const ABroadphase::PairArray& Collision::FindPairs(Broadphase& bp) {
+		bp.frame++;
+
+		Vector3 min, max;
+		const uinteger count = bp.components.size();
+		for (uinteger i = 0; i < count; i++) {
+			ACollider* coll = bp.components[i]->GetCollider();
+			const CollisionGeometry* geometry = NULL;
+			if (coll != NULL) {
+				coll->GetBounds(min, max);
+			}
+			else if ((geometry = bp.components[i]->GetCollisionGeometry()) != NULL) {
+				Vector3 localMin, localMax;
+				geometry->GetBounds(localMin, localMax);
+				tool::TransformAABox(bp.components[i]->GetTransform().GetMatrix(), localMin, localMax, min, max);
+			}
+			else {
+				min = -REAL_MAX;
+				max = REAL_MAX;
+			}
+
+			Broadphase::ProxyEntry entry;
+			entry.id = ABroadphase::INVALID_PROXY;
+			entry.frame = bp.frame;
+			auto res = bp.proxies.insert(std::make_pair(bp.components[i], entry));
+			if (res.second) {
+				res.first->second.id = bp.detector->AddProxy(min, max, i);
+			}
+			else {
+				bp.detector->UpdateProxy(res.first->second.id, min, max);
+				bp.detector->SetUserData(res.first->second.id, i);
+				res.first->second.frame = bp.frame;
+			}
+		}
+
+		// remove the proxies of the components which left the layer.
+		if (bp.proxies.size() > count) {
+			for (auto itr = bp.proxies.begin(); itr != bp.proxies.end();) {
+				if (itr->second.frame != bp.frame) {
+					bp.detector->RemoveProxy(itr->second.id);
+					itr = bp.proxies.erase(itr);
+				}
+				else {
+					itr++;
+				}
+			}
+		}
+
+		bp.pairs = bp.detector->FindPairs();
+		bp.pairs.erase(std::remove_if(bp.pairs.begin(), bp.pairs.end(),
+			[&bp](const ABroadphase::Pair& pair) {
+			return !FilterPair(bp.components[pair.a], bp.components[pair.b]);
+		}), bp.pairs.end());
+		std::sort(bp.pairs.begin(), bp.pairs.end(),
+			[](const ABroadphase::Pair& l, const ABroadphase::Pair& r) {
+			return (l.a < r.a || (l.a == r.a && l.b < r.b));
+		});
+		return bp.pairs;
+	}
+
+	// whether the pair is tested.
+	bool Collision::FilterPair(ASceneComponent* comp1, ASceneComponent* comp2) {
+		RigidBody* body1 = comp1->GetRigidBody();
+		RigidBody* body2 = comp2->GetRigidBody();
+		if (body1 != NULL && body2 != NULL && body1->IsFixed() && body2->IsFixed())
+			return false;
+
+		const ACollider* coll1 = comp1->GetCollider();
+		const ACollider* coll2 = comp2->GetCollider();
+		if (coll1 != NULL && coll2 != NULL && !ACollider::CanCollide(coll1, coll2))
+			return false;
+		return true;
+	}
+
+	// set the overlaps of the trigger pairs of the pass on this process.
+	void Collision::SetTriggerOverlaps(Broadphase& bp, const std::vector<ComponentPair>& overlaps) {
+		std::set<ComponentPair> pairs;
+		bp.triggerOverlaps.resize(overlaps.size());
+		for (uinteger i = 0; i < overlaps.size(); i++) {
+			TriggerOverlap& overlap = bp.triggerOverlaps[i];
+			overlap.comp1 = const_cast<ASceneComponent*>(overlaps[i].first);
+			overlap.comp2 = const_cast<ASceneComponent*>(overlaps[i].second);
+			overlap.begin = (bp.triggerPairs.find(overlaps[i]) == bp.triggerPairs.end());
+			pairs.insert(overlaps[i]);
+		}
+		bp.triggerPairs.swap(pairs);
+
+		mTriggerOverlaps = mMeshBroadphase.triggerOverlaps;
+		mTriggerOverlaps.insert(mTriggerOverlaps.end(),
+			mConvexBroadphase.triggerOverlaps.begin(), mConvexBroadphase.triggerOverlaps.end());
+	}
+
+	// get the overlaps of the trigger colliders on the last process.
+	const Collision::TriggerOverlapArray& Collision::GetTriggerOverlaps() {
+		return mTriggerOverlaps;
+	}
+
+	// set the number of velocity iterations of the contact solver.
+	void Collision::SetSolverIterations(uinteger iterations) {
+		mSolver.SetIterations(iterations);
+	}
+
+	// join the components of the contacts into the islands, and wake up
+	// the islands which have an awake body.
+	void Collision::WakeIslands(const std::vector<ASceneComponent*>& components,
+		const ABroadphase::PairArray& contacts)
+	{
+		const uinteger count = components.size();
+		mIslands.Reset(count);
+		for (auto& contact : contacts) {
+			if (components[contact.a]->GetRigidBody()->IsFixed()
+				|| components[contact.b]->GetRigidBody()->IsFixed())
 				continue;
+			mIslands.Union(contact.a, contact.b);
+		}
 
-			IndexAccessor indices1
-				= arrbuf1.GetAttributeAccessor<TriangleFace16>(AttributeSemantic::INDICES);
-			if (indices1.Empty())
+		std::vector<bool> awake(count, false);
+		for (uinteger i = 0; i < count; i++) {
+			if (components[i]->GetRigidBody()->IsActive())
+				awake[mIslands.Find(i)] = true;
+		}
+		for (uinteger i = 0; i < count; i++) {
+			RigidBody* body = components[i]->GetRigidBody();
+			if (!body->IsFixed() && !body->IsAwake() && awake[mIslands.Find(i)])
+				body->SetAwake(true);
+		}
+	}
+
+	// count the still time of the bodies, and put the still islands to sleep.
+	void Collision::SleepIslands(const std::vector<ASceneComponent*>& components) {
+		const uinteger count = components.size();
+		std::vector<real> sleepTimes(count, REAL_MAX);
+		for (uinteger i = 0; i < count; i++) {
+			RigidBody* body = components[i]->GetRigidBody();
+			if (body->IsFixed())
 				continue;
+			body->UpdateSleepTime();
+			const uinteger island = mIslands.Find(i);
+			sleepTimes[island] = math::min(sleepTimes[island], body->GetSleepTime());
+		}
+		for (uinteger i = 0; i < count; i++) {
+			RigidBody* body = components[i]->GetRigidBody();
+			if (body->IsActive() && sleepTimes[mIslands.Find(i)] >= RigidBody::SLEEP_TIME)
+				body->SetAwake(false);
+		}
+	}
 
-			auto coll1 = (*itr)->GetCollider();
+	// sweep the motions of the bullets, and stop them at the first impacts.
+	void Collision::SweepBullets(const std::vector<ASceneComponent*>& components) {
+		mImpacts.clear();
+		mImpactManifolds.clear();
 
-			// compare component 1 and component 2.
-			jtr = itr;
-			jtr++;
-			for (; jtr != end; jtr++) {
-				if ((*jtr)->GetRigidBody() == NULL
-					|| (*jtr)->GetMesh() == NULL)
-					continue;
+		const uinteger count = components.size();
+		for (uinteger i = 0; i < count; i++) {
+			ASceneComponent* comp1 = components[i];
+			if (!comp1->GetRigidBody()->IsBullet() || !comp1->GetRigidBody()->IsActive()
+				|| comp1->GetCollider()->IsTrigger())
+				continue;
 
-				ArrayBuffer& arrbuf2 = (*jtr)->GetMesh()->GetArrayBuffer();
-				if (arrbuf2.GetDrawMode() != ArrayBuffer::DrawMode::TRIANGLES) {
-					LogWarn("it supports only for the triangle mesh");
+			Vector3 min1, max1;
+			comp1->GetCollider()->GetBounds(min1, max1);
+			const Vector3 motion1 = GetMotion(comp1);
+			const Vector3 size = max1 - min1;
+			const real minMotion = math::min(size.x, math::min(size.y, size.z)) * BULLET_MOTION_RATIO;
+			if (motion1.MagnitudeSq() <= minMotion * minMotion)
+				continue;
+			SweepBounds(motion1, min1, max1);
+
+			// the first impact among the others. it is linear scan, since
+			// the bullets are a few.
+			const ASupportShape* convex1 = ACollider::GetSupportShape(comp1->GetCollider());
+			integer first = -1;
+			real firstTOI = 1;
+			Vector3 firstNormal, firstPoint;
+			Vector3 min2, max2, normal, point;
+			real toi;
+			for (uinteger j = 0; j < count; j++) {
+				if (j == i)
 					continue;
-				}
-
-				if (arrbuf2.GetDataCount(AttributeSemantic::INDICES) == 0) {
-					LogWarn("it does not support indexless mesh");
+				ASceneComponent* comp2 = components[j];
+				if (comp2->GetCollider()->IsTrigger() || !FilterPair(comp1, comp2))
+					continue;
+				comp2->GetCollider()->GetBounds(min2, max2);
+				const Vector3 motion2 = GetMotion(comp2);
+				SweepBounds(motion2, min2, max2);
+				if (min1.x > max2.x || max1.x < min2.x
+					|| min1.y > max2.y || max1.y < min2.y
+					|| min1.z > max2.z || max1.z < min2.z)
 					continue;
-				}
 
-				// broad phase.
-				if (coll1 != NULL) {
-					auto coll2 = (*jtr)->GetCollider();
-					if (coll2 != NULL) {
-						if (coll1->IntersectWith(coll2) == false)
-							continue;
-					}
+				const ASupportShape* convex2 = ACollider::GetSupportShape(comp2->GetCollider());
+				if (GJK_EPA::DoLinearCast(convex1, convex2, motion1 - motion2, &toi, &normal, &point)
+					&& toi < firstTOI)
+				{
+					first = (integer)j;
+					firstTOI = toi;
+					firstNormal = normal;
+					firstPoint = point + motion2 * toi;
 				}
+			}
+			if (first < 0)
+				continue;
 
-				// narrow phase.
-				PositionAccessor positions2
-					= arrbuf2.GetAttributeAccessor<Position3>(AttributeSemantic::POSITION);
-				if (positions2.Empty())
-					continue;
+			// the rest of the motion is lost, and the impact is solved
+			// with the other contacts.
+			comp1->GetTransform().TranslateMore(-motion1 * (1 - firstTOI));
+
+			ABroadphase::Pair impact;
+			impact.a = i;
+			impact.b = (uinteger)first;
+			mImpacts.push_back(impact);
+			mImpactManifolds.push_back(ContactManifold());
+			mImpactManifolds.back().SetNormal(firstNormal);
+			mImpactManifolds.back().AddPoint(firstPoint, 0);
+		}
+	}
 
-				IndexAccessor indices2
-					= arrbuf2.GetAttributeAccessor<TriangleFace16>(AttributeSemantic::INDICES);
-				if (indices2.Empty())
-					continue;
+	// process the collisions.
+	void Collision::ProcessCollision(AScene::Layer& physLayer) {
+		ContactManifold manifold;
+		ABroadphase::PairArray contacts;
+		std::vector<ContactManifold> manifolds;
+		std::vector<ComponentPair> overlaps;
 
-				CN = 0.f;
-				CP = 0.f;
+		std::vector<ASceneComponent*>& components = mMeshBroadphase.components;
+		components.clear();
 
-				if (MeshLevelDetection(positions1, indices1, (*itr)->GetTransform().GetMatrix(),
-					positions2, indices2, (*jtr)->GetTransform().GetMatrix(), CN, CP))
-				{
-					Resolve((*itr)->GetRigidBody(), (*jtr)->GetRigidBody(), CN, CP, 0);
+		AScene::Layer::ReplicaArrayIterator itr = physLayer.Begin();
+		AScene::Layer::ReplicaArrayIterator end = physLayer.End();
+		for (; itr != end; itr++) {
+			if ((*itr)->GetRigidBody() == NULL)
+				continue;
+
+			// the geometry is in system memory, it is built from the
+			// mesh only once if the model does not have it.
+			if ((*itr)->GetCollisionGeometry() == NULL) {
+				ONLYDBG_CODEBLOCK(
+				if ((*itr)->GetMesh() != NULL)
+					LogWarn("it supports only for the indexed triangle mesh");
+				);
+				continue;
+			}
+			components.push_back(*itr);
+		}
+
+		const ABroadphase::PairArray& pairs = FindPairs(mMeshBroadphase);
+		for (auto& pair : pairs) {
+			ASceneComponent* comp1 = components[pair.a];
+			ASceneComponent* comp2 = components[pair.b];
+
+			// broad phase.
+			auto coll1 = comp1->GetCollider();
+			if (coll1 != NULL) {
+				auto coll2 = comp2->GetCollider();
+				if (coll2 != NULL) {
+					if (coll1->IntersectWith(coll2) == false)
+						continue;
+
+					// the trigger pairs only report the overlaps.
+					if (coll1->IsTrigger() || coll2->IsTrigger()) {
+						overlaps.push_back(ComponentPair(comp1, comp2));
+						continue;
+					}
 				}
 			}
+
+			// the pairs of sleeping (or fixed) bodies are not tested, but
+			// they still join the islands, since their colliders overlap.
+			if (!comp1->GetRigidBody()->IsActive() && !comp2->GetRigidBody()->IsActive()) {
+				contacts.push_back(pair);
+				manifolds.push_back(ContactManifold());
+				continue;
+			}
+
+			// narrow phase.
+			if (MeshLevelDetection(comp1->GetCollisionGeometry()->GetTriangleBVH(), comp1->GetTransform().GetMatrix(),
+				comp2->GetCollisionGeometry()->GetTriangleBVH(), comp2->GetTransform().GetMatrix(), manifold))
+			{
+				contacts.push_back(pair);
+				manifolds.push_back(manifold);
+			}
+		}
+
+		WakeIslands(components, contacts);
+		mSolver.Clear();
+		for (uinteger c = 0; c < contacts.size(); c++) {
+			ASceneComponent* comp1 = components[contacts[c].a];
+			ASceneComponent* comp2 = components[contacts[c].b];
+			if (comp1->GetRigidBody()->IsActive() || comp2->GetRigidBody()->IsActive())
+				mSolver.AddManifold(comp1, comp2, manifolds[c]);
 		}
+		mSolver.Solve(C_RESTITUT, C_FRICTION);
+		SleepIslands(components);
+		SetTriggerOverlaps(mMeshBroadphase, overlaps);
 	}
 
 	// process the collisions about convexity objects.
 	void Collision::ProcessConvexCollision(AScene::Layer& physLayer) {
-		// temporal contact informations
-		Vector3 CN; // contact normal
-		Vector3 CP; // contact point
-		real depth; // contact depth
+		std::vector<ASceneComponent*>& components = mConvexBroadphase.components;
+		components.clear();
 
 		AScene::Layer::ReplicaArrayIterator itr = physLayer.Begin();
-		AScene::Layer::ReplicaArrayIterator jtr;
 		AScene::Layer::ReplicaArrayIterator end = physLayer.End();
 		for (; itr != end; itr++) {
 			if ((*itr)->GetRigidBody() == NULL
-				|| (*itr)->GetCollider() == NULL
-				|| (*itr)->GetCollider()->GetType() != ACollider::CONVEXHULL)
+				|| (*itr)->GetCollider() == NULL)
 				continue;
+			components.push_back(*itr);
+		}
 
-			auto convex1 = reinterpret_cast<ConvexHull*>((*itr)->GetCollider());
-
-			// compare component 1 and component 2.
-			jtr = itr;
-			jtr++;
-			for (; jtr != end; jtr++) {
-				if ((*jtr)->GetRigidBody() == NULL
-					|| (*jtr)->GetCollider() == NULL
-					|| (*jtr)->GetCollider()->GetType() != ACollider::CONVEXHULL)
+		const ABroadphase::PairArray& pairs = FindPairs(mConvexBroadphase);
+		if (mThreadPool == NULL)
+			mThreadPool = new ThreadPool(mThreadCount);
+		mContactBuffers.resize(mThreadPool->GetThreadCount());
+		for (auto& buffer : mContactBuffers)
+			buffer.clear();
+		mTriggerBuffers.resize(mThreadPool->GetThreadCount());
+		for (auto& buffer : mTriggerBuffers)
+			buffer.clear();
+		mFrameCaches.assign(pairs.size(), PairCache());
+
+		// narrow-phase. the pairs are independent each other, since the
+		// colliders are tested by the last update.
+		mThreadPool->ParallelFor(pairs.size(), NARROWPHASE_GRAIN,
+			[&](uinteger begin, uinteger end, uinteger worker) {
+			ConvexContactArray& buffer = mContactBuffers[worker];
+			ConvexContactArray& triggerBuffer = mTriggerBuffers[worker];
+			ConvexContact contact;
+			ContactManifold manifold;
+			for (uinteger i = begin; i < end; i++) {
+				ASceneComponent* comp1 = components[pairs[i].a];
+				ASceneComponent* comp2 = components[pairs[i].b];
+				const ACollider* coll1 = comp1->GetCollider();
+				const ACollider* coll2 = comp2->GetCollider();
+
+				PairCache& cache = mFrameCaches[i];
+				PairCacheMap::const_iterator last = mPairCaches.find(ConvexPair(coll1, coll2));
+				if (last != mPairCaches.end())
+					cache = last->second;
+
+				contact.comp1 = comp1;
+				contact.comp2 = comp2;
+				contact.pair = i;
+
+				// the trigger pairs only report the overlaps, even if
+				// the bodies are sleeping.
+				if (coll1->IsTrigger() || coll2->IsTrigger()) {
+					if (coll1->IntersectWith(coll2))
+						triggerBuffer.push_back(contact);
 					continue;
+				}
 
-				auto convex2 = reinterpret_cast<ConvexHull*>((*jtr)->GetCollider());
-
-				if (ConvexLevelDetection(convex1, convex2, CN, CP, depth)) {
-					// *note: at this time, i just translate depth toward contact normal.
-					// but it should be modified as correction impulse based method.
-					if (!(*itr)->GetRigidBody()->IsFixed())
-						(*itr)->GetTransform().TranslateMore(CN*depth);
+				// the pairs of sleeping (or fixed) bodies are not tested.
+				// they keep the last manifold, and join the islands by it.
+				if (!comp1->GetRigidBody()->IsActive() && !comp2->GetRigidBody()->IsActive()) {
+					if (cache.manifold.GetPointCount() > 0)
+						buffer.push_back(contact);
+					continue;
+				}
 
-					Resolve((*itr)->GetRigidBody(), (*jtr)->GetRigidBody(), CN, CP, depth);
+				if (ContactLevelDetection(coll1, coll2, manifold, &cache.hint)) {
+					manifold.Merge(cache.manifold, GetColliderMatrix(coll1));
+					cache.manifold = manifold;
+					buffer.push_back(contact);
+				}
+				else {
+					cache.manifold.Clear();
 				}
 			}
+		});
+
+		// merge the contacts, and sort them by the component ids
+		// to resolve them in the same order at any thread count.
+		const auto byComponentIDs = [](const ConvexContact& l, const ConvexContact& r) {
+			const ASceneComponent::ComponentID l1 = l.comp1->GetComponentID();
+			const ASceneComponent::ComponentID r1 = r.comp1->GetComponentID();
+			return (l1 < r1 || (l1 == r1 && l.comp2->GetComponentID() < r.comp2->GetComponentID()));
+		};
+		mContacts.clear();
+		for (auto& buffer : mContactBuffers)
+			mContacts.insert(mContacts.end(), buffer.begin(), buffer.end());
+		std::sort(mContacts.begin(), mContacts.end(), byComponentIDs);
+
+		ConvexContactArray triggers;
+		for (auto& buffer : mTriggerBuffers)
+			triggers.insert(triggers.end(), buffer.begin(), buffer.end());
+		std::sort(triggers.begin(), triggers.end(), byComponentIDs);
+		std::vector<ComponentPair> overlaps(triggers.size());
+		for (uinteger i = 0; i < triggers.size(); i++)
+			overlaps[i] = ComponentPair(triggers[i].comp1, triggers[i].comp2);
+		SetTriggerOverlaps(mConvexBroadphase, overlaps);
+
+		SweepBullets(components);
+
+		// wake up the islands touched by the awake bodies before resolving.
+		ABroadphase::PairArray touching(mContacts.size());
+		for (uinteger i = 0; i < mContacts.size(); i++)
+			touching[i] = pairs[mContacts[i].pair];
+		touching.insert(touching.end(), mImpacts.begin(), mImpacts.end());
+		WakeIslands(components, touching);
+
+		// the contacts of the sleeping islands are not solved.
+		mSolver.Clear();
+		for (auto& contact : mContacts) {
+			if (contact.comp1->GetRigidBody()->IsActive() || contact.comp2->GetRigidBody()->IsActive())
+				mSolver.AddManifold(contact.comp1, contact.comp2, mFrameCaches[contact.pair].manifold);
 		}
+		for (uinteger i = 0; i < mImpacts.size(); i++)
+			mSolver.AddManifold(components[mImpacts[i].a], components[mImpacts[i].b], mImpactManifolds[i]);
+		mSolver.Solve(C_RESTITUT, C_FRICTION);
+		SleepIslands(components);
+
+		// caches of this frame. the pairs which the broad-phase
+		// does not report on this frame are dropped.
+		PairCacheMap caches;
+		for (uinteger i = 0; i < pairs.size(); i++) {
+			const ConvexPair pair(components[pairs[i].a]->GetCollider(), components[pairs[i].b]->GetCollider());
+			caches[pair] = mFrameCaches[i];
+		}
+		mPairCaches.swap(caches);
 	}
 
 
-	bool Collision::MeshLevelDetection(const PositionAccessor& positions1, const IndexAccessor& indices1, const Matrix4& TM1,
-		const PositionAccessor& positions2, const IndexAccessor& indices2, const Matrix4& TM2,
-		Vector3& out_CN, Vector3& out_CP)
+	// triangle-mesh level detection.
+	// the hierarchies are traversed together, and only the triangles of
+	// the overlapping leaves are tested and transformed.
+	bool Collision::MeshLevelDetection(const TriangleBVH& bvh1, const Matrix4& TM1,
+		const TriangleBVH& bvh2, const Matrix4& TM2,
+		ContactManifold& out_manifold)
 	{
-		uinteger count_1 = indices1.Count();
-		uinteger count_2 = indices2.Count();
 		Vector3 P, Q, n;
-		uinteger contactCount = 0;
-
-		Position3 transA2, transB2, transC2;
+		Vector3 CN(0.f);
+		std::vector<Vector3> points;
 
 		// triangle mesh - triangle mesh intersection test
-		for (uinteger i = 0; i < count_1; i++) {
-			const Position3& A1 = positions1[indices1[i].a];
-			const Position3& B1 = positions1[indices1[i].b];
-			const Position3& C1 = positions1[indices1[i].c];
-
-			for (uinteger j = 0; j < count_2; j++) {
-				const Position3& A2 = positions2[indices2[j].a];
-				const Position3& B2 = positions2[indices2[j].b];
-				const Position3& C2 = positions2[indices2[j].c];
-
-				transA2 = (TM2 * Vector4(A2, 1.f)).xyz;
-				transB2 = (TM2 * Vector4(B2, 1.f)).xyz;
-				transC2 = (TM2 * Vector4(C2, 1.f)).xyz;
-
-				if (tool::Triangle_TriangleIntersection(
-					(TM1 * Vector4(A1, 1.f)).xyz,
-					(TM1 * Vector4(B1, 1.f)).xyz,
-					(TM1 * Vector4(C1, 1.f)).xyz,
-					transA2, transB2, transC2,
-					&P, &Q, &n) == true)
-				{
-					out_CN += n;
-					out_CP += (P + Q) / 2.f;
-					contactCount++;
-				}
+		Position3 A1, B1, C1, A2, B2, C2;
+		bvh1.FindOverlaps(TM1, bvh2, TM2, [&](uinteger tri1, uinteger tri2) {
+			bvh1.GetWorldTriangle(tri1, TM1, A1, B1, C1);
+			bvh2.GetWorldTriangle(tri2, TM2, A2, B2, C2);
+			if (tool::Triangle_TriangleIntersection(
+				A1, B1, C1, A2, B2, C2,
+				&P, &Q, &n) == true)
+			{
+				CN += n;
+				points.push_back((P + Q) / 2.f);
 			}
-		}
+		});
 
-		if (contactCount == 0)
+		if (points.empty())
 			return false;
 
-		out_CN /= (real)contactCount;
-		out_CN.Normalize();
-		out_CP /= (real)contactCount;
+		CN.Normalize();
+		std::vector<real> depths(points.size(), 0.f);
+		uinteger indices[ContactManifold::MAX_POINTS];
+		const uinteger count = ContactManifold::ReducePoints(&points[0], &depths[0], points.size(), CN, indices);
+
+		out_manifold.Clear();
+		out_manifold.SetNormal(CN);
+		for (uinteger i = 0; i < count; i++)
+			out_manifold.AddPoint(points[indices[i]], 0);
 		return true;
 	}
 
 	// convex level detection.
-	bool Collision::ConvexLevelDetection(const ConvexHull* convex1, const ConvexHull* convex2,
-		Vector3& out_CN, Vector3& out_CP, real& out_depth)
+	bool Collision::ConvexLevelDetection(const ASupportShape* convex1, const ASupportShape* convex2,
+		Vector3& out_CN, Vector3& out_CP, real& out_depth,
+		GJK_EPA::SupportHint* hint)
 	{
 		GJK_EPA::Simplex simplex;
-		if (!GJK_EPA::DoGJK(convex1, convex2, &simplex))
+		if (!GJK_EPA::DoGJK(convex1, convex2, &simplex, hint))
 			return false;
 
-		if (!GJK_EPA::DoEPA(convex1, convex2, simplex, &out_CN, &out_depth))
+		if (!GJK_EPA::DoEPA(convex1, convex2, simplex, &out_CN, &out_depth, hint))
 			return false;
 
-		out_CP = tool::FarthestPointInDirection(convex1->GetTransPointSet(), out_CN);
+		out_CP = convex1->SupportPoint(out_CN, (hint != NULL ? &hint->a : NULL));
 		out_CN = -out_CN;
 		return true;
 	}
 
-	void Collision::Resolve(RigidBody* rigidBody1, RigidBody* rigidBody2,
-		const Vector3& CN, const Vector3& CP, const real depth)
+	// contact level detection.
+	bool Collision::ContactLevelDetection(const ACollider* coll1, const ACollider* coll2,
+		ContactManifold& out_manifold, GJK_EPA::SupportHint* hint)
 	{
-		const Vector3& v1 = rigidBody1->GetVelocity();
-		const Vector3& w1 = rigidBody1->GetAngularVelocity();
-
-		const Vector3& v2 = rigidBody2->GetVelocity();
-		const Vector3& w2 = rigidBody2->GetAngularVelocity();
-
-		Vector3 r1 = CP - rigidBody1->GetCM();
-		Vector3 r2 = CP - rigidBody2->GetCM();
+		if (ACollider::HasMargin(coll1, coll2))
+			return Support_SupportContact(coll1, coll2, out_manifold, hint);
+		return CONTACT_TABLE.funcs[coll1->GetType()][coll2->GetType()](coll1, coll2, out_manifold, hint);
+	}
 
-		// s(t); velocity of point s(t)
-		// c = n.Dot(s1 - s2)
-		// s(t) = v(t) + w(t)xr(t)
-		real c = CN.Dot((v1 + w1.Cross(r1)) - (v2 + w2.Cross(r2)));
-		if (c > 0)
-			return;
-		else if (c == 0) {
-			// resting state
-			return;
+	// get world matrix of the collider by the last update.
+	const Matrix4 Collision::GetColliderMatrix(const ACollider* coll) {
+		Matrix4 M(1.f);
+		switch (coll->GetType()) {
+		case ACollider::SPHERE: {
+				const SphereCollider* sphere = static_cast<const SphereCollider*>(coll);
+				M.m[0][3] = sphere->pos.x; M.m[1][3] = sphere->pos.y; M.m[2][3] = sphere->pos.z;
+			}
+			break;
+		case ACollider::AABOX: {
+				const AABoxCollider* aab = static_cast<const AABoxCollider*>(coll);
+				const Vector3 center = (aab->min + aab->max) / 2.f;
+				M.m[0][3] = center.x; M.m[1][3] = center.y; M.m[2][3] = center.z;
+			}
+			break;
+		case ACollider::OBOX: {
+				const OBoxCollider* ob = static_cast<const OBoxCollider*>(coll);
+				for (uinteger i = 0; i < 3; i++) {
+					M.m[0][i] = ob->axis[i].x; M.m[1][i] = ob->axis[i].y; M.m[2][i] = ob->axis[i].z;
+				}
+				M.m[0][3] = ob->pos.x; M.m[1][3] = ob->pos.y; M.m[2][3] = ob->pos.z;
+			}
+			break;
+		case ACollider::CONVEXHULL:
+			return static_cast<const ConvexHull*>(coll)->GetWorldMatrix();
+		case ACollider::CAPSULE: {
+				const CapsuleCollider* capsule = static_cast<const CapsuleCollider*>(coll);
+				M.m[0][3] = capsule->pos.x; M.m[1][3] = capsule->pos.y; M.m[2][3] = capsule->pos.z;
+			}
+			break;
+		case ACollider::TYPE_COUNT:
+			break;
 		}
-		// else, it needs to be resolved.
-
-		const real& invM1 = rigidBody1->GetInvMass();
-		const real& invM2 = rigidBody2->GetInvMass();
-		Matrix3 invI1 = rigidBody1->GetInvInertiaTensor();
-		Matrix3 invI2 = rigidBody2->GetInvInertiaTensor();
-
-		real j = -(1 + C_RESTITUT)*c 
-			/ (CN.Dot((invI1 * r1.Cross(CN)).Cross(r1)) + CN.Dot((invI2*r2.Cross(CN)).Cross(r2)) + invM1 + invM2);
-		j = math::max(j, 0);
-
-		Vector3 J = j*CN;
-
-		//v'(t) = v(t) + J/M
-		rigidBody1->SetVelocity(v1 + J*invM1);
-		rigidBody2->SetVelocity(v2 + -J*invM2);
-
-		//'(t) = (t) + invI*(r(t)xJ)
-		rigidBody1->SetAngularVelocity(w1 + invI1 * (r1.Cross(J)));
-		rigidBody2->SetAngularVelocity(w2 + invI2 * (r2.Cross(-J)));
+		return M;
 	}
 
 }
\ No newline at end of file
@@ -1,51 +1,270 @@
 #ifndef __COLLISION_H__
 #define __COLLISION_H__
 
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
 #include "core.h"
-#include "ArrayBuffer.h"
 #include "AScene.h"
+#include "GJK_EPA.h"
+#include "ContactManifold.h"
+#include "ContactSolver.h"
+#include "ABroadphase.h"
+#include "ThreadPool.h"
+#include "UnionFind.hpp"
 
 namespace sark {
 
-	class ConvexHull;
+	class ACollider;
+	class ASupportShape;
+	class TriangleBVH;
 
 	// collision detector and resolver in here.
 	// at present, it supports only for the indexed triangle mesh
 	// and it does not resolve the 'resting state'.
+	// the bodies joined by the contacts are the simulation islands, and
+	// an island goes to sleep when all of its bodies have been still for
+	// a while. (see RigidBody::SLEEP_TIME) the pairs of the sleeping
+	// bodies are not tested, and a contact with an awake body or
+	// a force wakes up the whole island.
 	class Collision {
 	public:
 		// coefficient of restitution.
 		// it'll be deprecated soon.
 		static real C_RESTITUT;
 
+		// coefficient of friction.
+		static real C_FRICTION;
+
+		// algorithm of the broad-phase.
+		enum BroadphaseType { SWEEP_AND_PRUNE, AABB_TREE };
+
+		// overlap of a trigger collider and another collider.
+		// 'begin' is true if they did not overlap on the last process.
+		struct TriggerOverlap {
+			ASceneComponent* comp1;
+			ASceneComponent* comp2;
+			bool begin;
+		};
+		typedef std::vector<TriggerOverlap> TriggerOverlapArray;
+
+	private:
+		typedef std::pair<const ACollider*, const ACollider*> ConvexPair;
+
+		// temporal coherence data of a convex pair.
+		struct PairCache {
+			// support vertices, separating axis and terminating simplex
+			// of GJK. (see GJK_EPA::SupportHint)
+			GJK_EPA::SupportHint hint;
+
+			// contact points, which are matched with the next ones.
+			ContactManifold manifold;
+		};
+		typedef std::map<ConvexPair, PairCache> PairCacheMap;
+
+		// caches of the convex pairs on the last frame.
+		// the pairs which the broad-phase does not report are evicted.
+		static PairCacheMap mPairCaches;
+
+		// contact of a convex pair, found on narrow-phase.
+		// its manifold is in the cache of the pair on this frame.
+		struct ConvexContact {
+			ASceneComponent* comp1;
+			ASceneComponent* comp2;
+			uinteger pair;
+		};
+		typedef std::vector<ConvexContact> ConvexContactArray;
+
+		// workers of narrow-phase. it is made on the first use.
+		static ThreadPool* mThreadPool;
+		static uinteger mThreadCount;
+
+		// contacts found by each worker, and the merged ones.
+		static std::vector<ConvexContactArray> mContactBuffers;
+		static ConvexContactArray mContacts;
+
+		// overlaps of the trigger pairs found by each worker.
+		static std::vector<ConvexContactArray> mTriggerBuffers;
+
+		// overlaps of the trigger pairs on the last process of both the
+		// mesh and the convex pass. (see GetTriggerOverlaps)
+		typedef std::pair<const ASceneComponent*, const ASceneComponent*> ComponentPair;
+		static TriggerOverlapArray mTriggerOverlaps;
+
+		// cache of each pair on this frame.
+		static std::vector<PairCache> mFrameCaches;
+
+		// broad-phase state of a physics layer.
+		// the proxies are kept over frames for each component, and the
+		// user data of a proxy is the index of the component in
+		// 'components', which is filled by the caller on each frame.
+		struct Broadphase {
+			struct ProxyEntry {
+				ABroadphase::ProxyID id;
+				uinteger frame;
+			};
+			typedef std::unordered_map<const ASceneComponent*, ProxyEntry> ProxyMap;
+
+			ABroadphase* detector;
+			ProxyMap proxies;
+			std::vector<ASceneComponent*> components;
+			ABroadphase::PairArray pairs;
+			uinteger frame;
+
+			// overlaps of the trigger pairs on the last process of this
+			// pass, and the pairs of them. each pass has its own, so
+			// 'begin' does not depend on the other pass.
+			TriggerOverlapArray triggerOverlaps;
+			std::set<ComponentPair> triggerPairs;
+
+			Broadphase();
+			~Broadphase();
+
+			// replace the detector. the proxies are made again on next frame.
+			void Reset(BroadphaseType type);
+		};
+		static Broadphase mMeshBroadphase;
+		static Broadphase mConvexBroadphase;
+
+		// update the proxies of the components and find the pairs whose
+		// bounding boxes overlap. the components without collider overlap
+		// with all the others. the pairs are sorted in the order of the
+		// components, so the narrow-phase runs in the same order as the
+		// full pair loop. the pairs which do not pass FilterPair are
+		// dropped before sorting.
+		static const ABroadphase::PairArray& FindPairs(Broadphase& bp);
+
+		// whether the pair is tested. the pairs of two fixed bodies, and
+		// the colliders whose category is not in the mask of the other
+		// are not. (see ACollider::CanCollide)
+		static bool FilterPair(ASceneComponent* comp1, ASceneComponent* comp2);
+
+		// set the overlaps of the trigger pairs of the pass on this process,
+		// and mark the ones which begin. the overlaps of both passes are
+		// merged again.
+		static void SetTriggerOverlaps(Broadphase& bp, const std::vector<ComponentPair>& overlaps);
+
+		// simulation islands of the components on this frame.
+		static UnionFind mIslands;
+
+		// solver of the contacts of a frame.
+		static ContactSolver mSolver;
+
+		// the bullets which move less than the ratio of their smallest
+		// size on a frame are not swept, since they can not pass through.
+		static const real BULLET_MOTION_RATIO;
+
+		// first impacts of the bullets on this frame, as the index pairs
+		// of the components, and their single point manifolds.
+		static ABroadphase::PairArray mImpacts;
+		static std::vector<ContactManifold> mImpactManifolds;
+
+		// sweep the motions of the bullets on this frame against the
+		// other components, and move them back to the first impacts.
+		// the colliders are at the start of the motions, and the components
+		// are at the end of them.
+		static void SweepBullets(const std::vector<ASceneComponent*>& components);
+
+		// join the components of the contacts into the islands, and wake
+		// up the islands which have an awake body. the fixed bodies do not
+		// join, so the floor does not bind all the islands on it.
+		// *param:
+		//     components - the components of the broad-phase.
+		//     contacts   - index pairs of the touching components.
+		static void WakeIslands(const std::vector<ASceneComponent*>& components,
+			const ABroadphase::PairArray& contacts);
+
+		// count the still time of the bodies after resolving the contacts,
+		// and put the islands whose bodies are all still to sleep.
+		// it uses the islands of the last WakeIslands.
+		static void SleepIslands(const std::vector<ASceneComponent*>& components);
+
 	public:
+		// select the algorithm of the broad-phase.
+		// sweep and prune (default) is the fastest for the coherent
+		// frames of many moving bodies, and the tree is better for the
+		// scenes of the sparse or the teleporting bodies.
+		static void SetBroadphaseType(BroadphaseType type);
+
+		// set the number of threads for narrow-phase of convex pairs.
+		// 0 means hardware concurrency. (default)
+		// the contacts are resolved in the same order at any count.
+		static void SetThreadCount(uinteger count);
+
+		// set the number of velocity iterations of the contact solver.
+		// the more iterations make the stacks stiffer, and take the
+		// more time. (ContactSolver::DEFAULT_ITERATIONS by default)
+		static void SetSolverIterations(uinteger iterations);
+
+		// the number of pairs in a chunk of parallel narrow-phase.
+		static const uinteger NARROWPHASE_GRAIN = 4;
+
 		// process the collisions.
-		// it checks the bounding volume intersections on broad-phase
+		// it finds the pairs whose bounding boxes overlap on broad-phase,
+		// and checks the collider intersections on broad-phase.
+		// the pairs with a trigger collider end at the intersection test.
 		// and then test mesh-level collisions to generate collision
 		// datas on narrow-phase.
-		// if there are collisions, it'll resolve them
+		// if there are collisions, they are resolved by the contact solver.
 		static void ProcessCollision(AScene::Layer& physLayer);
 
 		// process the collisions about convexity objects.
-		// it assumes that the scene components in given layer have
-		// those own convex-hull as collider.
+		// it takes the scene components in given layer which have collider.
+		// the pairs are found by the broad-phase. (see SetBroadphaseType)
+		// the contacts are made by the types of the colliders.
+		// (see ContactLevelDetection)
+		// narrow-phase of the pairs runs in parallel, and then the contacts
+		// are sorted by component ids and resolved together by the
+		// contact solver. (see ContactSolver)
+		// each pair has the manifold of up to four points, which is kept
+		// over frames. (see ContactManifold)
+		// the bullets are swept before solving, and stop at the first
+		// impact on the frame. (see RigidBody::IsBullet)
+		// the pairs with a trigger collider have only the intersection
+		// test, and they are reported as the overlaps instead of contacts.
 		static void ProcessConvexCollision(AScene::Layer& physLayer);
 
-	public:
-		typedef ArrayBuffer::AttributeAccessor<Position3> PositionAccessor;
-		typedef ArrayBuffer::AttributeAccessor<TriangleFace16> IndexAccessor;
+		// get the overlaps of the trigger colliders on the last process.
+		// the overlaps of ProcessCollision come first, and then the ones of
+		// ProcessConvexCollision. each of them is by its last process.
+		// the order does not depend on the thread count.
+		static const TriggerOverlapArray& GetTriggerOverlaps();
 
+	public:
 		// triangle-mesh level detection.
-		static bool MeshLevelDetection(const PositionAccessor& positions1, const IndexAccessor& indices1, const Matrix4& TM1,
-			const PositionAccessor& positions2, const IndexAccessor& indices2, const Matrix4& TM2,
-			Vector3& out_CN, Vector3& out_CP);
+		// only the triangle pairs in the overlapping leaves of the
+		// hierarchies are tested. (see TriangleBVH)
+		// the midpoints of the intersecting triangle pairs are reduced to
+		// the manifold, and the normal is the average of the pairs.
+		static bool MeshLevelDetection(const TriangleBVH& bvh1, const Matrix4& TM1,
+			const TriangleBVH& bvh2, const Matrix4& TM2,
+			ContactManifold& out_manifold);
 
 		// convex level detection.
-		static bool ConvexLevelDetection(const ConvexHull* convex1, const ConvexHull* convex2,
-			Vector3& out_CN, Vector3& out_CP, real& out_depth);
+		// 'hint' is the support search hint of the pair. (see GJK_EPA::SupportHint)
+		static bool ConvexLevelDetection(const ASupportShape* convex1, const ASupportShape* convex2,
+			Vector3& out_CN, Vector3& out_CP, real& out_depth,
+			GJK_EPA::SupportHint* hint = NULL);
+
+		// contact level detection.
+		// it is dispatched by the types of the colliders. the pairs of
+		// spheres and oriented boxes have the analytic contacts, the pairs
+		// of hulls clip their polygons, and the others have the single
+		// point of GJK and EPA. the pairs with margin always have the
+		// single point, since the others do not round the shapes.
+		// *param:
+		//     coll1,coll2  - the colliders by the last update.
+		//     out_manifold - the contact points. the normal points from
+		//                    the second collider to the first.
+		//     hint         - the support search hint of the pair.
+		static bool ContactLevelDetection(const ACollider* coll1, const ACollider* coll2,
+			ContactManifold& out_manifold, GJK_EPA::SupportHint* hint = NULL);
 
-		static void Resolve(RigidBody* rigidBody1, RigidBody* rigidBody2,
-			const Vector3& CN, const Vector3& CP, const real depth);
+		// get world matrix of the collider by the last update.
+		// the contact points are kept in the space of it over frames.
+		// the colliders without orientation (e.g. sphere) have translation only.
+		static const Matrix4 GetColliderMatrix(const ACollider* coll);
 	};
 
 }
@@ -0,0 +1,63 @@
+#include "CollisionGeometry.h"
+#ifndef SARKLIB_HEADLESS
+#include "Mesh.h"
+#endif
+
+namespace sark {
+
+	CollisionGeometry::CollisionGeometry() {}
+
+#ifndef SARKLIB_HEADLESS
+	// build from the array buffer of the mesh.
+	bool CollisionGeometry::Build(Mesh* mesh) {
+		mBVH.Clear();
+
+		ArrayBuffer& arrbuf = mesh->GetArrayBuffer();
+		if (arrbuf.GetDrawMode() != ArrayBuffer::DrawMode::TRIANGLES
+			|| arrbuf.GetDataCount(AttributeSemantic::INDICES) == 0)
+			return false;
+
+		ArrayBuffer::AttributeAccessor<Position3> positions
+			= arrbuf.GetAttributeAccessor<Position3>(AttributeSemantic::POSITION);
+		if (positions.Empty())
+			return false;
+
+		if (arrbuf.GetElementType(AttributeSemantic::INDICES) == ArrayBuffer::ElementType::UNSIGNED_INT) {
+			ArrayBuffer::AttributeAccessor<TriangleFace32> indices
+				= arrbuf.GetAttributeAccessor<TriangleFace32>(AttributeSemantic::INDICES);
+			if (indices.Empty())
+				return false;
+			Build(&positions[0], positions.Count(), &indices[0], indices.Count());
+		}
+		else {
+			ArrayBuffer::AttributeAccessor<TriangleFace16> indices
+				= arrbuf.GetAttributeAccessor<TriangleFace16>(AttributeSemantic::INDICES);
+			if (indices.Empty())
+				return false;
+			Build(&positions[0], positions.Count(), &indices[0], indices.Count());
+		}
+		return true;
+	}
+#endif
+
+	// is it empty?
+	bool CollisionGeometry::Empty() const {
+		return mBVH.Empty();
+	}
+
+	// get the number of triangles.
+	uinteger CollisionGeometry::GetTriangleCount() const {
+		return mBVH.GetTriangleCount();
+	}
+
+	// get object space bounding box.
+	void CollisionGeometry::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		mBVH.GetBounds(out_min, out_max);
+	}
+
+	// get triangle hierarchy for the mesh level detection.
+	const TriangleBVH& CollisionGeometry::GetTriangleBVH() const {
+		return mBVH;
+	}
+
+}
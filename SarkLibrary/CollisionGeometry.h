@@ -0,0 +1,61 @@
+#ifndef __COLLISION_GEOMETRY_H__
+#define __COLLISION_GEOMETRY_H__
+
+#include "core.h"
+#include "IUncopiable.hpp"
+#include "TriangleBVH.h"
+
+namespace sark {
+
+	class Mesh;
+
+	// triangle geometry for collision detection.
+	// it is built once from the vertex data and kept in system memory,
+	// so the narrow phase does not map the GL buffers. it needs no GL
+	// context, and it is read only after building, so the models made
+	// from the same resource share one of it.
+	//   s_ptr<CollisionGeometry> geom(new CollisionGeometry());
+	//   geom->Build(&positions[0], positions.size(), &faces[0], faces.size());
+	//   model->SetCollisionGeometry(geom);
+	class CollisionGeometry : public IUncopiable {
+	private:
+		// object space triangles and their hierarchy.
+		TriangleBVH mBVH;
+
+	public:
+		CollisionGeometry();
+
+		// build from the positions and the triangle faces.
+		// _Face is TriangleFace16 or TriangleFace32.
+		// *param:
+		//     points     - object space positions.
+		//     pointCount - the number of positions.
+		//     faces      - triangle indices of positions.
+		//     faceCount  - the number of faces.
+		template<class _Face>
+		void Build(const Position3* points, uinteger pointCount, const _Face* faces, uinteger faceCount) {
+			mBVH.Build(points, pointCount, faces, faceCount);
+		}
+
+#ifndef SARKLIB_HEADLESS
+		// build from the array buffer of the mesh.
+		// it maps the position and the index buffers once.
+		// *return: false if the mesh is not an indexed triangle mesh.
+		bool Build(Mesh* mesh);
+#endif
+
+		// is it empty?
+		bool Empty() const;
+
+		// get the number of triangles.
+		uinteger GetTriangleCount() const;
+
+		// get object space bounding box.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const;
+
+		// get triangle hierarchy for the mesh level detection.
+		const TriangleBVH& GetTriangleBVH() const;
+	};
+
+}
+#endif
@@ -0,0 +1,336 @@
+#include "ContactManifold.h"
+#include "ConvexHull.h"
+
+namespace sark {
+
+	const real ContactManifold::CONTACT_MARGIN = 0.02f;
+	const real ContactManifold::MATCH_DISTANCE = 0.05f;
+	const real ContactManifold::POLYGON_COSINE = 0.9f;
+
+	namespace {
+
+		// the maximum number of polygon vertices to clip.
+		// the clipped polygon has the vertices of both at most.
+		const uinteger MAX_CLIP_VERTICES = 64;
+
+		inline Vector3 TransformPoint(const Matrix4& M, const Vector3& P) {
+			return Vector3(
+				M.m[0][0] * P.x + M.m[0][1] * P.y + M.m[0][2] * P.z + M.m[0][3],
+				M.m[1][0] * P.x + M.m[1][1] * P.y + M.m[1][2] * P.z + M.m[1][3],
+				M.m[2][0] * P.x + M.m[2][1] * P.y + M.m[2][2] * P.z + M.m[2][3]);
+		}
+
+		// get world space vertices of polygon.
+		// *return: the number of vertices, or 0 if it is too many.
+		uinteger GetPolygonVertices(const ConvexHull* convex, integer polygon, Vector3* out_points) {
+			const ConvexHull::Polygon& poly = convex->GetPolygonSet()[polygon];
+			if (poly.count > MAX_CLIP_VERTICES)
+				return 0;
+			const std::vector<uint16>& indices = convex->GetPolygonIndices();
+			for (uinteger i = 0; i < poly.count; i++)
+				out_points[i] = convex->GetWorldPoint(indices[poly.begin + i]);
+			return poly.count;
+		}
+
+		// clip polygon by the plane, and keep the part behind it.
+		// (Sutherland-Hodgman)
+		uinteger ClipByPlane(const Vector3* in, uinteger count,
+			const Vector3& plane_n, const Vector3& plane_p, Vector3* out)
+		{
+			uinteger outCount = 0;
+			for (uinteger i = 0; i < count; i++) {
+				const Vector3& P = in[i];
+				const Vector3& Q = in[(i + 1) % count];
+				const real dP = plane_n.Dot(P - plane_p);
+				const real dQ = plane_n.Dot(Q - plane_p);
+				if (dP <= 0)
+					out[outCount++] = P;
+				if ((dP < 0 && dQ > 0) || (dP > 0 && dQ < 0))
+					out[outCount++] = P + (Q - P) * (dP / (dP - dQ));
+			}
+			return outCount;
+		}
+
+	}
+
+	ContactManifold::ContactManifold()
+		: mNormal(0.f), mPointCount(0) {}
+
+	// remove all points.
+	void ContactManifold::Clear() {
+		mPointCount = 0;
+	}
+
+	// get contact normal.
+	const Vector3& ContactManifold::GetNormal() const {
+		return mNormal;
+	}
+
+	// set contact normal.
+	void ContactManifold::SetNormal(const Vector3& normal) {
+		mNormal = normal;
+	}
+
+	// get the number of points.
+	uinteger ContactManifold::GetPointCount() const {
+		return mPointCount;
+	}
+
+	// get contact point.
+	ContactManifold::Point& ContactManifold::GetPoint(uinteger index) {
+		return mPoints[index];
+	}
+
+	// get contact point.
+	const ContactManifold::Point& ContactManifold::GetPoint(uinteger index) const {
+		return mPoints[index];
+	}
+
+	// get the deepest penetration of the points.
+	real ContactManifold::GetMaxDepth() const {
+		real depth = 0;
+		for (uinteger i = 0; i < mPointCount; i++)
+			depth = math::max(depth, mPoints[i].depth);
+		return depth;
+	}
+
+	// add point. it is ignored if the manifold is full.
+	void ContactManifold::AddPoint(const Vector3& position, real depth) {
+		if (mPointCount == MAX_POINTS)
+			return;
+		Point& point = mPoints[mPointCount++];
+		point.position = position;
+		point.localA = point.localB = Vector3(0.f);
+		point.depth = depth;
+		point.normalImpulse = 0;
+		point.tangentImpulse[0] = point.tangentImpulse[1] = 0;
+		point.lifetime = 0;
+	}
+
+	// build the manifold of the convex hulls.
+	// the reference polygon is the one of the two most parallel to the
+	// contact normal, and the incident polygon of the other hull is
+	// clipped by the side planes of the reference one. the clipped points
+	// under the reference polygon are the contacts.
+	void ContactManifold::Build(const ConvexHull* convex1, const ConvexHull* convex2,
+		const Vector3& CN, const Vector3& CP, real depth)
+	{
+		Clear();
+		mNormal = CN;
+		const Matrix4 inv1 = convex1->GetWorldMatrix().AffineInverse();
+		const Matrix4 inv2 = convex2->GetWorldMatrix().AffineInverse();
+
+		// CN points from the second hull to the first, so the polygon of
+		// the first hull faces -CN.
+		Vector3 normal1, normal2;
+		const integer poly1 = convex1->SupportPolygon(-CN, &normal1);
+		const integer poly2 = convex2->SupportPolygon(CN, &normal2);
+		const real cos1 = normal1.Dot(-CN);
+		const real cos2 = normal2.Dot(CN);
+		if (poly1 >= 0 && poly2 >= 0 && math::max(cos1, cos2) > POLYGON_COSINE) {
+			// the first hull is preferred on a tie, so the reference
+			// does not swap between the frames.
+			const bool refIs1 = (cos1 + 0.001f >= cos2);
+			const ConvexHull* ref = (refIs1 ? convex1 : convex2);
+			const ConvexHull* inc = (refIs1 ? convex2 : convex1);
+			const Vector3& refNormal = (refIs1 ? normal1 : normal2);
+
+			// the incident polygon faces against the reference normal.
+			const integer refPoly = (refIs1 ? poly1 : poly2);
+			const integer incPoly = inc->SupportPolygon(-refNormal);
+
+			Vector3 refPoints[MAX_CLIP_VERTICES];
+			Vector3 clip[2][MAX_CLIP_VERTICES * 2];
+			const uinteger refCount = GetPolygonVertices(ref, refPoly, refPoints);
+			uinteger clipCount = GetPolygonVertices(inc, incPoly, clip[0]);
+			if (refCount > 0 && clipCount > 0) {
+				uinteger cur = 0;
+				for (uinteger i = 0; i < refCount && clipCount > 0; i++) {
+					const Vector3& A = refPoints[i];
+					const Vector3& B = refPoints[(i + 1) % refCount];
+					clipCount = ClipByPlane(clip[cur], clipCount, (B - A).Cross(refNormal), A, clip[1 - cur]);
+					cur = 1 - cur;
+				}
+
+				// the points under the reference polygon.
+				Vector3 points[MAX_CLIP_VERTICES * 2];
+				real depths[MAX_CLIP_VERTICES * 2];
+				uinteger count = 0;
+				for (uinteger i = 0; i < clipCount; i++) {
+					const real separation = refNormal.Dot(clip[cur][i] - refPoints[0]);
+					if (separation <= CONTACT_MARGIN) {
+						points[count] = clip[cur][i];
+						depths[count++] = math::max(-separation, 0);
+					}
+				}
+
+				uinteger indices[MAX_POINTS];
+				const uinteger chosen = ReducePoints(points, depths, count, refNormal, indices);
+				for (uinteger i = 0; i < chosen; i++) {
+					// the incident point and its projection on the reference polygon.
+					const Vector3& P = points[indices[i]];
+					const Vector3 onRef = P - refNormal * refNormal.Dot(P - refPoints[0]);
+					const Vector3& P1 = (refIs1 ? onRef : P);
+					const Vector3& P2 = (refIs1 ? P : onRef);
+					AddPoint(P1, depths[indices[i]]);
+					mPoints[mPointCount - 1].localA = TransformPoint(inv1, P1);
+					mPoints[mPointCount - 1].localB = TransformPoint(inv2, P2);
+				}
+				if (mPointCount > 0) {
+					mNormal = (refIs1 ? -refNormal : refNormal);
+					return;
+				}
+			}
+		}
+
+		// single point of EPA. CP is on the first hull, and it moves
+		// onto the second one by the depth along the normal.
+		AddPoint(CP, depth);
+		mPoints[0].localA = TransformPoint(inv1, CP);
+		mPoints[0].localB = TransformPoint(inv2, CP + CN * depth);
+	}
+
+	// build the manifold of the contact points.
+	void ContactManifold::Build(const Vector3& CN, const Vector3* points, const real* depths, uinteger count,
+		const Matrix4& TM1, const Matrix4& TM2)
+	{
+		Clear();
+		mNormal = CN;
+		const Matrix4 inv1 = TM1.AffineInverse();
+		const Matrix4 inv2 = TM2.AffineInverse();
+
+		uinteger indices[MAX_POINTS];
+		const uinteger chosen = ReducePoints(points, depths, count, CN, indices);
+		for (uinteger i = 0; i < chosen; i++) {
+			const Vector3& P = points[indices[i]];
+			const real depth = depths[indices[i]];
+			AddPoint(P, depth);
+			mPoints[mPointCount - 1].localA = TransformPoint(inv1, P);
+			mPoints[mPointCount - 1].localB = TransformPoint(inv2, P + CN * depth);
+		}
+	}
+
+	// turn the manifold for the reversed pair.
+	void ContactManifold::Flip() {
+		for (uinteger i = 0; i < mPointCount; i++) {
+			Point& point = mPoints[i];
+			point.position += mNormal * point.depth;
+			const Vector3 local = point.localA;
+			point.localA = point.localB;
+			point.localB = local;
+		}
+		mNormal = -mNormal;
+	}
+
+	// take over the data of the last points.
+	void ContactManifold::Merge(const ContactManifold& last, const Matrix4& TM1) {
+		// the normal is turned over, so the points are new.
+		if (last.mPointCount == 0 || last.mNormal.Dot(mNormal) < POLYGON_COSINE)
+			return;
+
+		Vector3 lastPositions[MAX_POINTS];
+		bool matched[MAX_POINTS];
+		for (uinteger i = 0; i < last.mPointCount; i++) {
+			lastPositions[i] = TransformPoint(TM1, last.mPoints[i].localA);
+			matched[i] = false;
+		}
+
+		const real matchSq = MATCH_DISTANCE * MATCH_DISTANCE;
+		for (uinteger i = 0; i < mPointCount; i++) {
+			integer nearest = -1;
+			real nearestSq = matchSq;
+			for (uinteger j = 0; j < last.mPointCount; j++) {
+				const real distSq = (lastPositions[j] - mPoints[i].position).MagnitudeSq();
+				if (!matched[j] && distSq < nearestSq) {
+					nearest = (integer)j;
+					nearestSq = distSq;
+				}
+			}
+			if (nearest >= 0) {
+				matched[nearest] = true;
+				mPoints[i].normalImpulse = last.mPoints[nearest].normalImpulse;
+				mPoints[i].tangentImpulse[0] = last.mPoints[nearest].tangentImpulse[0];
+				mPoints[i].tangentImpulse[1] = last.mPoints[nearest].tangentImpulse[1];
+				mPoints[i].lifetime = last.mPoints[nearest].lifetime + 1;
+			}
+		}
+	}
+
+	// choose the points to keep among the candidates.
+	uinteger ContactManifold::ReducePoints(const Vector3* points, const real* depths, uinteger count,
+		const Vector3& normal, uinteger out_indices[MAX_POINTS])
+	{
+		if (count <= MAX_POINTS) {
+			for (uinteger i = 0; i < count; i++)
+				out_indices[i] = i;
+			return count;
+		}
+
+		// the deepest one.
+		uinteger i0 = 0;
+		for (uinteger i = 1; i < count; i++) {
+			if (depths[i] > depths[i0])
+				i0 = i;
+		}
+		const Vector3& P0 = points[i0];
+
+		// the farthest one from it.
+		uinteger i1 = i0;
+		real best = 0;
+		for (uinteger i = 0; i < count; i++) {
+			const real distSq = (points[i] - P0).MagnitudeSq();
+			if (distSq > best) {
+				best = distSq;
+				i1 = i;
+			}
+		}
+		if (i1 == i0) {
+			out_indices[0] = i0;
+			return 1;
+		}
+		const Vector3& P1 = points[i1];
+
+		// the one of the largest triangle with them.
+		uinteger i2 = i0;
+		real area2 = 0;
+		for (uinteger i = 0; i < count; i++) {
+			const real area = (P1 - P0).Cross(points[i] - P0).Dot(normal);
+			if (area * area > area2 * area2) {
+				area2 = area;
+				i2 = i;
+			}
+		}
+		out_indices[0] = i0;
+		out_indices[1] = i1;
+		if (i2 == i0) {
+			return 2;
+		}
+		out_indices[2] = i2;
+		const Vector3& P2 = points[i2];
+
+		// the one which adds the largest area to the triangle.
+		// it is the farthest one outside of the triangle edges, and the
+		// sign of area2 tells the winding of the triangle.
+		const Vector3 tri[3] = { P0, P1, P2 };
+		const real winding = (area2 > 0 ? 1.f : -1.f);
+		uinteger i3 = i0;
+		real area3 = 0;
+		for (uinteger i = 0; i < count; i++) {
+			real outside = 0;
+			for (uinteger e = 0; e < 3; e++) {
+				const Vector3& A = tri[e];
+				const Vector3& B = tri[(e + 1) % 3];
+				outside = math::min(outside, winding * (B - A).Cross(points[i] - A).Dot(normal));
+			}
+			if (outside < area3) {
+				area3 = outside;
+				i3 = i;
+			}
+		}
+		if (i3 == i0)
+			return 3;
+		out_indices[3] = i3;
+		return 4;
+	}
+
+}
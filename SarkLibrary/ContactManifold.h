@@ -0,0 +1,138 @@
+#ifndef __CONTACT_MANIFOLD_H__
+#define __CONTACT_MANIFOLD_H__
+
+#include "core.h"
+
+namespace sark {
+
+	class ConvexHull;
+
+	// contact points of a pair of colliders, up to four.
+	// a single point can not hold a box on the floor, it rocks around the
+	// point. the manifold of convex hulls is made by clipping the incident
+	// polygon with the reference polygon, which is the most parallel one
+	// to the contact normal, and it is reduced to the four points which
+	// span the largest area. the other colliders give their own points.
+	// (see tool::OBox_OBoxContact)
+	// the manifold is kept over frames for each pair, and the new points
+	// which are close to the last ones take over their data.
+	//   manifold.Build(convex1, convex2, CN, CP, depth);
+	//   manifold.Merge(lastManifold, convex1->GetWorldMatrix());
+	class ContactManifold {
+	public:
+		// the maximum number of points.
+		static const uinteger MAX_POINTS = 4;
+
+		// the clipped points which are above the reference polygon within
+		// it are also contacts, so the resting contacts do not flicker.
+		static const real CONTACT_MARGIN;
+
+		// the points of two frames are the same one if they are within it.
+		static const real MATCH_DISTANCE;
+
+		// polygons are clipped if their normal and the contact normal
+		// make the cosine over it. the others (e.g. edge-edge contact)
+		// have the single point of EPA.
+		static const real POLYGON_COSINE;
+
+		struct Point {
+			// world space point on the first collider.
+			Vector3 position;
+
+			// object space points on the colliders.
+			Vector3 localA, localB;
+
+			// penetration depth. (0 or more)
+			real depth;
+
+			// impulse along the normal applied on the last frame.
+			real normalImpulse;
+
+			// friction impulses along the tangents of the normal.
+			// (see ContactSolver)
+			real tangentImpulse[2];
+
+			// the number of frames which the point has persisted.
+			uinteger lifetime;
+		};
+
+	private:
+		// contact normal. it points from the second collider to the first.
+		Vector3 mNormal;
+
+		Point mPoints[MAX_POINTS];
+		uinteger mPointCount;
+
+	public:
+		ContactManifold();
+
+		// remove all points.
+		void Clear();
+
+		// get contact normal.
+		const Vector3& GetNormal() const;
+
+		// set contact normal.
+		void SetNormal(const Vector3& normal);
+
+		// get the number of points.
+		uinteger GetPointCount() const;
+
+		// get contact point.
+		Point& GetPoint(uinteger index);
+		const Point& GetPoint(uinteger index) const;
+
+		// get the deepest penetration of the points.
+		real GetMaxDepth() const;
+
+		// add point. it is ignored if the manifold is full.
+		// the local points are not set.
+		void AddPoint(const Vector3& position, real depth);
+
+		// build the manifold of the convex hulls.
+		// *param:
+		//     convex1,convex2 - the hulls by the last update.
+		//     CN,CP,depth     - the single contact of ConvexLevelDetection.
+		//                       it is used when the polygons are not clipped.
+		void Build(const ConvexHull* convex1, const ConvexHull* convex2,
+			const Vector3& CN, const Vector3& CP, real depth);
+
+		// build the manifold of the contact points.
+		// they are reduced to MAX_POINTS. (see ReducePoints)
+		// *param:
+		//     CN            - contact normal.
+		//     points,depths - the points on the first collider, and their
+		//                     depths. the points on the second one are
+		//                     (point + CN * depth).
+		//     count         - the number of points.
+		//     TM1,TM2       - world matrices of the colliders.
+		void Build(const Vector3& CN, const Vector3* points, const real* depths, uinteger count,
+			const Matrix4& TM1, const Matrix4& TM2);
+
+		// turn the manifold for the reversed pair.
+		// the normal is reversed, and the points move onto the second collider.
+		void Flip();
+
+		// take over the data of the last points.
+		// each point gets the data of the nearest last point within
+		// MATCH_DISTANCE, which is compared on the current transform.
+		// *param:
+		//     last - the manifold of the pair on the last frame.
+		//     TM1  - world matrix of the first collider of the pair.
+		void Merge(const ContactManifold& last, const Matrix4& TM1);
+
+		// choose the points to keep among the candidates.
+		// they are the deepest one, the farthest one from it, and the
+		// two which make the largest area with them.
+		// *param:
+		//     points,depths - the candidates.
+		//     count         - the number of candidates.
+		//     normal        - contact normal.
+		//     out_indices   - indices of chosen points.
+		// *return: the number of chosen points. (MAX_POINTS at most)
+		static uinteger ReducePoints(const Vector3* points, const real* depths, uinteger count,
+			const Vector3& normal, uinteger out_indices[MAX_POINTS]);
+	};
+
+}
+#endif
@@ -0,0 +1,204 @@
+#include "ContactSolver.h"
+#include "ASceneComponent.h"
+#include "RigidBody.h"
+
+namespace sark {
+
+	const real ContactSolver::PENETRATION_SLOP = 0.01f;
+	const real ContactSolver::PENETRATION_CORRECTION = 0.8f;
+	const real ContactSolver::RESTITUTION_VELOCITY = 1.f;
+
+	namespace {
+
+		// two unit tangents of the unit normal. they are the same for
+		// the same normal, so the friction impulses of the last frame
+		// are along the same directions.
+		void ComputeTangents(const Vector3& n, Vector3& out_t1, Vector3& out_t2) {
+			// the axis least parallel to the normal.
+			const Vector3 axis = (n.x * n.x < 0.5f ? Vector3(1.f, 0.f, 0.f) : Vector3(0.f, 1.f, 0.f));
+			out_t1 = n.Cross(axis).Normal();
+			out_t2 = n.Cross(out_t1);
+		}
+
+		// inverse of the effective mass along the direction.
+		real ComputeMass(const Vector3& dir, const Vector3& r1, const Vector3& r2,
+			real invMass1, const Matrix3& invI1, real invMass2, const Matrix3& invI2)
+		{
+			const real k = invMass1 + invMass2
+				+ dir.Dot((invI1 * r1.Cross(dir)).Cross(r1))
+				+ dir.Dot((invI2 * r2.Cross(dir)).Cross(r2));
+			return (k > 0 ? 1.f / k : 0);
+		}
+
+	}
+
+	ContactSolver::ContactSolver()
+		: mIterations(DEFAULT_ITERATIONS) {}
+
+	// get the number of velocity iterations.
+	uinteger ContactSolver::GetIterations() const {
+		return mIterations;
+	}
+
+	// set the number of velocity iterations.
+	void ContactSolver::SetIterations(uinteger iterations) {
+		mIterations = iterations;
+	}
+
+	// remove all contacts.
+	void ContactSolver::Clear() {
+		mBodies.clear();
+		mBodyIndices.clear();
+		mConstraints.clear();
+		mPenetrations.clear();
+	}
+
+	// get index of the body state, which is added on the first time.
+	uinteger ContactSolver::AddBody(ASceneComponent* component) {
+		RigidBody* body = component->GetRigidBody();
+		auto res = mBodyIndices.insert(std::make_pair(body, (uinteger)mBodies.size()));
+		if (!res.second)
+			return res.first->second;
+
+		BodyState state;
+		state.component = component;
+		state.velocity = body->GetVelocity();
+		state.angularVelocity = body->GetAngularVelocity();
+		if (body->IsActive()) {
+			state.invMass = body->GetInvMass();
+			state.invI = body->GetInvInertiaTensor();
+		}
+		else {
+			state.invMass = 0;
+			state.invI = Matrix3(0.f);
+		}
+		mBodies.push_back(state);
+		return res.first->second;
+	}
+
+	// add the points of the manifold.
+	void ContactSolver::AddManifold(ASceneComponent* comp1, ASceneComponent* comp2,
+		ContactManifold& manifold)
+	{
+		if (manifold.GetPointCount() == 0)
+			return;
+
+		const uinteger body1 = AddBody(comp1);
+		const uinteger body2 = AddBody(comp2);
+		const Vector3 cm1 = comp1->GetRigidBody()->GetCM();
+		const Vector3 cm2 = comp2->GetRigidBody()->GetCM();
+
+		Constraint c;
+		c.body1 = body1;
+		c.body2 = body2;
+		c.normal = manifold.GetNormal();
+		ComputeTangents(c.normal, c.tangent[0], c.tangent[1]);
+		for (uinteger i = 0; i < manifold.GetPointCount(); i++) {
+			ContactManifold::Point& point = manifold.GetPoint(i);
+			c.r1 = point.position - cm1;
+			c.r2 = point.position - cm2;
+			c.normalImpulse = point.normalImpulse;
+			c.tangentImpulse[0] = point.tangentImpulse[0];
+			c.tangentImpulse[1] = point.tangentImpulse[1];
+			c.point = &point;
+			mConstraints.push_back(c);
+		}
+
+		Penetration p;
+		p.body1 = body1;
+		p.body2 = body2;
+		p.normal = manifold.GetNormal();
+		p.depth = manifold.GetMaxDepth();
+		mPenetrations.push_back(p);
+	}
+
+	// apply the impulse at the points of the constraint.
+	void ContactSolver::ApplyImpulse(const Constraint& c, const Vector3& impulse) {
+		BodyState& b1 = mBodies[c.body1];
+		BodyState& b2 = mBodies[c.body2];
+		b1.velocity += impulse * b1.invMass;
+		b1.angularVelocity += b1.invI * c.r1.Cross(impulse);
+		b2.velocity -= impulse * b2.invMass;
+		b2.angularVelocity -= b2.invI * c.r2.Cross(impulse);
+	}
+
+	// solve the contacts.
+	void ContactSolver::Solve(real restitution, real friction) {
+		// effective masses, and the target velocities by the
+		// approaching velocities before solving.
+		for (auto& c : mConstraints) {
+			const BodyState& b1 = mBodies[c.body1];
+			const BodyState& b2 = mBodies[c.body2];
+			c.normalMass = ComputeMass(c.normal, c.r1, c.r2, b1.invMass, b1.invI, b2.invMass, b2.invI);
+			c.tangentMass[0] = ComputeMass(c.tangent[0], c.r1, c.r2, b1.invMass, b1.invI, b2.invMass, b2.invI);
+			c.tangentMass[1] = ComputeMass(c.tangent[1], c.r1, c.r2, b1.invMass, b1.invI, b2.invMass, b2.invI);
+
+			const Vector3 dv = (b1.velocity + b1.angularVelocity.Cross(c.r1))
+				- (b2.velocity + b2.angularVelocity.Cross(c.r2));
+			const real vn = c.normal.Dot(dv);
+			c.bias = (vn < -RESTITUTION_VELOCITY ? -restitution * vn : 0);
+		}
+
+		// warm starting.
+		for (auto& c : mConstraints) {
+			ApplyImpulse(c, c.normal * c.normalImpulse
+				+ c.tangent[0] * c.tangentImpulse[0] + c.tangent[1] * c.tangentImpulse[1]);
+		}
+
+		for (uinteger iter = 0; iter < mIterations; iter++) {
+			for (auto& c : mConstraints) {
+				const BodyState& b1 = mBodies[c.body1];
+				const BodyState& b2 = mBodies[c.body2];
+
+				// friction. it is bounded by the normal impulse.
+				const real maxFriction = friction * c.normalImpulse;
+				for (uinteger t = 0; t < 2; t++) {
+					const Vector3 dv = (b1.velocity + b1.angularVelocity.Cross(c.r1))
+						- (b2.velocity + b2.angularVelocity.Cross(c.r2));
+					const real lambda = -c.tangentMass[t] * c.tangent[t].Dot(dv);
+					const real impulse = math::max(-maxFriction, math::min(c.tangentImpulse[t] + lambda, maxFriction));
+					ApplyImpulse(c, c.tangent[t] * (impulse - c.tangentImpulse[t]));
+					c.tangentImpulse[t] = impulse;
+				}
+
+				// normal. the accumulated impulse only pushes.
+				const Vector3 dv = (b1.velocity + b1.angularVelocity.Cross(c.r1))
+					- (b2.velocity + b2.angularVelocity.Cross(c.r2));
+				const real lambda = c.normalMass * (c.bias - c.normal.Dot(dv));
+				const real impulse = math::max(c.normalImpulse + lambda, 0);
+				ApplyImpulse(c, c.normal * (impulse - c.normalImpulse));
+				c.normalImpulse = impulse;
+			}
+		}
+
+		for (auto& c : mConstraints) {
+			c.point->normalImpulse = c.normalImpulse;
+			c.point->tangentImpulse[0] = c.tangentImpulse[0];
+			c.point->tangentImpulse[1] = c.tangentImpulse[1];
+		}
+
+		// the penetrations are shared by the bodies of the pair.
+		for (auto& p : mPenetrations) {
+			BodyState& b1 = mBodies[p.body1];
+			BodyState& b2 = mBodies[p.body2];
+			const real invMass = b1.invMass + b2.invMass;
+			const real depth = p.depth - PENETRATION_SLOP;
+			if (invMass == 0 || depth <= 0)
+				continue;
+			const Vector3 correction = p.normal * (depth * PENETRATION_CORRECTION / invMass);
+			if (b1.invMass != 0)
+				b1.component->GetTransform().TranslateMore(correction * b1.invMass);
+			if (b2.invMass != 0)
+				b2.component->GetTransform().TranslateMore(-correction * b2.invMass);
+		}
+
+		for (auto& b : mBodies) {
+			if (b.invMass == 0)
+				continue;
+			RigidBody* body = b.component->GetRigidBody();
+			body->SetVelocity(b.velocity);
+			body->SetAngularVelocity(b.angularVelocity);
+		}
+	}
+
+}
@@ -0,0 +1,131 @@
+#ifndef __CONTACT_SOLVER_H__
+#define __CONTACT_SOLVER_H__
+
+#include <vector>
+#include <unordered_map>
+#include "core.h"
+#include "IUncopiable.hpp"
+#include "ContactManifold.h"
+
+namespace sark {
+
+	class ASceneComponent;
+	class RigidBody;
+
+	// sequential impulse solver of the contacts of a frame.
+	// the points of the manifolds are gathered into an array of
+	// constraints, whose effective masses and the world inverse inertia
+	// of the bodies are computed once. the velocity constraints are
+	// solved by the given number of iterations, and each constraint
+	// clamps its accumulated impulse instead of the impulse of an
+	// iteration. the solving starts from the impulses of the last frame,
+	// which are kept in the manifolds. (warm starting)
+	// the penetrations are corrected by moving the bodies apart by their
+	// inverse masses, after the velocities.
+	//   solver.Clear();
+	//   solver.AddManifold(comp1, comp2, manifold);
+	//   solver.Solve(restitution, friction);
+	class ContactSolver : public IUncopiable {
+	public:
+		// the number of velocity iterations by default.
+		static const uinteger DEFAULT_ITERATIONS = 8;
+
+		// the penetration which is allowed, so the resting contacts
+		// are kept touching.
+		static const real PENETRATION_SLOP;
+
+		// the rate of the penetration corrected on a frame.
+		static const real PENETRATION_CORRECTION;
+
+		// the approaching velocity under it does not bounce.
+		static const real RESTITUTION_VELOCITY;
+
+	private:
+		// velocities of a body while solving. the sleeping and the
+		// fixed bodies have no inverse mass, so they do not move.
+		struct BodyState {
+			ASceneComponent* component;
+			Vector3 velocity;
+			Vector3 angularVelocity;
+			real invMass;
+			Matrix3 invI;
+		};
+
+		// a point of the manifolds.
+		struct Constraint {
+			uinteger body1, body2;
+			Vector3 normal;
+			Vector3 tangent[2];
+
+			// from the centers of mass to the point.
+			Vector3 r1, r2;
+
+			// inverse of the effective masses along the normal and the tangents.
+			real normalMass;
+			real tangentMass[2];
+
+			// target velocity along the normal, for the restitution.
+			real bias;
+
+			// accumulated impulses.
+			real normalImpulse;
+			real tangentImpulse[2];
+
+			// the impulses are stored back to it.
+			ContactManifold::Point* point;
+		};
+
+		// the deepest penetration of a manifold.
+		struct Penetration {
+			uinteger body1, body2;
+			Vector3 normal;
+			real depth;
+		};
+
+		std::vector<BodyState> mBodies;
+		std::unordered_map<const RigidBody*, uinteger> mBodyIndices;
+		std::vector<Constraint> mConstraints;
+		std::vector<Penetration> mPenetrations;
+
+		uinteger mIterations;
+
+		// get index of the body state, which is added on the first time.
+		uinteger AddBody(ASceneComponent* component);
+
+		// apply the impulse at the points of the constraint.
+		void ApplyImpulse(const Constraint& c, const Vector3& impulse);
+
+	public:
+		ContactSolver();
+
+		// get the number of velocity iterations.
+		uinteger GetIterations() const;
+
+		// set the number of velocity iterations.
+		// the more iterations make the stacks stiffer, and take the
+		// more time. (DEFAULT_ITERATIONS by default)
+		void SetIterations(uinteger iterations);
+
+		// remove all contacts.
+		void Clear();
+
+		// add the points of the manifold.
+		// the manifold has to be alive until Solve, since the impulses
+		// are stored back to its points.
+		// *param:
+		//     comp1,comp2 - the components of the pair. they have rigid body.
+		//     manifold    - contact manifold of the pair. its normal
+		//                   points from the second to the first.
+		void AddManifold(ASceneComponent* comp1, ASceneComponent* comp2,
+			ContactManifold& manifold);
+
+		// solve the contacts, and apply the velocities and the corrections
+		// of the penetrations to the bodies.
+		// *param:
+		//     restitution - coefficient of restitution.
+		//     friction    - coefficient of friction.
+		void Solve(real restitution, real friction);
+	};
+
+}
+#endif
@@ -1,23 +1,32 @@
 #include "ConvexHull.h"
 #include "ASceneComponent.h"
-#include "GJK_EPA.h"
+#include "tools.h"
 
 namespace sark {
 
 	// convex hull
 	ConvexHull::ConvexHull(ASceneComponent* reference)
-		: ACollider(reference) {}
+		: ACollider(reference), mWorldMatrix(1.f),
+		mLocalMin(0.f), mLocalMax(0.f) {}
 
 	ConvexHull::ConvexHull(ASceneComponent* reference,
 		const PointSet& points)
 		: ACollider(reference),
-		mPoints(points), mTransPoints(points) {}
+		mPoints(points), mWorldMatrix(1.f)
+	{
+		ComputeLocalBounds();
+	}
 
 	ConvexHull::ConvexHull(ASceneComponent* reference,
 		const PointSet& points,
 		const FaceSet& faces)
 		: ACollider(reference),
-		mPoints(points), mTransPoints(points), mFaces(faces) {}
+		mPoints(points), mWorldMatrix(1.f), mFaces(faces)
+	{
+		ComputeLocalBounds();
+		BuildAdjacency();
+		BuildPolygons();
+	}
 
 	ConvexHull::~ConvexHull() {}
 
@@ -26,9 +35,24 @@ namespace sark {
 		return mPoints;
 	}
 
-	// get transformed point set.
-	const ConvexHull::PointSet& ConvexHull::GetTransPointSet() const {
-		return mTransPoints;
+	// get world transform of the last update.
+	const Matrix4& ConvexHull::GetWorldMatrix() const {
+		return mWorldMatrix;
+	}
+
+	// get the number of points.
+	uinteger ConvexHull::GetVertexCount() const {
+		return mPoints.size();
+	}
+
+	// get world space position of a point by the last update.
+	const Vector3 ConvexHull::GetWorldPoint(uinteger index) const {
+		const Matrix4& M = mWorldMatrix;
+		const Vector3& P = mPoints[index];
+		return Vector3(
+			M.m[0][0] * P.x + M.m[0][1] * P.y + M.m[0][2] * P.z + M.m[0][3],
+			M.m[1][0] * P.x + M.m[1][1] * P.y + M.m[1][2] * P.z + M.m[1][3],
+			M.m[2][0] * P.x + M.m[2][1] * P.y + M.m[2][2] * P.z + M.m[2][3]);
 	}
 
 	// get triangle face set.
@@ -36,36 +60,203 @@ namespace sark {
 		return mFaces;
 	}
 
+	// get polygon set.
+	const ConvexHull::PolygonSet& ConvexHull::GetPolygonSet() const {
+		return mPolygons;
+	}
+
+	// get vertex indices of the polygons.
+	const std::vector<uint16>& ConvexHull::GetPolygonIndices() const {
+		return mPolygonIndices;
+	}
+
 	// get type
 	const ACollider::Type ConvexHull::GetType() const {
 		return ACollider::CONVEXHULL;
 	}
 
-	// intersection test with given shape.
-	// *note: it does not generate any collision
-	// informations then just test the intersection.
-	bool ConvexHull::IntersectWith(const ACollider* coll) const {
-		switch (coll->GetType()) {
-		case ACollider::SPHERE:
-			break;
-		case ACollider::AABOX:
-			break;
-		case ACollider::OBOX:
-			break;
-		case ACollider::CONVEXHULL:
-			return GJK_EPA::DoGJK(this, reinterpret_cast<const ConvexHull*>(coll), NULL);
+	// build vertex adjacency for hill climbing.
+	void ConvexHull::BuildAdjacency() {
+		if (mPoints.size() <= HILLCLIMB_MIN_POINTS || mFaces.empty())
+			return;
+		tool::BuildVertexAdjacency(mFaces, mPoints.size(), mAdjOffsets, mAdjacency);
+	}
+
+	// merge the coplanar triangles into polygons.
+	// the faces of a convex hull which have the same normal are on the
+	// same plane, so they are grouped by the normal. the boundary of a
+	// group is the edges whose reverse is not in the group, and they are
+	// chained into the vertex loop of the polygon.
+	void ConvexHull::BuildPolygons() {
+		const real NORMAL_TOLERANCE = 0.0001f;
+		const uinteger faceCount = mFaces.size();
+
+		// area weighted and unit normals of the faces.
+		std::vector<Vector3> areaNormals(faceCount), normals(faceCount);
+		for (uinteger i = 0; i < faceCount; i++) {
+			const Vector3& A = mPoints[mFaces[i].a];
+			areaNormals[i] = (mPoints[mFaces[i].b] - A).Cross(mPoints[mFaces[i].c] - A);
+			const real length = areaNormals[i].Magnitude();
+			normals[i] = (length > 0 ? areaNormals[i] / length : Vector3(0.f));
+		}
+
+		std::vector<bool> grouped(faceCount, false);
+		std::vector<uinteger> group;
+		std::vector<std::pair<uint16, uint16>> edges;
+		for (uinteger i = 0; i < faceCount; i++) {
+			if (grouped[i] || normals[i] == Vector3(0.f))
+				continue;
+
+			group.clear();
+			Vector3 normal(0.f);
+			for (uinteger j = i; j < faceCount; j++) {
+				if (!grouped[j] && normals[i].Dot(normals[j]) > 1.f - NORMAL_TOLERANCE) {
+					grouped[j] = true;
+					group.push_back(j);
+					normal += areaNormals[j];
+				}
+			}
+
+			// boundary edges.
+			edges.clear();
+			for (auto f : group) {
+				for (uinteger k = 0; k < 3; k++) {
+					const uint16 from = mFaces[f].idx[k];
+					const uint16 to = mFaces[f].idx[(k + 1) % 3];
+					bool inner = false;
+					for (auto g : group) {
+						for (uinteger l = 0; l < 3 && !inner; l++)
+							inner = (mFaces[g].idx[l] == to && mFaces[g].idx[(l + 1) % 3] == from);
+						if (inner)
+							break;
+					}
+					if (!inner)
+						edges.push_back(std::make_pair(from, to));
+				}
+			}
+
+			if (edges.empty())
+				continue;
+
+			// chain the edges from the first one.
+			Polygon polygon;
+			polygon.normal = normal.Normal();
+			polygon.begin = mPolygonIndices.size();
+			polygon.count = 0;
+			uint16 cur = edges[0].first;
+			for (uinteger n = 0; n < edges.size(); n++) {
+				uinteger e = 0;
+				while (e < edges.size() && edges[e].first != cur)
+					e++;
+				if (e == edges.size())
+					break;
+				mPolygonIndices.push_back(cur);
+				polygon.count++;
+				cur = edges[e].second;
+				if (cur == edges[0].first)
+					break;
+			}
+
+			if (cur != edges[0].first || polygon.count != edges.size()) {
+				// the boundary is not a simple loop. (the welded points can
+				// make it) the triangles are kept as they are.
+				mPolygonIndices.resize(polygon.begin);
+				for (auto f : group) {
+					polygon.normal = normals[f];
+					polygon.begin = mPolygonIndices.size();
+					polygon.count = 3;
+					for (uinteger k = 0; k < 3; k++)
+						mPolygonIndices.push_back(mFaces[f].idx[k]);
+					mPolygons.push_back(polygon);
+				}
+				continue;
+			}
+			mPolygons.push_back(polygon);
+		}
+	}
+
+	// compute object space bounding box.
+	void ConvexHull::ComputeLocalBounds() {
+		mLocalMin = mLocalMax = (mPoints.empty() ? Vector3(0.f) : mPoints[0]);
+		for (uinteger i = 1; i < mPoints.size(); i++) {
+			for (uinteger a = 0; a < 3; a++) {
+				mLocalMin.v[a] = math::min(mLocalMin.v[a], mPoints[i].v[a]);
+				mLocalMax.v[a] = math::max(mLocalMax.v[a], mPoints[i].v[a]);
+			}
 		}
-		return false;
 	}
 
-	// update points through given transform matrix.
-	// transMat is usually world transform.
-	void ConvexHull::Update() {
-		const Matrix4& transMat = mReference->GetTransform().GetMatrix();
-		uinteger sz = mPoints.size();
-		for (uinteger i = 0; i < sz; i++) {
-			mTransPoints[i] = (transMat * Vector4(mPoints[i], 1.f)).xyz;
+	// get the farthest point in given world direction.
+	const Vector3 ConvexHull::CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const {
+		const Matrix4& M = mWorldMatrix;
+
+		// dot(d, M*P) = dot(transpose(A)*d, P) + const,
+		// where A is the upper 3x3 part of M.
+		Vector3 localDir(
+			M.m[0][0] * direction.x + M.m[1][0] * direction.y + M.m[2][0] * direction.z,
+			M.m[0][1] * direction.x + M.m[1][1] * direction.y + M.m[2][1] * direction.z,
+			M.m[0][2] * direction.x + M.m[1][2] * direction.y + M.m[2][2] * direction.z);
+		uinteger idx;
+		if (mAdjacency.empty()) {
+			idx = tool::FarthestPointIndex(&mPoints[0], mPoints.size(), localDir);
+		}
+		else {
+			// start from the last result if it is a vertex of faces.
+			// (points which are not used by faces have no neighbor)
+			uinteger start = (inout_vertex != NULL ? *inout_vertex : 0);
+			if (start >= mPoints.size() || mAdjOffsets[start] == mAdjOffsets[start + 1])
+				start = mFaces[0].a;
+			idx = tool::HillClimbFarthestPoint(&mPoints[0], mPoints.size(), &mAdjOffsets[0], &mAdjacency[0], localDir, start);
+		}
+		if (inout_vertex != NULL)
+			*inout_vertex = idx;
+		return GetWorldPoint(idx);
+	}
+
+	// get the polygon whose world normal is the most parallel to given direction.
+	// the normals are transformed by the inverse transpose of the upper
+	// 3x3 part of the world matrix, which keeps them perpendicular to the
+	// polygons on the non-uniform scaling.
+	integer ConvexHull::SupportPolygon(const Vector3& direction, Vector3* out_normal) const {
+		if (mPolygons.empty())
+			return -1;
+
+		const Matrix4& M = mWorldMatrix;
+		const Matrix3 N = Matrix3(
+			M.m[0][0], M.m[0][1], M.m[0][2],
+			M.m[1][0], M.m[1][1], M.m[1][2],
+			M.m[2][0], M.m[2][1], M.m[2][2]).Inverse().Transposition();
+
+		integer best = -1;
+		real bestDot = -REAL_MAX;
+		Vector3 bestNormal;
+		const uinteger count = mPolygons.size();
+		for (uinteger i = 0; i < count; i++) {
+			const Vector3 normal = (N * mPolygons[i].normal).Normal();
+			const real d = normal.Dot(direction);
+			if (d > bestDot) {
+				bestDot = d;
+				best = (integer)i;
+				bestNormal = normal;
+			}
 		}
+		if (out_normal != NULL)
+			*out_normal = bestNormal;
+		return best;
+	}
+
+	// update world transform.
+	void ConvexHull::Update() {
+		mWorldMatrix = mReference->GetTransform().GetMatrix();
+	}
+
+	// get world space bounding box.
+	// it is the box of the transformed local box, not of the
+	// transformed points, so it is loose on rotation but cheap.
+	void ConvexHull::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		tool::TransformAABox(mWorldMatrix, mLocalMin, mLocalMax, out_min, out_max);
+		out_min -= Vector3(GetMargin());
+		out_max += Vector3(GetMargin());
 	}
 
 }
\ No newline at end of file
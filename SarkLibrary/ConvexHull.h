@@ -4,28 +4,73 @@
 #include <vector>
 #include "core.h"
 #include "ACollider.h"
+#include "ASupportShape.h"
 #include "primitives.hpp"
 
 namespace sark {
 
 	// convex hull.
 	// it can be generated by convex hull builder.
-	class ConvexHull : public ACollider {
+	// a hull of a few points with margin is the rounded shape of them.
+	// (see ASupportShape::SetMargin)
+	class ConvexHull : public ACollider, public ASupportShape {
 	public:
 		typedef std::vector<Vector3> PointSet;
 		typedef std::vector<TriangleFace16> FaceSet;
 		typedef std::vector<TriangleFace16>::const_iterator FaceIterator;
 
+		// planar face of the hull, which is the coplanar triangles of
+		// the face set merged. the contact manifold clips them.
+		struct Polygon {
+			// object space unit normal.
+			Vector3 normal;
+
+			// vertices in the polygon index set. [begin, begin + count)
+			// they are ccw order seen from outside.
+			uinteger begin;
+			uinteger count;
+		};
+		typedef std::vector<Polygon> PolygonSet;
+
 	private:
 		// point set of object space convex hull.
 		PointSet mPoints;
 
-		// transformed point set.
-		PointSet mTransPoints;
+		// world transform of the last update.
+		// the points are not transformed, the support queries
+		// are done in object space instead.
+		Matrix4 mWorldMatrix;
+
+		// object space bounding box of the points.
+		Vector3 mLocalMin;
+		Vector3 mLocalMax;
 
 		// triangle face set. it can be empty.
 		FaceSet mFaces;
 
+		// vertex adjacency from the face set, for hill climbing support search.
+		// they are empty if the hull is small or has no faces.
+		// (see tool::BuildVertexAdjacency)
+		std::vector<uinteger> mAdjOffsets;
+		std::vector<uint16> mAdjacency;
+
+		// polygons from the face set, and their vertex indices.
+		PolygonSet mPolygons;
+		std::vector<uint16> mPolygonIndices;
+
+		void BuildAdjacency();
+
+		void BuildPolygons();
+
+		void ComputeLocalBounds();
+
+	protected:
+		// get the farthest point in given direction.
+		// it finds the point in object space, and transforms only that point.
+		// the hulls with many points climb from 'inout_vertex' along the
+		// adjacency. (see HILLCLIMB_MIN_POINTS)
+		const Vector3 CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const override;
+
 	public:
 		ConvexHull(ASceneComponent* reference);
 
@@ -41,22 +86,43 @@ namespace sark {
 		// get original(not transformed) point set.
 		const PointSet& GetPointSet() const;
 
-		// get transformed point set.
-		const PointSet& GetTransPointSet() const;
+		// get world transform of the last update.
+		const Matrix4& GetWorldMatrix() const;
+
+		// get the number of points.
+		uinteger GetVertexCount() const override;
+
+		// get world space position of a point by the last update.
+		const Vector3 GetWorldPoint(uinteger index) const override;
 
 		// get triangle face set.
 		const FaceSet& GetFaceSet() const;
 
+		// get polygon set. it is empty if the hull has no faces.
+		const PolygonSet& GetPolygonSet() const;
+
+		// get vertex indices of the polygons.
+		const std::vector<uint16>& GetPolygonIndices() const;
+
 		// get type
 		const Type GetType() const override;
 
-		// intersection test with given collider.
-		// *note: it does not generate any collision
-		// informations then just test the intersection.
-		bool IntersectWith(const ACollider* coll) const override;
+		// hulls with more points than it use hill climbing for support
+		// search, and the others use linear scan.
+		static const uinteger HILLCLIMB_MIN_POINTS = 24;
+
+		// get the polygon whose world normal is the most parallel to given direction.
+		// *param:
+		//     direction  - world space search direction.
+		//     out_normal - world space unit normal of the found polygon.
+		// *return: index of the polygon, or -1 if the hull has no polygon.
+		integer SupportPolygon(const Vector3& direction, Vector3* out_normal = NULL) const;
 
 		// update convex hull.
 		void Update() override;
+
+		// get world space bounding box.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const override;
 	};
 
 }
@@ -0,0 +1,662 @@
+#include <queue>
+#include <thread>
+#include "ConvexHullBuilder.h"
+#include "Debug.h"
+#ifndef SARKLIB_HEADLESS
+#include "Mesh.h"
+#endif
+
+namespace sark {
+
+	namespace {
+
+		const uinteger NONE = (uinteger)-1;
+
+		// triangle face while building the hull.
+		// edge i is v[i] -> v[(i+1)%3], and adj[i] is the face across it.
+		struct HullFace {
+			uinteger v[3];
+			uinteger adj[3];
+			Vector3 normal;
+			real dist;
+
+			// points above the face, and the farthest one of them.
+			std::vector<uinteger> outside;
+			uinteger farthest;
+			real farthestDist;
+
+			bool deleted;
+			uinteger visit;
+
+			HullFace(uinteger a, uinteger b, uinteger c, const Vector3* points)
+				: farthest(NONE), farthestDist(0), deleted(false), visit(0)
+			{
+				v[0] = a; v[1] = b; v[2] = c;
+				adj[0] = adj[1] = adj[2] = NONE;
+				normal = (points[b] - points[a]).Cross(points[c] - points[a]);
+				real mag = normal.Magnitude();
+				if (mag > 0)
+					normal /= mag;
+				dist = normal.Dot(points[a]);
+			}
+
+			real Distance(const Vector3& p) const {
+				return normal.Dot(p) - dist;
+			}
+
+			void AddOutside(uinteger idx, real d) {
+				outside.push_back(idx);
+				if (d > farthestDist) {
+					farthestDist = d;
+					farthest = idx;
+				}
+			}
+		};
+
+		// run func(begin, end) over [0, count) by chunks on threads.
+		template<class _Func>
+		void ParallelFor(uinteger count, uinteger threadCount, _Func func) {
+			if (threadCount <= 1 || count < threadCount) {
+				func(0, count);
+				return;
+			}
+			std::vector<std::thread> threads;
+			uinteger chunk = (count + threadCount - 1) / threadCount;
+			for (uinteger begin = chunk; begin < count; begin += chunk) {
+				uinteger end = (begin + chunk < count ? begin + chunk : count);
+				threads.push_back(std::thread(func, begin, end));
+			}
+			func(0, chunk);
+			for (auto& t : threads)
+				t.join();
+		}
+
+		const uint64 EMPTY_KEY = (uint64)-1;
+
+		// pack integer cell coordinates into hash key. 21 bits for each axis.
+		inline uint64 CellKey(int64 x, int64 y, int64 z) {
+			const uint64 mask = (1ull << 21) - 1;
+			return (((uint64)x & mask) << 42) | (((uint64)y & mask) << 21) | ((uint64)z & mask);
+		}
+
+		// weld points closer than distance by hash grid.
+		// the first point of each cluster is kept, in input order.
+		void WeldPoints(const Vector3* points, uinteger count, real distance,
+			uinteger threadCount, std::vector<Vector3>& out_points)
+		{
+			out_points.clear();
+			if (distance <= 0) {
+				out_points.assign(points, points + count);
+				return;
+			}
+
+			// cell of each point. the cell size is twice the welding distance,
+			// so the neighbors are in the cell and the adjacent 7 cells on the
+			// side of the point, e.g. x-1 if it is on the lower half in x.
+			const real invCell = 1 / (2 * distance);
+			std::vector<int64> cells(count * 3);
+			std::vector<uint8> sides(count);
+			ParallelFor(count, threadCount, [&](uinteger begin, uinteger end) {
+				for (uinteger i = begin; i < end; i++) {
+					uint8 side = 0;
+					for (uinteger a = 0; a < 3; a++) {
+						real c = math::floor(points[i].v[a] * invCell);
+						cells[i * 3 + a] = (int64)c;
+						if (points[i].v[a] * invCell - c >= 0.5f)
+							side |= (1 << a);
+					}
+					sides[i] = side;
+				}
+			});
+
+			// cell key -> last kept point, chained by next.
+			// open addressing table, which is probed linearly. the hash keeps
+			// cells adjacent in z on adjacent slots, for cache locality.
+			uinteger tableSize = 64;
+			while (tableSize < count * 2)
+				tableSize <<= 1;
+			const uinteger tableMask = tableSize - 1;
+			std::vector<uint64> keys(tableSize, EMPTY_KEY);
+			std::vector<uinteger> heads(tableSize, NONE);
+			auto findSlot = [&](int64 x, int64 y, int64 z) {
+				const uint64 key = CellKey(x, y, z);
+				uinteger slot = (uinteger)(x * 73856093 + y * 19349663 + z) & tableMask;
+				while (keys[slot] != key && keys[slot] != EMPTY_KEY)
+					slot = (slot + 1) & tableMask;
+				return slot;
+			};
+
+			std::vector<uinteger> next;
+			next.reserve(count);
+			const real distSq = distance * distance;
+			for (uinteger i = 0; i < count; i++) {
+				const int64* c = &cells[i * 3];
+				bool welded = false;
+				for (uinteger n = 0; n < 8 && !welded; n++) {
+					int64 d[3];
+					for (uinteger a = 0; a < 3; a++)
+						d[a] = ((n >> a) & 1) ? (((sides[i] >> a) & 1) ? 1 : -1) : 0;
+					for (uinteger k = heads[findSlot(c[0] + d[0], c[1] + d[1], c[2] + d[2])]; k != NONE; k = next[k]) {
+						if ((out_points[k] - points[i]).MagnitudeSq() <= distSq) {
+							welded = true;
+							break;
+						}
+					}
+				}
+				if (welded)
+					continue;
+
+				uinteger slot = findSlot(c[0], c[1], c[2]);
+				keys[slot] = CellKey(c[0], c[1], c[2]);
+				next.push_back(heads[slot]);
+				heads[slot] = out_points.size();
+				out_points.push_back(points[i]);
+			}
+		}
+
+		// find the indices of initial tetrahedron.
+		// it fails if the points are degenerated into a plane.
+		bool InitialSimplex(const std::vector<Vector3>& points, real eps, uinteger out_idx[4]) {
+			const uinteger count = points.size();
+
+			// extreme points on each axis.
+			uinteger ext[6] = { 0, 0, 0, 0, 0, 0 };
+			for (uinteger i = 1; i < count; i++) {
+				for (uinteger a = 0; a < 3; a++) {
+					if (points[i].v[a] < points[ext[a * 2]].v[a])
+						ext[a * 2] = i;
+					if (points[i].v[a] > points[ext[a * 2 + 1]].v[a])
+						ext[a * 2 + 1] = i;
+				}
+			}
+
+			// the most distant pair of them.
+			real maxd = -1;
+			for (uinteger i = 0; i < 6; i++) {
+				for (uinteger j = i + 1; j < 6; j++) {
+					real d = (points[ext[i]] - points[ext[j]]).MagnitudeSq();
+					if (d > maxd) {
+						maxd = d;
+						out_idx[0] = ext[i];
+						out_idx[1] = ext[j];
+					}
+				}
+			}
+			if (maxd <= eps * eps)
+				return false;
+
+			// the farthest point from the line.
+			const Vector3& p0 = points[out_idx[0]];
+			const Vector3 line = points[out_idx[1]] - p0;
+			maxd = 0;
+			for (uinteger i = 0; i < count; i++) {
+				real d = line.Cross(points[i] - p0).MagnitudeSq();
+				if (d > maxd) {
+					maxd = d;
+					out_idx[2] = i;
+				}
+			}
+			if (maxd <= eps * eps * line.MagnitudeSq())
+				return false;
+
+			// the farthest point from the plane.
+			Vector3 n = line.Cross(points[out_idx[2]] - p0).Normal();
+			maxd = 0;
+			for (uinteger i = 0; i < count; i++) {
+				real d = math::abs(n.Dot(points[i] - p0));
+				if (d > maxd) {
+					maxd = d;
+					out_idx[3] = i;
+				}
+			}
+			if (maxd <= eps)
+				return false;
+
+			// the base face must be faced away from the apex.
+			if (n.Dot(points[out_idx[3]] - p0) > 0)
+				std::swap(out_idx[1], out_idx[2]);
+			return true;
+		}
+
+		// find the edge a -> b in face f.
+		uinteger FindEdge(const HullFace& f, uinteger a, uinteger b) {
+			for (uinteger k = 0; k < 3; k++) {
+				if (f.v[k] == a && f.v[(k + 1) % 3] == b)
+					return k;
+			}
+			return NONE;
+		}
+
+		// whether the edge between a and b exists, by walking around a from face f.
+		bool HasEdge(const std::vector<HullFace>& faces, uinteger f, uinteger a, uinteger b) {
+			uinteger cur = f;
+			for (uinteger n = 0; n < faces.size(); n++) {
+				const HullFace& face = faces[cur];
+				uinteger k = 0;
+				while (face.v[k] != a)
+					k++;
+				if (face.v[(k + 1) % 3] == b || face.v[(k + 2) % 3] == b)
+					return true;
+				cur = face.adj[(k + 2) % 3];
+				if (cur == f)
+					break;
+			}
+			return false;
+		}
+
+		// doubled area vector of triangle in double precision.
+		void AreaVector(const Vector3& a, const Vector3& b, const Vector3& c, real_d out_n[3]) {
+			const real_d u[3] = { (real_d)b.x - a.x, (real_d)b.y - a.y, (real_d)b.z - a.z };
+			const real_d w[3] = { (real_d)c.x - a.x, (real_d)c.y - a.y, (real_d)c.z - a.z };
+			out_n[0] = u[1] * w[2] - u[2] * w[1];
+			out_n[1] = u[2] * w[0] - u[0] * w[2];
+			out_n[2] = u[0] * w[1] - u[1] * w[0];
+		}
+
+		// whether d is above the plane of (a, b, c) beyond the rounding error.
+		// the differences of float points are exact in double precision,
+		// and the error bound of the products is the one of orient3d filter.
+		bool IsAbove(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d) {
+			const real_d u[3] = { (real_d)b.x - a.x, (real_d)b.y - a.y, (real_d)b.z - a.z };
+			const real_d w[3] = { (real_d)c.x - a.x, (real_d)c.y - a.y, (real_d)c.z - a.z };
+			const real_d t[3] = { (real_d)d.x - a.x, (real_d)d.y - a.y, (real_d)d.z - a.z };
+			real_d vol = 0, bound = 0;
+			for (uinteger i = 0; i < 3; i++) {
+				const uinteger j = (i + 1) % 3, k = (i + 2) % 3;
+				vol += (u[j] * w[k] - u[k] * w[j]) * t[i];
+				bound += (math::abs(u[j] * w[k]) + math::abs(u[k] * w[j])) * math::abs(t[i]);
+			}
+			return vol > 8 * math::EPSILON_d * bound;
+		}
+
+		// make the hull convex by flipping its concave edges.
+		// the faces are built with the tolerance, so a face can be tilted
+		// by it against its neighbor. the tilt is tiny for fat faces, but
+		// the plane of a sliver face can go out far from the hull.
+		// for the edge a -> b of (a, b, c) and (b, a, d), the flip makes
+		// (c, a, d) and (d, b, c), which merges the tetrahedron on the
+		// concave side. the volume only grows, so it ends, and the points
+		// inside stay inside.
+		void FlipConcaveEdges(std::vector<HullFace>& faces, const Vector3* P) {
+			std::vector<uinteger> stack;
+			for (uinteger f = 0; f < faces.size(); f++) {
+				if (!faces[f].deleted)
+					stack.push_back(f);
+			}
+			while (!stack.empty()) {
+				const uinteger f = stack.back();
+				stack.pop_back();
+				if (faces[f].deleted)
+					continue;
+				for (uinteger e = 0; e < 3; e++) {
+					const uinteger g = faces[f].adj[e];
+					const uinteger a = faces[f].v[e];
+					const uinteger b = faces[f].v[(e + 1) % 3];
+					const uinteger c = faces[f].v[(e + 2) % 3];
+					const uinteger ge = FindEdge(faces[g], b, a);
+					const uinteger d = faces[g].v[(ge + 2) % 3];
+					if (!IsAbove(P[a], P[b], P[c], P[d]) || HasEdge(faces, f, c, d))
+						continue;
+
+					// the new faces must face the same side as the old ones.
+					// it is not so if a or b is beneath the others, then the
+					// flip would fold the faces, and the edge is left.
+					real_d nf[3], ng[3], n1[3], n2[3];
+					AreaVector(P[a], P[b], P[c], nf);
+					AreaVector(P[b], P[a], P[d], ng);
+					AreaVector(P[c], P[a], P[d], n1);
+					AreaVector(P[d], P[b], P[c], n2);
+					const real_d sum[3] = { nf[0] + ng[0], nf[1] + ng[1], nf[2] + ng[2] };
+					if (n1[0] * sum[0] + n1[1] * sum[1] + n1[2] * sum[2] <= 0
+						|| n2[0] * sum[0] + n2[1] * sum[1] + n2[2] * sum[2] <= 0)
+						continue;
+
+					const uinteger fBC = faces[f].adj[(e + 1) % 3];
+					const uinteger fCA = faces[f].adj[(e + 2) % 3];
+					const uinteger gAD = faces[g].adj[(ge + 1) % 3];
+					const uinteger gDB = faces[g].adj[(ge + 2) % 3];
+					faces[f] = HullFace(c, a, d, P);
+					faces[f].adj[0] = fCA;
+					faces[f].adj[1] = gAD;
+					faces[f].adj[2] = g;
+					faces[g] = HullFace(d, b, c, P);
+					faces[g].adj[0] = gDB;
+					faces[g].adj[1] = fBC;
+					faces[g].adj[2] = f;
+					faces[gAD].adj[FindEdge(faces[gAD], d, a)] = f;
+					faces[fBC].adj[FindEdge(faces[fBC], c, b)] = g;
+
+					stack.push_back(f);
+					stack.push_back(g);
+					stack.push_back(fCA);
+					stack.push_back(gAD);
+					stack.push_back(gDB);
+					stack.push_back(fBC);
+					break;
+				}
+			}
+		}
+
+	}
+
+	ConvexHullBuilder::ConvexHullBuilder()
+		: mWeldDistance(0.0001f), mMaxVertices(0), mThreadCount(0) {}
+
+	// set welding distance.
+	void ConvexHullBuilder::SetWeldDistance(real distance) {
+		mWeldDistance = distance;
+	}
+
+	// set maximum number of hull vertices.
+	void ConvexHullBuilder::SetMaxVertices(uinteger count) {
+		ONLYDBG_CODEBLOCK(
+		if (count != 0 && count < 4)
+			LogWarn("maximum number of hull vertices is less than 4, 4 is used instead.");
+		);
+		mMaxVertices = count;
+	}
+
+	// set the number of threads for large inputs.
+	void ConvexHullBuilder::SetThreadCount(uinteger count) {
+		mThreadCount = count;
+	}
+
+	// build convex hull of given points.
+	bool ConvexHullBuilder::Build(const PointSet& points) {
+		return Build(points.empty() ? NULL : &points[0], points.size());
+	}
+
+	// build convex hull of given points.
+	bool ConvexHullBuilder::Build(const Vector3* points, uinteger count) {
+		mPoints.clear();
+		mFaces.clear();
+
+		uinteger threadCount = 1;
+		if (count >= PARALLEL_MIN_POINTS) {
+			threadCount = mThreadCount;
+			if (threadCount == 0)
+				threadCount = std::thread::hardware_concurrency();
+		}
+
+		std::vector<Vector3> welded;
+		WeldPoints(points, count, mWeldDistance, threadCount, welded);
+		if (welded.size() < 4) {
+			LogWarn("too few points to build convex hull.");
+			return false;
+		}
+		const uinteger pointCount = welded.size();
+		const Vector3* P = &welded[0];
+
+		// tolerance of coplanarity, which is scaled to the extents of points.
+		// it is not less than the rounding error of the coordinates, for
+		// the points far from the origin.
+		Vector3 minP = P[0], maxP = P[0];
+		for (uinteger i = 1; i < pointCount; i++) {
+			for (uinteger a = 0; a < 3; a++) {
+				minP.v[a] = math::min(minP.v[a], P[i].v[a]);
+				maxP.v[a] = math::max(maxP.v[a], P[i].v[a]);
+			}
+		}
+		real extent = 0, maxAbs = 0;
+		for (uinteger a = 0; a < 3; a++) {
+			extent += maxP.v[a] - minP.v[a];
+			maxAbs += math::max(math::abs(minP.v[a]), math::abs(maxP.v[a]));
+		}
+		const real eps = 3 * math::max(extent, maxAbs) * math::EPSILON;
+
+		uinteger s[4];
+		if (!InitialSimplex(welded, eps, s)) {
+			LogWarn("points are degenerated into a plane.");
+			return false;
+		}
+
+		// initial tetrahedron. the base (s0, s1, s2) is faced away from s3.
+		std::vector<HullFace> faces;
+		faces.push_back(HullFace(s[0], s[1], s[2], P));
+		faces.push_back(HullFace(s[0], s[3], s[1], P));
+		faces.push_back(HullFace(s[1], s[3], s[2], P));
+		faces.push_back(HullFace(s[2], s[3], s[0], P));
+		for (uinteger f = 0; f < 4; f++) {
+			for (uinteger e = 0; e < 3; e++) {
+				uinteger a = faces[f].v[e], b = faces[f].v[(e + 1) % 3];
+				for (uinteger g = 0; g < 4; g++) {
+					for (uinteger k = 0; k < 3; k++) {
+						if (faces[g].v[k] == b && faces[g].v[(k + 1) % 3] == a)
+							faces[f].adj[e] = g;
+					}
+				}
+			}
+		}
+
+		// assign each point to the face it is the farthest above.
+		std::vector<uinteger> owner(pointCount, NONE);
+		std::vector<real> ownerDist(pointCount, 0);
+		ParallelFor(pointCount, threadCount, [&](uinteger begin, uinteger end) {
+			for (uinteger i = begin; i < end; i++) {
+				if (i == s[0] || i == s[1] || i == s[2] || i == s[3])
+					continue;
+				real maxd = eps;
+				for (uinteger f = 0; f < 4; f++) {
+					real d = faces[f].Distance(P[i]);
+					if (d > maxd) {
+						maxd = d;
+						owner[i] = f;
+					}
+				}
+				ownerDist[i] = maxd;
+			}
+		});
+		for (uinteger i = 0; i < pointCount; i++) {
+			if (owner[i] != NONE)
+				faces[owner[i]].AddOutside(i, ownerDist[i]);
+		}
+
+		// faces which have outside points, by the farthest distance.
+		// the entries of deleted or changed faces are skipped on pop.
+		typedef std::pair<real, uinteger> QueueEntry;
+		std::priority_queue<QueueEntry> queue;
+		for (uinteger f = 0; f < 4; f++) {
+			if (faces[f].farthest != NONE)
+				queue.push(QueueEntry(faces[f].farthestDist, f));
+		}
+
+		// vertex -> new face starting/ending at it on the horizon.
+		std::vector<uinteger> edgeStart(pointCount, NONE);
+		std::vector<uinteger> edgeEnd(pointCount, NONE);
+
+		std::vector<uinteger> stack, visible, newFaces, orphans;
+		struct HorizonEdge { uinteger a, b, face, edge; };
+		std::vector<HorizonEdge> horizon;
+
+		const uinteger maxVertices = (mMaxVertices == 0 ? NONE : (mMaxVertices < 4 ? 4 : mMaxVertices));
+		uinteger vertexCount = 4;
+		uinteger visit = 0;
+		while (vertexCount < maxVertices) {
+			// the face which has the farthest outside point of all.
+			// it refines the hull from the largest error, so the reduced
+			// hull by maxVertices is as close as possible to the full one.
+			uinteger top = NONE;
+			while (!queue.empty() && top == NONE) {
+				const QueueEntry& q = queue.top();
+				const HullFace& f = faces[q.second];
+				if (!f.deleted && f.farthest != NONE && f.farthestDist == q.first)
+					top = q.second;
+				queue.pop();
+			}
+			if (top == NONE)
+				break;
+			const uinteger eye = faces[top].farthest;
+			const Vector3& eyePt = P[eye];
+
+			// collect faces visible from the eye and the horizon around them.
+			visit++;
+			visible.clear();
+			horizon.clear();
+			stack.clear();
+			stack.push_back(top);
+			faces[top].visit = visit;
+			while (!stack.empty()) {
+				uinteger f = stack.back();
+				stack.pop_back();
+				visible.push_back(f);
+				for (uinteger e = 0; e < 3; e++) {
+					uinteger n = faces[f].adj[e];
+					if (faces[n].visit == visit)
+						continue;
+					if (faces[n].Distance(eyePt) > eps) {
+						faces[n].visit = visit;
+						stack.push_back(n);
+					}
+					else {
+						HorizonEdge h;
+						h.a = faces[f].v[e];
+						h.b = faces[f].v[(e + 1) % 3];
+						h.face = n;
+						h.edge = NONE;
+						for (uinteger k = 0; k < 3; k++) {
+							if (faces[n].v[k] == h.b)
+								h.edge = k;
+						}
+						horizon.push_back(h);
+					}
+				}
+			}
+
+			// the horizon must be a simple loop. it can be broken only by
+			// numerical error of nearly coplanar faces, the eye is skipped then.
+			bool simple = true;
+			for (auto& h : horizon) {
+				if (edgeStart[h.a] != NONE) {
+					simple = false;
+					break;
+				}
+				edgeStart[h.a] = 0;
+			}
+			for (auto& h : horizon)
+				edgeStart[h.a] = NONE;
+			if (!simple) {
+				HullFace& t = faces[top];
+				for (uinteger k = 0; k < t.outside.size(); k++) {
+					if (t.outside[k] == eye) {
+						t.outside[k] = t.outside.back();
+						t.outside.pop_back();
+						break;
+					}
+				}
+				t.farthest = NONE;
+				t.farthestDist = 0;
+				for (uinteger k = 0; k < t.outside.size(); k++) {
+					real d = t.Distance(P[t.outside[k]]);
+					if (d > t.farthestDist) {
+						t.farthestDist = d;
+						t.farthest = t.outside[k];
+					}
+				}
+				if (t.farthest != NONE)
+					queue.push(QueueEntry(t.farthestDist, top));
+				continue;
+			}
+
+			// cone of new faces from the horizon to the eye.
+			newFaces.clear();
+			for (auto& h : horizon) {
+				uinteger f = faces.size();
+				faces.push_back(HullFace(h.a, h.b, eye, P));
+				faces[f].adj[0] = h.face;
+				faces[h.face].adj[h.edge] = f;
+				edgeStart[h.a] = f;
+				edgeEnd[h.b] = f;
+				newFaces.push_back(f);
+			}
+			for (auto f : newFaces) {
+				HullFace& nf = faces[f];
+				nf.adj[1] = edgeStart[nf.v[1]];
+				nf.adj[2] = edgeEnd[nf.v[0]];
+			}
+			for (auto& h : horizon) {
+				edgeStart[h.a] = NONE;
+				edgeEnd[h.b] = NONE;
+			}
+
+			// reassign the outside points of the visible faces.
+			orphans.clear();
+			for (auto f : visible) {
+				faces[f].deleted = true;
+				orphans.insert(orphans.end(), faces[f].outside.begin(), faces[f].outside.end());
+				std::vector<uinteger>().swap(faces[f].outside);
+			}
+			for (auto i : orphans) {
+				if (i == eye)
+					continue;
+				real maxd = eps;
+				uinteger best = NONE;
+				for (auto f : newFaces) {
+					real d = faces[f].Distance(P[i]);
+					if (d > maxd) {
+						maxd = d;
+						best = f;
+					}
+				}
+				if (best != NONE)
+					faces[best].AddOutside(i, maxd);
+			}
+			for (auto f : newFaces) {
+				if (faces[f].farthest != NONE)
+					queue.push(QueueEntry(faces[f].farthestDist, f));
+			}
+			vertexCount++;
+		}
+		FlipConcaveEdges(faces, P);
+
+		// compact the vertices used by the hull.
+		std::vector<uinteger> remap(pointCount, NONE);
+		for (auto& f : faces) {
+			if (f.deleted)
+				continue;
+			TriangleFace16 tri;
+			for (uinteger k = 0; k < 3; k++) {
+				uinteger& r = remap[f.v[k]];
+				if (r == NONE) {
+					r = mPoints.size();
+					mPoints.push_back(P[f.v[k]]);
+				}
+				tri.idx[k] = (uint16)r;
+			}
+			mFaces.push_back(tri);
+		}
+		if (mPoints.size() > 65536) {
+			LogWarn("convex hull has too many vertices for 16 bit indices.");
+			mPoints.clear();
+			mFaces.clear();
+			return false;
+		}
+		return true;
+	}
+
+#ifndef SARKLIB_HEADLESS
+	// build convex hull of position attribute of given mesh.
+	bool ConvexHullBuilder::Build(Mesh* mesh) {
+		ArrayBuffer::AttributeAccessor<Position3> poss
+			= mesh->GetArrayBuffer().GetAttributeAccessor<Position3>(AttributeSemantic::POSITION);
+		if (poss.Empty()) {
+			LogWarn("mesh has no position attribute.");
+			return false;
+		}
+		PointSet points(poss.Count());
+		for (uinteger i = 0; i < points.size(); i++)
+			points[i] = poss[i];
+		return Build(points);
+	}
+#endif
+
+	// get point set of the last built hull.
+	const ConvexHullBuilder::PointSet& ConvexHullBuilder::GetPointSet() const {
+		return mPoints;
+	}
+
+	// get triangle faces of the last built hull.
+	const ConvexHullBuilder::FaceSet& ConvexHullBuilder::GetFaceSet() const {
+		return mFaces;
+	}
+
+}
@@ -0,0 +1,80 @@
+#ifndef __CONVEX_HULL_BUILDER_H__
+#define __CONVEX_HULL_BUILDER_H__
+
+#include <vector>
+#include "core.h"
+#include "primitives.hpp"
+
+namespace sark {
+
+	class Mesh;
+
+	// convex hull builder by quickhull algorithm.
+	// it welds the near-duplicate input points first, and then
+	// computes the minimal point set and triangle faces of the hull.
+	// the results are used to make ConvexHull collider.
+	//   builder.Build(mesh);
+	//   new ConvexHull(comp, builder.GetPointSet(), builder.GetFaceSet());
+	class ConvexHullBuilder {
+	public:
+		typedef std::vector<Vector3> PointSet;
+		typedef std::vector<TriangleFace16> FaceSet;
+
+		// inputs with more points than it are processed by multiple threads.
+		static const uinteger PARALLEL_MIN_POINTS = 16384;
+
+	private:
+		// points closer than it are welded into one.
+		real mWeldDistance;
+
+		// maximum number of hull vertices. 0 means no limit.
+		uinteger mMaxVertices;
+
+		// the number of threads for large inputs. 0 means hardware concurrency.
+		uinteger mThreadCount;
+
+		// built hull.
+		PointSet mPoints;
+		FaceSet mFaces;
+
+	public:
+		ConvexHullBuilder();
+
+		// set welding distance. it is 0.0001 by default.
+		// non-positive value disables welding.
+		void SetWeldDistance(real distance);
+
+		// set maximum number of hull vertices.
+		// the hull is refined from the farthest point, so it stops with
+		// the shape which is the closest one to full hull as possible.
+		// *note: the reduced hull is inside of the full hull.
+		// it should be 4 or more, 0 means no limit. (default)
+		void SetMaxVertices(uinteger count);
+
+		// set the number of threads for large inputs.
+		// 0 means hardware concurrency. (default)
+		void SetThreadCount(uinteger count);
+
+		// build convex hull of given points.
+		// it fails if the points are less than 4 after welding,
+		// or all of them are on a plane.
+		bool Build(const PointSet& points);
+
+		// build convex hull of given points.
+		bool Build(const Vector3* points, uinteger count);
+
+#ifndef SARKLIB_HEADLESS
+		// build convex hull of position attribute of given mesh.
+		bool Build(Mesh* mesh);
+#endif
+
+		// get point set of the last built hull.
+		const PointSet& GetPointSet() const;
+
+		// get triangle faces of the last built hull.
+		// they are counter-clockwise order from the outside.
+		const FaceSet& GetFaceSet() const;
+	};
+
+}
+#endif
@@ -1,5 +1,7 @@
 #include "Debug.h"
-#include <GL/glew.h>
+#ifndef SARKLIB_HEADLESS
+	#include <GL/glew.h>
+#endif
 
 namespace sark{
 
@@ -103,9 +105,13 @@ namespace sark{
 	}
 
 	const char* Debug::GetAPIError(){
+#ifndef SARKLIB_HEADLESS
 		GLenum err = glGetError();
 		if (err == 0)
 			return NULL;
 		return reinterpret_cast<const char*>(gluErrorString(err));
+#else
+		return NULL;
+#endif
 	}
 }
\ No newline at end of file
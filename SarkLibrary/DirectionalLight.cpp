@@ -30,6 +30,10 @@ namespace sark {
 		return NULL;
 	}
 
+	const CollisionGeometry* DirectionalLight::GetCollisionGeometry() {
+		return NULL;
+	}
+
 	RigidBody* DirectionalLight::GetRigidBody() {
 		return NULL;
 	}
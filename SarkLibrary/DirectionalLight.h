@@ -31,6 +31,8 @@ namespace sark {
 
 		Mesh* GetMesh() override;
 
+		const CollisionGeometry* GetCollisionGeometry() override;
+
 		RigidBody* GetRigidBody() override;
 	};
 
@@ -0,0 +1,405 @@
+#include "DynamicAABBTree.h"
+
+namespace sark {
+
+	namespace {
+
+		inline Vector3 MinVector(const Vector3& a, const Vector3& b) {
+			return Vector3(math::min(a.x, b.x), math::min(a.y, b.y), math::min(a.z, b.z));
+		}
+
+		inline Vector3 MaxVector(const Vector3& a, const Vector3& b) {
+			return Vector3(math::max(a.x, b.x), math::max(a.y, b.y), math::max(a.z, b.z));
+		}
+
+	}
+
+	const real DynamicAABBTree::DEFAULT_MARGIN = 0.1f;
+	const real DynamicAABBTree::DISPLACEMENT_MULTIPLIER = 2.f;
+
+	DynamicAABBTree::DynamicAABBTree(real margin)
+		: mRoot(NULL_NODE), mFreeList(NULL_NODE), mProxyCount(0), mMargin(margin) {}
+
+	DynamicAABBTree::~DynamicAABBTree() {}
+
+	bool DynamicAABBTree::Overlap(const Vector3& amin, const Vector3& amax, const Vector3& bmin, const Vector3& bmax) {
+		return !(amin.x > bmax.x || amax.x < bmin.x ||
+			amin.y > bmax.y || amax.y < bmin.y ||
+			amin.z > bmax.z || amax.z < bmin.z);
+	}
+
+	// half of surface area. it is the cost of visiting the box.
+	real DynamicAABBTree::HalfArea(const Vector3& min, const Vector3& max) {
+		const Vector3 d = max - min;
+		return d.x*d.y + d.y*d.z + d.z*d.x;
+	}
+
+	DynamicAABBTree::ProxyID DynamicAABBTree::AllocateNode() {
+		ProxyID id;
+		if (mFreeList == NULL_NODE) {
+			id = mNodes.size();
+			mNodes.push_back(Node());
+		}
+		else {
+			id = mFreeList;
+			mFreeList = mNodes[id].parent;
+		}
+		Node& node = mNodes[id];
+		node.parent = NULL_NODE;
+		node.child1 = NULL_NODE;
+		node.child2 = NULL_NODE;
+		node.height = 0;
+		node.userData = 0;
+		node.moved = false;
+		return id;
+	}
+
+	void DynamicAABBTree::FreeNode(ProxyID node) {
+		mNodes[node].parent = mFreeList;
+		mNodes[node].height = -1;
+		mFreeList = node;
+	}
+
+	// add proxy.
+	DynamicAABBTree::ProxyID DynamicAABBTree::AddProxy(const Vector3& min, const Vector3& max, uinteger userData) {
+		const ProxyID id = AllocateNode();
+		Node& node = mNodes[id];
+		node.tightMin = min;
+		node.tightMax = max;
+		node.min = min - Vector3(mMargin);
+		node.max = max + Vector3(mMargin);
+		node.userData = userData;
+		InsertLeaf(id);
+		MarkMoved(id);
+		mProxyCount++;
+		return id;
+	}
+
+	// remove proxy. the pairs of the proxy are removed at once.
+	void DynamicAABBTree::RemoveProxy(ProxyID proxy) {
+		ONLYDBG_CODEBLOCK(
+		if (proxy >= mNodes.size() || mNodes[proxy].height != 0) {
+			LogWarn("invalid proxy");
+			return;
+		}
+		);
+		for (uinteger i = 0; i < mProxyPairs.size();) {
+			if (mProxyPairs[i].a == proxy || mProxyPairs[i].b == proxy)
+				RemovePairAt(i);
+			else
+				i++;
+		}
+		if (mNodes[proxy].moved)
+			mMoveBuffer.erase(std::find(mMoveBuffer.begin(), mMoveBuffer.end(), proxy));
+
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		mProxyCount--;
+	}
+
+	// update bounding box of proxy.
+	void DynamicAABBTree::UpdateProxy(ProxyID proxy, const Vector3& min, const Vector3& max) {
+		MoveProxy(proxy, min, max);
+	}
+
+	// update bounding box of proxy.
+	// the leaf is reinserted when the box goes out of the fat box, or the fat
+	// box is too large for the box. (e.g. fast moving body stops)
+	bool DynamicAABBTree::MoveProxy(ProxyID proxy, const Vector3& min, const Vector3& max) {
+		Node& node = mNodes[proxy];
+		const Vector3 displacement = ((min + max) - (node.tightMin + node.tightMax)) * (0.5f * DISPLACEMENT_MULTIPLIER);
+		node.tightMin = min;
+		node.tightMax = max;
+
+		// new fat box, enlarged toward the displacement.
+		Vector3 fatMin = min - Vector3(mMargin);
+		Vector3 fatMax = max + Vector3(mMargin);
+		for (uinteger a = 0; a < 3; a++) {
+			if (displacement.v[a] < 0)
+				fatMin.v[a] += displacement.v[a];
+			else
+				fatMax.v[a] += displacement.v[a];
+		}
+
+		if (min.x >= node.min.x && min.y >= node.min.y && min.z >= node.min.z &&
+			max.x <= node.max.x && max.y <= node.max.y && max.z <= node.max.z) {
+			// the box is still in the fat box. keep it unless the fat box
+			// is larger than the new one enlarged by 4 margins.
+			const Vector3 hugeMargin(4.f * mMargin);
+			const Vector3 hugeMin = fatMin - hugeMargin;
+			const Vector3 hugeMax = fatMax + hugeMargin;
+			if (node.min.x >= hugeMin.x && node.min.y >= hugeMin.y && node.min.z >= hugeMin.z &&
+				node.max.x <= hugeMax.x && node.max.y <= hugeMax.y && node.max.z <= hugeMax.z)
+				return false;
+		}
+
+		RemoveLeaf(proxy);
+		node.min = fatMin;
+		node.max = fatMax;
+		InsertLeaf(proxy);
+		MarkMoved(proxy);
+		return true;
+	}
+
+	void DynamicAABBTree::MarkMoved(ProxyID leaf) {
+		if (!mNodes[leaf].moved) {
+			mNodes[leaf].moved = true;
+			mMoveBuffer.push_back(leaf);
+		}
+	}
+
+	// change user data of proxy.
+	void DynamicAABBTree::SetUserData(ProxyID proxy, uinteger userData) {
+		mNodes[proxy].userData = userData;
+	}
+
+	// get user data of proxy.
+	uinteger DynamicAABBTree::GetUserData(ProxyID proxy) const {
+		return mNodes[proxy].userData;
+	}
+
+	// get the number of proxies.
+	uinteger DynamicAABBTree::GetProxyCount() const {
+		return mProxyCount;
+	}
+
+	// remove all proxies.
+	void DynamicAABBTree::Clear() {
+		mNodes.clear();
+		mRoot = NULL_NODE;
+		mFreeList = NULL_NODE;
+		mProxyCount = 0;
+		mMoveBuffer.clear();
+		ClearPairs();
+	}
+
+	// get fat box of proxy.
+	void DynamicAABBTree::GetFatBounds(ProxyID proxy, Vector3& out_min, Vector3& out_max) const {
+		out_min = mNodes[proxy].min;
+		out_max = mNodes[proxy].max;
+	}
+
+	// get height of the tree. empty tree is -1.
+	integer DynamicAABBTree::GetHeight() const {
+		return (mRoot == NULL_NODE ? -1 : mNodes[mRoot].height);
+	}
+
+	// insert the leaf next to the sibling which costs the least.
+	// the cost of a sibling is the area of the new parent, and the
+	// enlargements of the ancestors are inherited on the way down.
+	void DynamicAABBTree::InsertLeaf(ProxyID leaf) {
+		if (mRoot == NULL_NODE) {
+			mRoot = leaf;
+			mNodes[leaf].parent = NULL_NODE;
+			return;
+		}
+
+		const Vector3 leafMin = mNodes[leaf].min;
+		const Vector3 leafMax = mNodes[leaf].max;
+		ProxyID index = mRoot;
+		while (!mNodes[index].IsLeaf()) {
+			const Node& node = mNodes[index];
+			const real area = HalfArea(node.min, node.max);
+			const real combinedArea = HalfArea(MinVector(node.min, leafMin), MaxVector(node.max, leafMax));
+
+			// cost of making a new parent of this node and the leaf.
+			const real cost = 2.f * combinedArea;
+			// minimum cost of pushing the leaf further down.
+			const real inheritanceCost = 2.f * (combinedArea - area);
+
+			real childCost[2];
+			const ProxyID children[2] = { node.child1, node.child2 };
+			for (uinteger c = 0; c < 2; c++) {
+				const Node& child = mNodes[children[c]];
+				const real unionArea = HalfArea(MinVector(child.min, leafMin), MaxVector(child.max, leafMax));
+				childCost[c] = (child.IsLeaf() ? unionArea : unionArea - HalfArea(child.min, child.max)) + inheritanceCost;
+			}
+
+			if (cost < childCost[0] && cost < childCost[1])
+				break;
+			index = (childCost[0] < childCost[1] ? children[0] : children[1]);
+		}
+		const ProxyID sibling = index;
+
+		// new parent of the sibling and the leaf.
+		const ProxyID oldParent = mNodes[sibling].parent;
+		const ProxyID newParent = AllocateNode();
+		Node& parent = mNodes[newParent];
+		parent.parent = oldParent;
+		parent.min = MinVector(mNodes[sibling].min, leafMin);
+		parent.max = MaxVector(mNodes[sibling].max, leafMax);
+		parent.height = mNodes[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+		mNodes[sibling].parent = newParent;
+		mNodes[leaf].parent = newParent;
+
+		if (oldParent == NULL_NODE) {
+			mRoot = newParent;
+		}
+		else {
+			if (mNodes[oldParent].child1 == sibling)
+				mNodes[oldParent].child1 = newParent;
+			else
+				mNodes[oldParent].child2 = newParent;
+		}
+
+		Refit(mNodes[leaf].parent);
+	}
+
+	// remove the leaf and replace its parent with the sibling.
+	void DynamicAABBTree::RemoveLeaf(ProxyID leaf) {
+		if (leaf == mRoot) {
+			mRoot = NULL_NODE;
+			return;
+		}
+
+		const ProxyID parent = mNodes[leaf].parent;
+		const ProxyID grandParent = mNodes[parent].parent;
+		const ProxyID sibling = (mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1);
+
+		if (grandParent == NULL_NODE) {
+			mRoot = sibling;
+			mNodes[sibling].parent = NULL_NODE;
+			FreeNode(parent);
+			return;
+		}
+
+		if (mNodes[grandParent].child1 == parent)
+			mNodes[grandParent].child1 = sibling;
+		else
+			mNodes[grandParent].child2 = sibling;
+		mNodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+
+	// refit the boxes and heights from the node to the root, with rotations.
+	void DynamicAABBTree::Refit(ProxyID index) {
+		while (index != NULL_NODE) {
+			index = Balance(index);
+
+			Node& node = mNodes[index];
+			const Node& child1 = mNodes[node.child1];
+			const Node& child2 = mNodes[node.child2];
+			node.height = 1 + (child1.height > child2.height ? child1.height : child2.height);
+			node.min = MinVector(child1.min, child2.min);
+			node.max = MaxVector(child1.max, child2.max);
+
+			index = node.parent;
+		}
+	}
+
+	// rotate the node A if its subtrees are not balanced.
+	// the higher child takes the place of A, and A becomes its child.
+	// the lower grandchild under the higher child moves to A instead,
+	// so the height of the subtree decreases by one.
+	DynamicAABBTree::ProxyID DynamicAABBTree::Balance(ProxyID iA) {
+		Node& A = mNodes[iA];
+		if (A.IsLeaf() || A.height < 2)
+			return iA;
+
+		const ProxyID iB = A.child1;
+		const ProxyID iC = A.child2;
+		Node& B = mNodes[iB];
+		Node& C = mNodes[iC];
+		const integer balance = C.height - B.height;
+
+		// rotate C up, or B up symmetrically.
+		auto rotate = [&](ProxyID iUp, ProxyID iOther, bool upIsChild2) -> ProxyID {
+			Node& Up = mNodes[iUp];
+			Node& Other = mNodes[iOther];
+			const ProxyID iF = Up.child1;
+			const ProxyID iG = Up.child2;
+			Node& F = mNodes[iF];
+			Node& G = mNodes[iG];
+
+			// swap A and Up.
+			Up.child1 = iA;
+			Up.parent = A.parent;
+			A.parent = iUp;
+
+			// A's old parent should point to Up.
+			if (Up.parent != NULL_NODE) {
+				if (mNodes[Up.parent].child1 == iA)
+					mNodes[Up.parent].child1 = iUp;
+				else
+					mNodes[Up.parent].child2 = iUp;
+			}
+			else {
+				mRoot = iUp;
+			}
+
+			// the higher grandchild stays under Up, and the other goes to A.
+			const bool fIsHigher = (F.height > G.height);
+			const ProxyID iHigh = (fIsHigher ? iF : iG);
+			const ProxyID iLow = (fIsHigher ? iG : iF);
+			Node& Low = mNodes[iLow];
+			Node& High = mNodes[iHigh];
+			Up.child2 = iHigh;
+			if (upIsChild2)
+				A.child2 = iLow;
+			else
+				A.child1 = iLow;
+			Low.parent = iA;
+
+			A.min = MinVector(Other.min, Low.min);
+			A.max = MaxVector(Other.max, Low.max);
+			Up.min = MinVector(A.min, High.min);
+			Up.max = MaxVector(A.max, High.max);
+			A.height = 1 + (Other.height > Low.height ? Other.height : Low.height);
+			Up.height = 1 + (A.height > High.height ? A.height : High.height);
+			return iUp;
+		};
+
+		if (balance > 1)
+			return rotate(iC, iB, true);
+		if (balance < -1)
+			return rotate(iB, iC, false);
+		return iA;
+	}
+
+	// get the overlapping pairs of the proxy boxes.
+	// the pair set keeps all the pairs whose fat boxes overlap. a pair
+	// begins to overlap only when one of them gets a new fat box, so the
+	// queries of the moved leaves find all the new pairs.
+	const DynamicAABBTree::PairArray& DynamicAABBTree::FindPairs() {
+		for (uinteger i = 0; i < mProxyPairs.size();) {
+			const Node& A = mNodes[mProxyPairs[i].a];
+			const Node& B = mNodes[mProxyPairs[i].b];
+			if (!Overlap(A.min, A.max, B.min, B.max))
+				RemovePairAt(i);
+			else
+				i++;
+		}
+
+		for (auto id : mMoveBuffer) {
+			const Node& node = mNodes[id];
+			Query(node.min, node.max, [&](ProxyID other) {
+				// both moved pair is added by the query of the less one.
+				if (other != id && !(mNodes[other].moved && other < id))
+					AddPair(id, other);
+				return true;
+			});
+		}
+		for (auto id : mMoveBuffer)
+			mNodes[id].moved = false;
+		mMoveBuffer.clear();
+
+		// the pairs of the proxy boxes.
+		mPairs.clear();
+		for (auto& pair : mProxyPairs) {
+			const Node& A = mNodes[pair.a];
+			const Node& B = mNodes[pair.b];
+			if (Overlap(A.tightMin, A.tightMax, B.tightMin, B.tightMax)) {
+				Pair p;
+				p.a = (A.userData < B.userData ? A.userData : B.userData);
+				p.b = (A.userData < B.userData ? B.userData : A.userData);
+				mPairs.push_back(p);
+			}
+		}
+		return mPairs;
+	}
+
+}
@@ -0,0 +1,427 @@
+#ifndef __DYNAMIC_AABB_TREE_H__
+#define __DYNAMIC_AABB_TREE_H__
+
+#include <vector>
+#include <algorithm>
+#include "core.h"
+#include "ABroadphase.h"
+#include "Debug.h"
+#include "simd.hpp"
+
+namespace sark {
+
+	// dynamic bounding volume tree of axis aligned boxes.
+	// each leaf keeps a fat box, which is the proxy box enlarged by the
+	// margin and toward the displacement. the leaf is reinserted only when
+	// the box goes out of its fat box, so the small moves cost nothing.
+	// the ancestors of the changed leaf are refitted and rotated to keep
+	// the tree balanced, and the queries and ray casts visit O(log n) nodes.
+	// it also works as broad-phase which keeps the overlapping pairs.
+	//   proxy = tree.AddProxy(min, max, userData);
+	//   tree.UpdateProxy(proxy, min, max);
+	//   tree.Query(min, max, [&](ProxyID id) { ...; return true; });
+	//   tree.RayCast(pos, dir, limit, [&](ProxyID id, real limit) { ...; return limit; });
+	//   tree.RayCastPacket(pos, dir, limits, [&](ProxyID id, uinteger mask, real* limits) { ... });
+	class DynamicAABBTree : public ABroadphase {
+	public:
+		// enlargement of fat box by default.
+		static const real DEFAULT_MARGIN;
+
+		// fat box is enlarged toward the displacement multiplied by it.
+		static const real DISPLACEMENT_MULTIPLIER;
+
+		// the number of rays in a packet of RayCastPacket.
+		static const uinteger PACKET_SIZE = 4;
+
+	private:
+		static const ProxyID NULL_NODE = (ProxyID)-1;
+
+		// the maximum depth of traversal.
+		static const uinteger STACK_SIZE = 256;
+
+		struct Node {
+			// fat box. it contains the boxes of the children.
+			Vector3 min, max;
+
+			// proxy box of the leaf.
+			Vector3 tightMin, tightMax;
+
+			// parent node, or next free node.
+			ProxyID parent;
+			ProxyID child1, child2;
+
+			// leaf is 0, free node is -1.
+			integer height;
+
+			uinteger userData;
+
+			// the fat box is changed since the last FindPairs.
+			bool moved;
+
+			bool IsLeaf() const { return child1 == NULL_NODE; }
+		};
+
+		std::vector<Node> mNodes;
+		ProxyID mRoot;
+		ProxyID mFreeList;
+		uinteger mProxyCount;
+		real mMargin;
+
+		// leaves whose fat box is changed since the last FindPairs.
+		std::vector<ProxyID> mMoveBuffer;
+
+		ProxyID AllocateNode();
+		void FreeNode(ProxyID node);
+
+		void InsertLeaf(ProxyID leaf);
+		void RemoveLeaf(ProxyID leaf);
+
+		// rotate the node if its subtrees are not balanced.
+		// *return: the node which takes the place of given node.
+		ProxyID Balance(ProxyID node);
+
+		// refit the boxes and heights from the node to the root, with rotations.
+		void Refit(ProxyID node);
+
+		void MarkMoved(ProxyID leaf);
+
+		static bool Overlap(const Vector3& amin, const Vector3& amax, const Vector3& bmin, const Vector3& bmax);
+		static real HalfArea(const Vector3& min, const Vector3& max);
+
+	public:
+		DynamicAABBTree(real margin = DEFAULT_MARGIN);
+		virtual ~DynamicAABBTree();
+
+		// add proxy.
+		// *param:
+		//     min,max  - world space bounding box.
+		//     userData - value which is emitted as the pair.
+		// *return: id of the proxy.
+		virtual ProxyID AddProxy(const Vector3& min, const Vector3& max, uinteger userData);
+
+		// remove proxy. the pairs of the proxy are removed at once.
+		virtual void RemoveProxy(ProxyID proxy);
+
+		// update bounding box of proxy.
+		virtual void UpdateProxy(ProxyID proxy, const Vector3& min, const Vector3& max);
+
+		// update bounding box of proxy.
+		// *return: true if the leaf is reinserted.
+		bool MoveProxy(ProxyID proxy, const Vector3& min, const Vector3& max);
+
+		// change user data of proxy.
+		virtual void SetUserData(ProxyID proxy, uinteger userData);
+
+		// get user data of proxy.
+		virtual uinteger GetUserData(ProxyID proxy) const;
+
+		// get the number of proxies.
+		virtual uinteger GetProxyCount() const;
+
+		// remove all proxies.
+		virtual void Clear();
+
+		// get the overlapping pairs of the proxy boxes.
+		// the leaves moved since the last call query the tree for new pairs,
+		// and the pairs whose fat boxes are separated are dropped.
+		virtual const PairArray& FindPairs();
+
+		// get fat box of proxy.
+		void GetFatBounds(ProxyID proxy, Vector3& out_min, Vector3& out_max) const;
+
+		// get height of the tree. empty tree is -1.
+		integer GetHeight() const;
+
+		// visit the proxies whose fat box overlaps with given box.
+		// *param:
+		//     min,max  - world space bounding box.
+		//     callback - bool(ProxyID). returning false stops the query.
+		template<class _Callback>
+		void Query(const Vector3& min, const Vector3& max, _Callback callback) const;
+
+		// visit the proxies whose fat box intersects with the ray,
+		// from the nearer nodes.
+		// *param:
+		//     pos,dir  - the ray is pos + dir * t. (0 <= t <= limit)
+		//     limit    - limitation of the ray.
+		//     callback - real(ProxyID, real limit). it returns new limit of
+		//                the ray. the same limit continues, the smaller one
+		//                clips the ray (e.g. nearest hit), and 0 stops the cast.
+		template<class _Callback>
+		void RayCast(const Vector3& pos, const Vector3& dir, real limit, _Callback callback) const;
+
+		// visit the proxies whose fat box intersects with the moving box,
+		// from the nearer nodes. it is the ray cast on the fat boxes
+		// enlarged by the half-extention of the box.
+		// *param:
+		//     pos,ext  - center and half-extention of the box.
+		//     dir      - the box moves to pos + dir * t. (0 <= t <= limit)
+		//     limit    - limitation of the motion.
+		//     callback - real(ProxyID, real limit). (see RayCast)
+		template<class _Callback>
+		void BoxCast(const Vector3& pos, const Vector3& ext, const Vector3& dir, real limit,
+			_Callback callback) const;
+
+		// visit the proxies whose fat box intersects with any ray of the
+		// packet. the rays are tested together against each node, by the
+		// lanes of SIMD if SARKLIB_USING_SIMD, so the coherent rays
+		// (e.g. from a camera) share the traversal.
+		// *param:
+		//     pos,dir      - the rays are pos[i] + dir[i] * t.
+		//     inout_limits - limitations of the rays. the ray of 0 limit
+		//                    is not cast, to fill up the packet.
+		//     callback     - void(ProxyID, uinteger mask, real* limits).
+		//                    the bits of the mask are the rays which hit
+		//                    the fat box, and it clips their limits.
+		template<class _Callback>
+		void RayCastPacket(const Vector3 pos[PACKET_SIZE], const Vector3 dir[PACKET_SIZE],
+			real inout_limits[PACKET_SIZE], _Callback callback) const;
+	};
+
+
+	//----- template implementation of DynamicAABBTree -----//
+
+	// visit the proxies whose fat box overlaps with given box.
+	template<class _Callback>
+	void DynamicAABBTree::Query(const Vector3& min, const Vector3& max, _Callback callback) const {
+		if (mRoot == NULL_NODE)
+			return;
+
+		ProxyID stack[STACK_SIZE];
+		uinteger top = 0;
+		stack[top++] = mRoot;
+		while (top > 0) {
+			const ProxyID id = stack[--top];
+			const Node& node = mNodes[id];
+			if (!Overlap(node.min, node.max, min, max))
+				continue;
+
+			if (node.IsLeaf()) {
+				if (!callback(id))
+					return;
+			}
+			else {
+				ONLYDBG_CODEBLOCK(
+				if (top + 2 > STACK_SIZE) {
+					LogFatal("tree is too deep");
+					return;
+				}
+				);
+				stack[top++] = node.child1;
+				stack[top++] = node.child2;
+			}
+		}
+	}
+
+	// visit the proxies whose fat box intersects with the ray.
+	template<class _Callback>
+	void DynamicAABBTree::RayCast(const Vector3& pos, const Vector3& dir, real limit, _Callback callback) const {
+		BoxCast(pos, Vector3(0.f), dir, limit, callback);
+	}
+
+	// visit the proxies whose fat box intersects with the moving box.
+	// the boxes are tested by slab method, and the nearer child is visited first.
+	template<class _Callback>
+	void DynamicAABBTree::BoxCast(const Vector3& pos, const Vector3& ext, const Vector3& dir, real limit,
+		_Callback callback) const
+	{
+		if (mRoot == NULL_NODE)
+			return;
+
+		// inverse of direction. 0 component is replaced by a huge value,
+		// so the slab is passed through only if the ray is in it.
+		Vector3 invDir;
+		for (uinteger a = 0; a < 3; a++)
+			invDir.v[a] = (dir.v[a] != 0 ? 1.f / dir.v[a] : REAL_MAX);
+
+		// entering parameter of the ray, or negative if it misses the box.
+		auto enter = [&](const Node& node) -> real {
+			real t_min = 0;
+			real t_max = limit;
+			for (uinteger a = 0; a < 3; a++) {
+				real t1 = (node.min.v[a] - ext.v[a] - pos.v[a]) * invDir.v[a];
+				real t2 = (node.max.v[a] + ext.v[a] - pos.v[a]) * invDir.v[a];
+				if (t1 > t2)
+					std::swap(t1, t2);
+				if (t1 > t_min)
+					t_min = t1;
+				if (t2 < t_max)
+					t_max = t2;
+				if (t_min > t_max)
+					return -1;
+			}
+			return t_min;
+		};
+
+		struct Entry {
+			ProxyID node;
+			real t;
+		};
+		Entry stack[STACK_SIZE];
+		uinteger top = 0;
+		const real t_root = enter(mNodes[mRoot]);
+		if (t_root < 0)
+			return;
+		stack[top].node = mRoot;
+		stack[top++].t = t_root;
+
+		while (top > 0) {
+			const Entry entry = stack[--top];
+			// the ray is clipped after the node is pushed.
+			if (entry.t > limit)
+				continue;
+
+			const Node& node = mNodes[entry.node];
+			if (node.IsLeaf()) {
+				limit = callback(entry.node, limit);
+				if (limit <= 0)
+					return;
+				continue;
+			}
+
+			const real t1 = enter(mNodes[node.child1]);
+			const real t2 = enter(mNodes[node.child2]);
+			ONLYDBG_CODEBLOCK(
+			if (top + 2 > STACK_SIZE) {
+				LogFatal("tree is too deep");
+				return;
+			}
+			);
+			// push the farther one first.
+			const bool firstIsNear = (t1 >= 0 && (t2 < 0 || t1 <= t2));
+			const ProxyID nearNode = (firstIsNear ? node.child1 : node.child2);
+			const ProxyID farNode = (firstIsNear ? node.child2 : node.child1);
+			const real nearT = (firstIsNear ? t1 : t2);
+			const real farT = (firstIsNear ? t2 : t1);
+			if (farT >= 0) {
+				stack[top].node = farNode;
+				stack[top++].t = farT;
+			}
+			if (nearT >= 0) {
+				stack[top].node = nearNode;
+				stack[top++].t = nearT;
+			}
+		}
+	}
+
+	// visit the proxies whose fat box intersects with any ray of the packet.
+	// each node is tested by slab method for all the rays at once, and the
+	// child which the rays enter first is visited first.
+	template<class _Callback>
+	void DynamicAABBTree::RayCastPacket(const Vector3 pos[PACKET_SIZE], const Vector3 dir[PACKET_SIZE],
+		real inout_limits[PACKET_SIZE], _Callback callback) const
+	{
+		if (mRoot == NULL_NODE)
+			return;
+
+		// the rays as the lanes. 0 component of direction is replaced by
+		// a huge value as RayCast.
+		real px[PACKET_SIZE], py[PACKET_SIZE], pz[PACKET_SIZE];
+		real ix[PACKET_SIZE], iy[PACKET_SIZE], iz[PACKET_SIZE];
+		for (uinteger k = 0; k < PACKET_SIZE; k++) {
+			px[k] = pos[k].x; py[k] = pos[k].y; pz[k] = pos[k].z;
+			ix[k] = (dir[k].x != 0 ? 1.f / dir[k].x : REAL_MAX);
+			iy[k] = (dir[k].y != 0 ? 1.f / dir[k].y : REAL_MAX);
+			iz[k] = (dir[k].z != 0 ? 1.f / dir[k].z : REAL_MAX);
+		}
+
+		// the rays which enter the box, and the first entering parameter
+		// among them.
+#ifdef SARKLIB_USING_SIMD
+		const simd::real4 PX = simd::load(px), PY = simd::load(py), PZ = simd::load(pz);
+		const simd::real4 IX = simd::load(ix), IY = simd::load(iy), IZ = simd::load(iz);
+		const simd::real4 zero = simd::splat(0.f);
+		auto enter = [&](const Node& node, real& out_t) -> uinteger {
+			const simd::real4 limits = simd::load(inout_limits);
+			simd::real4 t1 = simd::mul(simd::sub(simd::splat(node.min.x), PX), IX);
+			simd::real4 t2 = simd::mul(simd::sub(simd::splat(node.max.x), PX), IX);
+			simd::real4 t_min = simd::max(zero, simd::min(t1, t2));
+			simd::real4 t_max = simd::min(limits, simd::max(t1, t2));
+			t1 = simd::mul(simd::sub(simd::splat(node.min.y), PY), IY);
+			t2 = simd::mul(simd::sub(simd::splat(node.max.y), PY), IY);
+			t_min = simd::max(t_min, simd::min(t1, t2));
+			t_max = simd::min(t_max, simd::max(t1, t2));
+			t1 = simd::mul(simd::sub(simd::splat(node.min.z), PZ), IZ);
+			t2 = simd::mul(simd::sub(simd::splat(node.max.z), PZ), IZ);
+			t_min = simd::max(t_min, simd::min(t1, t2));
+			t_max = simd::min(t_max, simd::max(t1, t2));
+
+			const uinteger mask = (uinteger)(~simd::movemask(simd::cmpgt(t_min, t_max))
+				& simd::movemask(simd::cmpgt(limits, zero)) & 0xf);
+			real t[PACKET_SIZE];
+			simd::store(t, t_min);
+			out_t = REAL_MAX;
+			for (uinteger k = 0; k < PACKET_SIZE; k++) {
+				if ((mask & (1 << k)) && t[k] < out_t)
+					out_t = t[k];
+			}
+			return mask;
+		};
+#else
+		auto enter = [&](const Node& node, real& out_t) -> uinteger {
+			uinteger mask = 0;
+			out_t = REAL_MAX;
+			for (uinteger k = 0; k < PACKET_SIZE; k++) {
+				if (inout_limits[k] <= 0)
+					continue;
+				real t1 = (node.min.x - px[k]) * ix[k];
+				real t2 = (node.max.x - px[k]) * ix[k];
+				real t_min = math::max((real)0, math::min(t1, t2));
+				real t_max = math::min(inout_limits[k], math::max(t1, t2));
+				t1 = (node.min.y - py[k]) * iy[k];
+				t2 = (node.max.y - py[k]) * iy[k];
+				t_min = math::max(t_min, math::min(t1, t2));
+				t_max = math::min(t_max, math::max(t1, t2));
+				t1 = (node.min.z - pz[k]) * iz[k];
+				t2 = (node.max.z - pz[k]) * iz[k];
+				t_min = math::max(t_min, math::min(t1, t2));
+				t_max = math::min(t_max, math::max(t1, t2));
+				if (t_min > t_max)
+					continue;
+				mask |= (1 << k);
+				if (t_min < out_t)
+					out_t = t_min;
+			}
+			return mask;
+		};
+#endif
+
+		ProxyID stack[STACK_SIZE];
+		uinteger top = 0;
+		real t_root;
+		if (enter(mNodes[mRoot], t_root) == 0)
+			return;
+		stack[top++] = mRoot;
+
+		while (top > 0) {
+			const ProxyID id = stack[--top];
+			const Node& node = mNodes[id];
+			if (node.IsLeaf()) {
+				// the rays are clipped after the leaf is pushed.
+				real t;
+				const uinteger mask = enter(node, t);
+				if (mask != 0)
+					callback(id, mask, inout_limits);
+				continue;
+			}
+
+			real t1, t2;
+			const uinteger mask1 = enter(mNodes[node.child1], t1);
+			const uinteger mask2 = enter(mNodes[node.child2], t2);
+			ONLYDBG_CODEBLOCK(
+			if (top + 2 > STACK_SIZE) {
+				LogFatal("tree is too deep");
+				return;
+			}
+			);
+			// push the farther one first.
+			const bool firstIsNear = (mask1 != 0 && (mask2 == 0 || t1 <= t2));
+			if ((firstIsNear ? mask2 : mask1) != 0)
+				stack[top++] = (firstIsNear ? node.child2 : node.child1);
+			if ((firstIsNear ? mask1 : mask2) != 0)
+				stack[top++] = (firstIsNear ? node.child1 : node.child2);
+		}
+	}
+
+}
+#endif
@@ -1,25 +1,218 @@
 #include "GJK_EPA.h"
+#include <algorithm>
 #include "tools.h"
-#include "ConvexHull.h"
+#include "fastmath.hpp"
+#include "ASupportShape.h"
 #include "Debug.h"
 
 namespace sark{
 
-	// ============ GJK_EPA::Face implementation ================
+	namespace {
+
+		// capacities of EPA scratch. the polytope is not expanded over them,
+		// and the closest face so far is the result.
+		const uinteger EPA_MAX_VERTICES = 64;
+		const uinteger EPA_MAX_FACES = 256;
+		const uinteger EPA_MAX_EDGES = 64;
+
+		// face of the polytope. the vertices are ccw order seen from outside.
+		struct EPAFace {
+			uinteger v[3];
+			Vector3 normal;
+			real distance;
+			bool alive;
+		};
+
+		// entry of the min-heap of faces by distance from the origin.
+		struct EPAHeapEntry {
+			real distance;
+			uinteger face;
+		};
+
+		inline bool operator<(const EPAHeapEntry& l, const EPAHeapEntry& r) {
+			// std heap is max-heap, so the order is reversed.
+			return l.distance > r.distance;
+		}
 
-	GJK_EPA::Face::Face(uinteger _a, uinteger _b, uinteger _c,
-		const Vector3& _normal, const real& _distance)
-		: a(_a), b(_b), c(_c), normal(_normal), distance(_distance){}
+		struct EPAEdge {
+			uinteger a, b;
+		};
+
+		// working memory of EPA. it is kept for each thread and reused by
+		// every call, so EPA does not allocate anything.
+		// the faces are only appended. the removed ones are marked as dead,
+		// and skipped when they come to the top of the heap.
+		struct EPAScratch {
+			Vector3 vertices[EPA_MAX_VERTICES];
+			EPAFace faces[EPA_MAX_FACES];
+			EPAHeapEntry heap[EPA_MAX_FACES];
+			EPAEdge horizon[EPA_MAX_EDGES];
+			uinteger vertexCount;
+			uinteger faceCount;
+			uinteger heapSize;
+			uinteger edgeCount;
+
+			void Reset() {
+				vertexCount = faceCount = heapSize = edgeCount = 0;
+			}
+
+			// add face of vertex a,b,c and push it into the heap.
+			// *return: false if the face is degenerate.
+			bool AddFace(uinteger a, uinteger b, uinteger c) {
+				EPAFace& face = faces[faceCount];
+				face.normal = (vertices[b] - vertices[a]).Cross(vertices[c] - vertices[a]);
+				const real length = face.normal.Magnitude();
+				if (length < 0.000001f)
+					return false;
+				face.normal /= length;
+				face.distance = face.normal.Dot(vertices[a]);
+				face.v[0] = a;
+				face.v[1] = b;
+				face.v[2] = c;
+				face.alive = true;
+
+				heap[heapSize].distance = face.distance;
+				heap[heapSize].face = faceCount++;
+				std::push_heap(heap, heap + ++heapSize);
+				return true;
+			}
+
+			// add edge a-b to the horizon, or cancel it with b-a.
+			// the edge shared by two visible faces appears in both directions,
+			// so only the boundary of the visible faces is left.
+			bool AddEdge(uinteger a, uinteger b) {
+				for (uinteger i = 0; i < edgeCount; i++) {
+					if (horizon[i].a == b && horizon[i].b == a) {
+						horizon[i] = horizon[--edgeCount];
+						return true;
+					}
+				}
+				if (edgeCount == EPA_MAX_EDGES)
+					return false;
+				horizon[edgeCount].a = a;
+				horizon[edgeCount++].b = b;
+				return true;
+			}
+		};
+
+		thread_local EPAScratch epaScratch;
+
+		// the linear cast ends when the distance to the ray point is
+		// under it, relative to the size of the simplex.
+		const real CAST_TOLERANCE = 1e-3f;
+		const uinteger CAST_MAX_ITERATIONS = 32;
+
+		// GJK stops when a new support point goes no further along the
+		// direction than the simplex, over the tolerance relative to the
+		// size of the points. the shapes are separated or just touching.
+		// the iterations are limited for the cycling simplex of the
+		// round shapes.
+		const real GJK_TOLERANCE = 1e-5f;
+		const uinteger GJK_MAX_ITERATIONS = 64;
+
+		// whether the support point W makes progress along dir from
+		// the points of the simplex. a repeated point makes no progress.
+		bool GJK_Progresses(const Vector3* points, uinteger count, const Vector3& dir, const Vector3& W){
+			real reach = dir.Dot(points[0]);
+			real sizeSq = W.MagnitudeSq();
+			for (uinteger i = 0; i < count; i++){
+				if (points[i] == W)
+					return false;
+				reach = std::max(reach, dir.Dot(points[i]));
+				sizeSq = std::max(sizeSq, points[i].MagnitudeSq());
+			}
+			return (dir.Dot(W) - reach > GJK_TOLERANCE * dir.Magnitude() * math::sqrt(sizeSq));
+		}
+
+		// closest point to the origin of the convex hull of the points.
+		// each subset is tested, and the closest one of the points in the
+		// affine hull of a subset with positive weights is the answer.
+		// (Johnson's distance sub-algorithm)
+		// *param:
+		//     Y           - the points. (4 at most)
+		//     count       - the number of points.
+		//     out_mask    - bits of the points of the subset.
+		//     out_weights - barycentric weights of the points.
+		// *return: the closest point.
+		Vector3 ClosestOnSimplex(const Vector3* Y, uinteger count, uinteger& out_mask, real out_weights[4]){
+			real bestDist = REAL_MAX;
+			Vector3 best(0.f);
+			out_mask = 0;
+			for (uinteger mask = 1; mask < (1u << count); mask++){
+				uinteger idx[4];
+				uinteger k = 0;
+				for (uinteger i = 0; i < count; i++){
+					if (mask & (1u << i))
+						idx[k++] = i;
+				}
+
+				// Y0 + sum(t_j * (Yj - Y0)) closest to the origin,
+				// by the normal equations of t. (augmented matrix)
+				const uinteger n = k - 1;
+				Vector3 E[3];
+				real G[3][4];
+				real scale = 0;
+				for (uinteger j = 0; j < n; j++)
+					E[j] = Y[idx[j + 1]] - Y[idx[0]];
+				for (uinteger r = 0; r < n; r++){
+					for (uinteger c = 0; c < n; c++)
+						G[r][c] = E[r].Dot(E[c]);
+					G[r][n] = -Y[idx[0]].Dot(E[r]);
+					scale = math::max(scale, G[r][r]);
+				}
+
+				bool singular = false;
+				for (uinteger c = 0; c < n && !singular; c++){
+					uinteger pivot = c;
+					for (uinteger r = c + 1; r < n; r++){
+						if (G[r][c] * G[r][c] > G[pivot][c] * G[pivot][c])
+							pivot = r;
+					}
+					if (G[pivot][c] * G[pivot][c] <= 1e-12f * scale * scale){
+						singular = true;
+						break;
+					}
+					for (uinteger i = 0; i <= n; i++)
+						std::swap(G[c][i], G[pivot][i]);
+					for (uinteger r = 0; r < n; r++){
+						if (r == c)
+							continue;
+						const real f = G[r][c] / G[c][c];
+						for (uinteger i = c; i <= n; i++)
+							G[r][i] -= f * G[c][i];
+					}
+				}
+				if (singular)
+					continue;
+
+				real weights[4];
+				weights[0] = 1;
+				bool inside = true;
+				for (uinteger j = 0; j < n; j++){
+					weights[j + 1] = G[j][n] / G[j][j];
+					weights[0] -= weights[j + 1];
+					inside = inside && (weights[j + 1] > 0);
+				}
+				if (!inside || weights[0] <= 0)
+					continue;
+
+				Vector3 P(0.f);
+				for (uinteger j = 0; j < k; j++)
+					P += Y[idx[j]] * weights[j];
+				const real dist = P.MagnitudeSq();
+				if (dist < bestDist){
+					bestDist = dist;
+					best = P;
+					out_mask = mask;
+					for (uinteger i = 0; i < 4; i++)
+						out_weights[i] = 0;
+					for (uinteger j = 0; j < k; j++)
+						out_weights[idx[j]] = weights[j];
+				}
+			}
+			return best;
+		}
 
-	GJK_EPA::Face::Face(uinteger _a, uinteger _b, uinteger _c,
-		const Simplex& simplex)
-		: a(_a), b(_b), c(_c)
-	{
-		normal = (simplex[b] - simplex[a]).Cross(simplex[c] - simplex[a]);
-		normal.Normalize();
-		
-		// compute distance
-		distance = normal.Dot(simplex[a]);
 	}
 
 
@@ -27,23 +220,56 @@ namespace sark{
 
 	// it returns true if two convex shape(in world space) A and B intersect each other.
 	// and the last simplex will be stored in 'out_simplex' buffer on true cases.
-	bool GJK_EPA::DoGJK(const ConvexHull* convexA, const ConvexHull* convexB,
-		Simplex* out_simplex)
+	bool GJK_EPA::DoGJK(const ASupportShape* convexA, const ASupportShape* convexB,
+		Simplex* out_simplex, SupportHint* in_hint)
 	{
+		SupportHint localHint;
+		SupportHint& hint = (in_hint != NULL ? *in_hint : localHint);
 		Simplex simplex;
 
+		// vertex indices of the simplex points on A and B.
+		uinteger idxA[4], idxB[4];
+
+		// warm start. the last terminating simplex is tested first.
+		// the support points of the shapes with margin are not on their
+		// vertices, so they have no valid index.
+		const uinteger countA = (convexA->GetMargin() == 0 ? convexA->GetVertexCount() : 0);
+		const uinteger countB = (convexB->GetMargin() == 0 ? convexB->GetVertexCount() : 0);
+		if (hint.simplexSize == 4){
+			bool valid = true;
+			for (uinteger i = 0; i < 4 && valid; i++)
+				valid = (hint.simplexA[i] < countA && hint.simplexB[i] < countB);
+			if (valid){
+				for (uinteger i = 0; i < 4; i++)
+					simplex.push_back(convexA->GetWorldPoint(hint.simplexA[i]) - convexB->GetWorldPoint(hint.simplexB[i]));
+				if (GJK_ContainsOrigin(simplex)){
+					if (out_simplex != NULL)
+						*out_simplex = simplex;
+					return true;
+				}
+				simplex.clear();
+			}
+		}
+		hint.simplexSize = 0;
+
 		// initialize simplex
-		// point D
-		Vector3 dir = Vector3::Right;
-		simplex.push_back(SupportPoint(convexA, convexB, dir));
-		if (dir.Dot(simplex.back()) < 0)
+		// point D. it starts from the last direction.
+		Vector3 dir = (hint.axis == Vector3(0.f) ? Vector3::Right : hint.axis);
+		simplex.push_back(SupportPoint(convexA, convexB, dir, hint));
+		idxA[0] = hint.a; idxB[0] = hint.b;
+		if (dir.Dot(simplex.back()) < 0){
+			hint.axis = dir;
 			return false;
+		}
 
 		// point C
 		dir = -dir;
-		simplex.push_back(SupportPoint(convexA, convexB, dir));
-		if (dir.Dot(simplex.back()) < 0)
+		simplex.push_back(SupportPoint(convexA, convexB, dir, hint));
+		idxA[1] = hint.a; idxB[1] = hint.b;
+		if (dir.Dot(simplex.back()) < 0){
+			hint.axis = dir;
 			return false;
+		}
 
 		// point B
 		//dir = (D - C) x (O - C)
@@ -54,61 +280,98 @@ namespace sark{
 				// for the purpose of EPA, simplex should be completed as tetrahedron(in 3D).
 				// *caution: same points in the current simplex can be added as a new point very occasionally.
 				// but i just ignore this case.. please remember this problematic implemantation.
-				simplex.push_back(SupportPoint(convexA, convexB, Vector3::Up));
+				simplex.push_back(SupportPoint(convexA, convexB, Vector3::Up, hint));
 				dir = (simplex[1] - simplex[2]).Cross(simplex[0] - simplex[2]);
-				simplex.push_back(SupportPoint(convexA, convexB, dir));
+				simplex.push_back(SupportPoint(convexA, convexB, dir, hint));
 				*out_simplex = simplex;
 			}
 			return true;
 		}
-		simplex.push_back(SupportPoint(convexA, convexB, dir));
+		simplex.push_back(SupportPoint(convexA, convexB, dir, hint));
+		idxA[2] = hint.a; idxB[2] = hint.b;
 
 		// point A (compute direction only)
-		do{
+		for (uinteger iter = 0; ; iter++){
 			// dir = (C - B) x (D - B)
 			dir = (simplex[1] - simplex[2]).Cross(simplex[0] - simplex[2]);
 
 			// check location of origin
 			int8 loc = tool::PointLocationByPlane(Vector3(0), dir, simplex[2]);
-			if (loc == 0){
-				// adjust point B
-				simplex[2] = SupportPoint(convexA, convexB, dir);
-				continue;
+			if (loc == 0 && iter < GJK_MAX_ITERATIONS){
+				// adjust point B. if it does not move, the origin is on
+				// the boundary of the plane, and either side is taken.
+				const Vector3 B = SupportPoint(convexA, convexB, dir, hint);
+				if (GJK_Progresses(&simplex[0], 3, dir, B)){
+					simplex[2] = B;
+					idxA[2] = hint.a; idxB[2] = hint.b;
+					continue;
+				}
 			}
 			if (loc < 0){
 				dir = -dir;
 			}
 			break;
-		} while (true);
+		}
 
 
 		// GJK iteration. find a simplex which contains the origin.
-		while (true){
-			simplex.push_back(SupportPoint(convexA, convexB, dir));
-			if (dir.Dot(simplex.back()) < 0){
+		uinteger removed;
+		for (uinteger iter = 0; iter < GJK_MAX_ITERATIONS; iter++){
+			const Vector3 A = SupportPoint(convexA, convexB, dir, hint);
+			if (dir.Dot(A) < 0 || !GJK_Progresses(&simplex[0], 3, dir, A)){
+				hint.axis = dir;
 				return false;
 			}
-
-			if (GJK_CheckAndUpdate(simplex, dir)){
+			simplex.push_back(A);
+			idxA[3] = hint.a; idxB[3] = hint.b;
+
+			if (GJK_CheckAndUpdate(simplex, dir, removed)){
+				// keep the terminating simplex for the next call.
+				hint.axis = dir;
+				for (uinteger i = 0; i < 4; i++){
+					hint.simplexA[i] = idxA[i];
+					hint.simplexB[i] = idxB[i];
+				}
+				hint.simplexSize = 4;
 				if (out_simplex != NULL)
 					*out_simplex = simplex;
 				return true;
 			}
+			for (uinteger i = removed; i < 3; i++){
+				idxA[i] = idxA[i + 1];
+				idxB[i] = idxB[i + 1];
+			}
 		}
+
+		// the simplex cycles without enclosing the origin. it is on the
+		// boundary within the tolerance, so the shapes are touching.
+		hint.axis = dir;
+		return false;
 	}
 
 	// it returns contact normal and penetration depth.
-	bool GJK_EPA::DoEPA(const ConvexHull* convexA, const ConvexHull* convexB,
-		Simplex& simplex,
-		Vector3* out_normal, real* out_depth)
+	// the polytope is expanded toward the closest face until the face is on
+	// the boundary of minkowski set. the faces are kept in a min-heap, and
+	// the new point replaces the faces visible from it by the fan of faces
+	// on the horizon edges.
+	bool GJK_EPA::DoEPA(const ASupportShape* convexA, const ASupportShape* convexB,
+		const Simplex& simplex,
+		Vector3* out_normal, real* out_depth, SupportHint* in_hint)
 	{
+		SupportHint localHint;
+		SupportHint& hint = (in_hint != NULL ? *in_hint : localHint);
 		if (simplex.size() != 4){
 			LogWarn("given simplex is not completed");
 			return false;
 		}
 
-		// init face list.
-		FaceList faces;
+		EPAScratch& scratch = epaScratch;
+		scratch.Reset();
+
+		// init faces of the tetrahedron, oriented toward outside.
+		for (uinteger i = 0; i < 4; i++)
+			scratch.vertices[i] = simplex[i];
+		scratch.vertexCount = 4;
 		{
 			const Vector3& A = simplex[3];
 			const Vector3& B = simplex[2];
@@ -116,95 +379,110 @@ namespace sark{
 			const Vector3& D = simplex[0];
 
 			// is A above BCD?
-			Vector3 BCD = (C - B).Cross(D - B);
-			int8 loc = tool::PointLocationByPlane(A, BCD, B);
+			int8 loc = tool::PointLocationByPlane(A, (C - B).Cross(D - B), B);
+			bool valid;
 			if (loc > 0){
-				// orient BCD toward outside
-				BCD = -BCD;
-				BCD.Normalize();
-				real dist_BCD = BCD.Dot(B);
-
 				// ABC, ACD, ADB, BDC
-				faces.push_back(Face(3, 2, 1, simplex));
-				faces.push_back(Face(3, 1, 0, simplex));
-				faces.push_back(Face(3, 0, 2, simplex));
-				faces.push_back(Face(2, 0, 1, BCD, dist_BCD));
+				valid = scratch.AddFace(3, 2, 1) && scratch.AddFace(3, 1, 0)
+					&& scratch.AddFace(3, 0, 2) && scratch.AddFace(2, 0, 1);
 			}
 			else if (loc < 0){
-				BCD.Normalize();
-				real dist_BCD = BCD.Dot(B);
-
 				// ACB, ADC, ABD, BCD
-				faces.push_back(Face(3, 1, 2, simplex));
-				faces.push_back(Face(3, 0, 1, simplex));
-				faces.push_back(Face(3, 2, 0, simplex));
-				faces.push_back(Face(2, 1, 0, BCD, dist_BCD));
+				valid = scratch.AddFace(3, 1, 2) && scratch.AddFace(3, 0, 1)
+					&& scratch.AddFace(3, 2, 0) && scratch.AddFace(2, 1, 0);
 			}
 			else{
+				valid = false;
+			}
+			if (!valid){
 				LogWarn("A is on the same plane of BCD");
 				return false;
 			}
 		}
 
-		FaceList::iterator itr;
-		FaceList::iterator closest;
-		FaceList::iterator end = faces.end();
-
-		do{
-			itr = faces.begin();
-			closest = itr;
-			for (; itr != end; itr++){
-				if (itr->distance < closest->distance){
-					closest = itr;
+		while (true){
+			// pop the closest alive face.
+			uinteger closest;
+			do{
+				if (scratch.heapSize == 0){
+					LogWarn("polytope has no face");
+					return false;
 				}
-			}
+				closest = scratch.heap[0].face;
+				std::pop_heap(scratch.heap, scratch.heap + scratch.heapSize--);
+			} while (!scratch.faces[closest].alive);
+			const EPAFace& face = scratch.faces[closest];
 
-			Vector3 P = SupportPoint(convexA, convexB, closest->normal);
+			Vector3 P = SupportPoint(convexA, convexB, face.normal, hint);
 
-			real d = P.Dot(closest->normal);
-			if (d - closest->distance < 0.00001f){
+			real d = P.Dot(face.normal);
+			bool done = (d - face.distance < 0.00001f);
+
+			// the scratch is full. it is the closest face so far.
+			// (the fan of new faces is at most one more than the faces removed,
+			// and each visible face adds three edges at most)
+			if (scratch.vertexCount == EPA_MAX_VERTICES
+				|| scratch.faceCount + EPA_MAX_EDGES > EPA_MAX_FACES)
+				done = true;
+
+			if (done){
 				// closest face is really closest and we're done.
 				if (out_normal != NULL)
-					*out_normal = closest->normal;
+					*out_normal = face.normal;
 				if (out_depth != NULL)
-					*out_depth = closest->distance;
+					*out_depth = face.distance;
 				return true;
 			}
-			else{
-				// add point and make sure that face list to be convex.
-				// note that added point p can't be placed on the any tip of voronoi regions
-				// because the points of simplex are already farthest points of
-				// minkowski set.
-				simplex.push_back(P);
-
-				// find visible faces
-				std::vector<FaceList::iterator> targets;
-				for (itr = faces.begin(); itr != end; itr++){
-					if (tool::PointLocationByPlane(P, itr->normal, simplex[itr->a]) > 0){
-						targets.push_back(itr);
-					}
-				}
-				
-				// expand polytope
-				EPA_Expand(simplex, faces, targets);
+
+			// add point and remove the faces visible from it.
+			// the closest face is always visible, since P is beyond it.
+			// note that added point p can't be placed on the any tip of voronoi regions
+			// because the points of simplex are already farthest points of
+			// minkowski set.
+			const uinteger pidx = scratch.vertexCount++;
+			scratch.vertices[pidx] = P;
+			scratch.edgeCount = 0;
+			bool closed = true;
+			for (uinteger i = 0; i < scratch.faceCount && closed; i++){
+				EPAFace& target = scratch.faces[i];
+				if (!target.alive || (i != closest &&
+					tool::PointLocationByPlane(P, target.normal, scratch.vertices[target.v[0]]) <= 0))
+					continue;
+				target.alive = false;
+				closed = scratch.AddEdge(target.v[0], target.v[1])
+					&& scratch.AddEdge(target.v[1], target.v[2])
+					&& scratch.AddEdge(target.v[2], target.v[0]);
 			}
-		} while (true);
+
+			// fill the hole by the faces from the horizon edges to P.
+			for (uinteger i = 0; i < scratch.edgeCount && closed; i++)
+				closed = scratch.AddFace(scratch.horizon[i].a, scratch.horizon[i].b, pidx);
+
+			if (!closed){
+				// the polytope is broken by the numerical error. the popped
+				// face is the best one.
+				const EPAFace& best = scratch.faces[closest];
+				if (out_normal != NULL)
+					*out_normal = best.normal;
+				if (out_depth != NULL)
+					*out_depth = best.distance;
+				return true;
+			}
+		}
 	}
 
 
 	// return the farthest point in direction at
 	// the set of minkowski sum of two convex point sets.
-	const Vector3 GJK_EPA::SupportPoint(const ConvexHull* convexA, const ConvexHull* convexB,
-		const Vector3& direction)
+	const Vector3 GJK_EPA::SupportPoint(const ASupportShape* convexA, const ASupportShape* convexB,
+		const Vector3& direction, SupportHint& hint)
 	{
-		const Vector3 farA = tool::FarthestPointInDirection(convexA->GetTransPointSet(), direction);
-		const Vector3 farB = tool::FarthestPointInDirection(convexB->GetTransPointSet(), -direction);
-		return farA - farB;
+		return convexA->SupportPoint(direction, &hint.a) - convexB->SupportPoint(-direction, &hint.b);
 	}
 
 	// check whether the simplex contains the origin
 	// and then update simplex if it doesn't.
-	bool GJK_EPA::GJK_CheckAndUpdate(Simplex& simplex, Vector3& dir){
+	bool GJK_EPA::GJK_CheckAndUpdate(Simplex& simplex, Vector3& dir, uinteger& out_removed){
 		const Vector3& A = simplex[3];
 		const Vector3& B = simplex[2];
 		const Vector3& C = simplex[1];
@@ -218,17 +496,20 @@ namespace sark{
 			// A is above BCD. normal of ABC, ADB, ACD are candidates
 			dir = AB.Cross(AC);
 			if (AO.Dot(dir) > 0){
-				simplex.erase(simplex.begin()+0);
+				simplex.erase(simplex.begin() + 0);
+				out_removed = 0;
 			}
 			else{
 				dir = AD.Cross(AB);
 				if (AO.Dot(dir) > 0){
 					simplex.erase(simplex.begin() + 1);
+					out_removed = 1;
 				}
 				else{
 					dir = AC.Cross(AD);
 					if (AO.Dot(dir) > 0){
 						simplex.erase(simplex.begin() + 2);
+						out_removed = 2;
 					}
 					else{
 						// origin is in the tetrahedron ABCD
@@ -242,16 +523,19 @@ namespace sark{
 			dir = AC.Cross(AB);
 			if (AO.Dot(dir) > 0){
 				simplex.erase(simplex.begin() + 0);
+				out_removed = 0;
 			}
 			else{
 				dir = AB.Cross(AD);
 				if (AO.Dot(dir) > 0){
 					simplex.erase(simplex.begin() + 1);
+					out_removed = 1;
 				}
 				else{
 					dir = AD.Cross(AC);
 					if (AO.Dot(dir) > 0){
 						simplex.erase(simplex.begin() + 2);
+						out_removed = 2;
 					}
 					else{
 						// origin is in the tetrahedron ABCD
@@ -263,156 +547,104 @@ namespace sark{
 		return false;
 	}
 
-	// expand simplex to be containing the origin
-	// as far as possible.
-	void GJK_EPA::EPA_Expand(const Simplex& simplex, FaceList& faces,
-		const std::vector<FaceList::iterator>& targets)
+	// it casts convex shape A along the translation against B, and returns
+	// true if A hits B on the way. (GJK ray cast, van den Bergen)
+	bool GJK_EPA::DoLinearCast(const ASupportShape* convexA, const ASupportShape* convexB,
+		const Vector3& translation,
+		real* out_toi, Vector3* out_normal, Vector3* out_point)
 	{
-		uinteger pidx = simplex.size() - 1;
-		uinteger szTarget = targets.size();
-		if (szTarget == 0){
-
-		}
-		else if (szTarget == 1){
-			// point is in a certain face side of voronoi regions.
-			// there are 3 faces should be added and a face should be removed.
-			faces.push_back(Face(pidx, targets[0]->a, targets[0]->b, simplex));
-			faces.push_back(Face(pidx, targets[0]->b, targets[0]->c, simplex));
-			faces.push_back(Face(pidx, targets[0]->c, targets[0]->a, simplex));
-			faces.erase(targets[0]);
-		}
-		else if (szTarget == 2){
-			// point is in a certain edge side of voronoi regions.
-			// there are 4 faces should be added and two faces should be removed.
-			// find unique and one way ordered indices of two target faces.
-			uinteger uniqIdxs[4];
-			for (uinteger i = 0; i < 3; i++){
-				uinteger j = 0;
-				for (; j < 3; j++){
-					if (targets[0]->idx[i] == targets[1]->idx[j])
-						break;
-				}
-				if (j != 3){
-					// it can be guaranteed that the target faces are orderd by ccw.
-					// (they were sorted when compute those face normals)
-					// so, (i+1)---(j+2) or (i+2)---(j+1) is the common edge.
-					if (targets[0]->idx[(i + 1) % 3] == targets[1]->idx[(j + 2) % 3]){
-						// (i)--(j+1)--(i+1)--(i+2) order
-						uniqIdxs[0] = targets[0]->idx[i];
-						uniqIdxs[1] = targets[1]->idx[(j + 1) % 3];
-						uniqIdxs[2] = targets[0]->idx[(i + 1) % 3];
-						uniqIdxs[3] = targets[0]->idx[(i + 2) % 3];
-						break;
-					}
-					else{ //if (i+2)---(j+1)
-						// (i)--(i+1)--(i+2)--(j+2)
-						uniqIdxs[0] = targets[0]->idx[i];
-						uniqIdxs[1] = targets[0]->idx[(i + 1) % 3];
-						uniqIdxs[2] = targets[0]->idx[(i + 2) % 3];
-						uniqIdxs[3] = targets[1]->idx[(j + 2) % 3];
-						break;
-					}
-				}
-			}
-
-			faces.push_back(Face(pidx, uniqIdxs[0], uniqIdxs[1], simplex));
-			faces.push_back(Face(pidx, uniqIdxs[1], uniqIdxs[2], simplex));
-			faces.push_back(Face(pidx, uniqIdxs[2], uniqIdxs[3], simplex));
-			faces.push_back(Face(pidx, uniqIdxs[3], uniqIdxs[0], simplex));
-			faces.erase(targets[0]);
-			faces.erase(targets[1]);
-		}
-		else{
-			// unique index list
-			std::vector<uinteger> uniqIdxs;
-
-			// 1. push indices of targets[0] into idxs.
-			uniqIdxs.push_back(targets[0]->a);
-			uniqIdxs.push_back(targets[0]->b);
-			uniqIdxs.push_back(targets[0]->c);
-			uinteger szIdxs = uniqIdxs.size();
-
-			// 2. gather the indices from targets uniquely.
-			uinteger i, j, k;
-			for (i = 1; i < szTarget; i++){
-				// push indices from target[i] into idxs uniquely.
-				for (j = 0; j < 3; j++){
-					bool unique = true;
-					for (k = 0; k < szIdxs; k++){
-						if (targets[i]->idx[j] == uniqIdxs[k]){
-							unique = false;
-							break;
-						}
-					}
-					if (unique){
-						uniqIdxs.push_back(targets[i]->idx[j]);
-						szIdxs++;
-					}
-				}
+		// A moved by (t * translation) touches B when the point is in
+		// the minkowski set B - A. so the ray from the origin along the
+		// translation is cast on it, and the ray point 'x' is advanced
+		// by the planes of the support points, which never pass B - A.
+		uinteger vertexA = 0, vertexB = 0;
+		Vector3 PA[4], PB[4], Y[4];
+		real weights[4];
+		uinteger count = 0;
+
+		real lambda = 0;
+		Vector3 x(0.f);
+		Vector3 normal(0.f);
+		Vector3 v = x - (convexB->SupportPoint(-translation, &vertexB) - convexA->SupportPoint(translation, &vertexA));
+
+		for (uinteger iter = 0; iter < CAST_MAX_ITERATIONS; iter++){
+			real size = 0;
+			for (uinteger i = 0; i < count; i++)
+				size = math::max(size, Y[i].MagnitudeSq());
+			if (count > 0 && v.MagnitudeSq() <= CAST_TOLERANCE * CAST_TOLERANCE * size)
+				break;
+
+			const Vector3 a = convexA->SupportPoint(-v, &vertexA);
+			const Vector3 b = convexB->SupportPoint(v, &vertexB);
+			const Vector3 w = x - (b - a);
+			const real vw = v.Dot(w);
+			if (vw > 0){
+				const real vr = v.Dot(translation);
+				if (vr >= 0)
+					return false;
+				lambda -= vw / vr;
+				if (lambda > 1)
+					return false;
+				x = translation * lambda;
+				normal = v;
 			}
 
-			// 3. compute the center point of unique vertices.
-			Vector3 CP(0);
-			for (i = 0; i < szIdxs; i++)
-				CP += simplex[uniqIdxs[i]];
-			CP /= (real)szIdxs;
-
-			// 4. project unique vertices into a certain plane.
-			// at this point, i choose the plane which has CP-P as plane normal
-			// and is passing the origin.
-			Vector3 norm = simplex[pidx] - CP;
-			norm.Normalize();
-
-			Vector3 projCP = CP - CP.Dot(norm)*norm;
-			std::vector<Vector3> projPoints(szIdxs);
-			for (i = 0; i < szIdxs; i++){
-				const Vector3& Q = simplex[uniqIdxs[i]];
-				projPoints[i] = Q - Q.Dot(norm)*norm;
-			}
-
-			// 5. compute angles of CP-projPoints axis as plane normal.
-			std::vector<real> angles(szIdxs);
-			Vector3 standAxis = projPoints[0] - projCP;
-			standAxis.Normalize();
-
-			angles[0] = 0;
-			for (i = 1; i < szIdxs; i++){
-				Vector3 line = (projPoints[i] - projCP).Normal();
-				Vector3 perp = standAxis.Cross(line);
-				angles[i] = math::acos(standAxis.Dot(line));
-				// if sin() <0 then angle is over PI
-				if (perp.Dot(norm) < 0){
-					angles[i] = math::PI*2.f - angles[i];
+			if (count == 4)
+				break;
+			PA[count] = a;
+			PB[count] = b;
+			count++;
+			for (uinteger i = 0; i < count; i++)
+				Y[i] = x - (PB[i] - PA[i]);
+
+			// keep the points of the subset only.
+			uinteger mask;
+			v = ClosestOnSimplex(Y, count, mask, weights);
+			uinteger kept = 0;
+			for (uinteger i = 0; i < count; i++){
+				if (mask & (1u << i)){
+					PA[kept] = PA[i];
+					PB[kept] = PB[i];
+					Y[kept] = Y[i];
+					weights[kept] = weights[i];
+					kept++;
 				}
 			}
+			count = kept;
+		}
 
-			// 6. sort angles with indices ordered by angles ascent.
-			// algorithm from wikipedia.
-			real tmp;
-			for (i = 1; i<szIdxs; i++){
-				j = i;
-				tmp = angles[j];
-				k = uniqIdxs[j];
-
-				while (--j >= 0 && tmp < angles[j]){
-					angles[j + 1] = angles[j];
-					uniqIdxs[j + 1] = uniqIdxs[j];
-				}
-				angles[j + 1] = tmp;
-				uniqIdxs[j + 1] = k;
-			}
+		// they overlap at the start.
+		if (lambda == 0 || normal.MagnitudeSq() == 0)
+			return false;
 
-			// 7. add and remove faces
-			szIdxs -= 1;
-			for (i = 0; i < szIdxs;){
-				faces.push_back(Face(pidx, uniqIdxs[i++], uniqIdxs[i], simplex));
-			}
-			faces.push_back(Face(pidx, uniqIdxs[szIdxs], uniqIdxs[0], simplex));
+		if (out_toi != NULL)
+			*out_toi = lambda;
+		if (out_normal != NULL)
+			*out_normal = normal.Normal();
+		if (out_point != NULL){
+			Vector3 point(0.f);
+			for (uinteger i = 0; i < count; i++)
+				point += PB[i] * weights[i];
+			*out_point = point;
+		}
+		return true;
+	}
 
-			for (i = 0; i < szTarget; i++){
-				faces.erase(targets[i]);
-			}
+	// check whether the tetrahedron simplex contains the origin strictly.
+	// the origin should be on the same side of each face as the opposite point.
+	bool GJK_EPA::GJK_ContainsOrigin(const Simplex& simplex){
+		const uinteger faces[4][4] = {
+			{ 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 }
+		};
+		for (uinteger i = 0; i < 4; i++){
+			const Vector3& P = simplex[faces[i][0]];
+			const Vector3 n = (simplex[faces[i][1]] - P).Cross(simplex[faces[i][2]] - P);
+			const real opposite = n.Dot(simplex[faces[i][3]] - P);
+			const real origin = -n.Dot(P);
+			if (opposite * origin <= 0)
+				return false;
 		}
+		return true;
 	}
 
 }
\ No newline at end of file
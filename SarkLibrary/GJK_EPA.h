@@ -2,76 +2,94 @@
 #define __GJK_EPA_H__
 
 #include <vector>
-#include <list>
 #include "core.h"
 
 namespace sark{
 
-	class ConvexHull;
+	class ASupportShape;
 
 	// Gilbert Johnsom Keerthi and
 	// Expanding Polytope Algorithm package class.
+	// the shapes are given by their support mappings, so the convex hulls
+	// and the implicit shapes (sphere, box, capsule) are mixed freely.
 	class GJK_EPA{
 	public:
 		// type of simplex for GJK and EPA process.
 		typedef std::vector<Vector3> Simplex;
 
+		// temporal coherence cache of a pair of shapes.
+		// keep one for a pair of shapes to reuse it over frames, and drop
+		// it when the pair is gone.
+		//  - the last support vertices. successive support directions are
+		//    close each other, so the hill climbing support search starts
+		//    from them.
+		//  - the last search direction of GJK. it is the separating axis
+		//    if the shapes were separated, so GJK starts from it and ends
+		//    at the first support point while they are still separated.
+		//  - the terminating simplex of GJK as the vertex indices of the
+		//    shapes. if it still contains the origin with the current
+		//    transforms, GJK ends without any support search. it is not
+		//    kept for the curved shapes and the shapes with margin, since
+		//    their support points are not on the vertices.
+		struct SupportHint{
+			uinteger a, b;
+			Vector3 axis;
+			uinteger simplexA[4], simplexB[4];
+			uinteger simplexSize;
+			SupportHint() : a(0), b(0), axis(0.f), simplexSize(0){}
+		};
+
 		// do GJK process.
-		// it detects the collision of two convex hulls.
+		// it detects the collision of two convex shapes.
 		// if they intersect then the simplex data of minkowski set
 		// will be stored in the 'out_simplex'.
-		static bool DoGJK(const ConvexHull* convexA, const ConvexHull* convexB,
-			Simplex* out_simplex = NULL);
+		// 'hint' is used and updated if it is given.
+		static bool DoGJK(const ASupportShape* convexA, const ASupportShape* convexB,
+			Simplex* out_simplex = NULL, SupportHint* hint = NULL);
 
 		// do EPA process.
 		// it compute the contact normal and penetration depth.
-		// simplex should be the termination data of GJK and
-		// it can be expanded when EPA run.
+		// simplex should be the termination data of GJK.
+		// the polytope is expanded in the scratch memory of the thread,
+		// so it does not allocate and the simplex is not changed.
 		// if EPA does successfully, it'll store the collision
 		// informations into 'out_*' buffer.
-		static bool DoEPA(const ConvexHull* convexA, const ConvexHull* convexB,
-			Simplex& simplex,
-			Vector3* out_normal = NULL, real* out_depth = NULL);
+		// 'hint' is used and updated if it is given.
+		static bool DoEPA(const ASupportShape* convexA, const ASupportShape* convexB,
+			const Simplex& simplex,
+			Vector3* out_normal = NULL, real* out_depth = NULL,
+			SupportHint* hint = NULL);
 
-
-	private:
-		// temporal face for EPA process.
-		class Face{
-		public:
-			union{
-				struct{
-					uinteger a, b, c;
-				};
-				struct{
-					uinteger idx[3];
-				};
-			};
-			Vector3 normal;
-			real distance;
-			
-			// it initialize normal and distance as ccw order of given a,b,c.
-			Face(uinteger _a, uinteger _b, uinteger _c,
-				const Vector3& _normal, const real& _distance);
-
-			Face(uinteger _a, uinteger _b, uinteger _c, const Simplex& simplex);
-		};
-		typedef std::list<Face> FaceList;
+		// do linear cast.
+		// it finds the first time which convex shape A touches B while
+		// it moves along the translation. the rotations are ignored, and
+		// the shapes are at the transforms of the last update.
+		// *param:
+		//     translation - the motion of A relative to B.
+		//     out_toi     - time of impact in [0, 1] of the translation.
+		//     out_normal  - unit normal of B at the impact. it points
+		//                   from B to A.
+		//     out_point   - the point of impact on B.
+		// *return: false if A does not hit B, or they overlap at the start.
+		static bool DoLinearCast(const ASupportShape* convexA, const ASupportShape* convexB,
+			const Vector3& translation,
+			real* out_toi = NULL, Vector3* out_normal = NULL, Vector3* out_point = NULL);
 
 
+	private:
 		// return the farthest point in direction at
 		// the set of minkowski sum of two convex point sets.
 		static const Vector3 SupportPoint(
-			const ConvexHull* convexA, const ConvexHull* convexB,
-			const Vector3& direction);
+			const ASupportShape* convexA, const ASupportShape* convexB,
+			const Vector3& direction, SupportHint& hint);
 
 		// check whether the simplex contains the origin
 		// and then update simplex if it doesn't.
-		static bool GJK_CheckAndUpdate(Simplex& simplex, Vector3& dir);
+		// 'out_removed' is the index of the removed point.
+		static bool GJK_CheckAndUpdate(Simplex& simplex, Vector3& dir, uinteger& out_removed);
 
-		// expand simplex to be containing the origin
-		// as far as possible.
-		static void EPA_Expand(const Simplex& simplex, FaceList& faces,
-			const std::vector<FaceList::iterator>& targets);
+		// check whether the tetrahedron simplex contains the origin strictly.
+		static bool GJK_ContainsOrigin(const Simplex& simplex);
 	};
 
 }
@@ -3,6 +3,7 @@
 #include "StaticModel.h"
 #include "ArrayBuffer.h"
 #include "Mesh.h"
+#include "CollisionGeometry.h"
 #include "tools.h"
 #include <fstream>
 #include <string>
@@ -45,6 +46,20 @@ namespace sark {
 		for (; itr != end; itr++) {
 			(*itr) -= center;
 		}
+
+		// the vertices are moved.
+		mCollisionGeometry = NULL;
+	}
+
+	// get collision geometry of the faces.
+	s_ptr<CollisionGeometry> OBJResource::GetCollisionGeometry() const {
+		if (mFaces.size() == 0 || mVertices.size() == 0)
+			return NULL;
+		if (mCollisionGeometry == NULL) {
+			mCollisionGeometry = s_ptr<CollisionGeometry>(new CollisionGeometry());
+			mCollisionGeometry->Build(&mVertices[0], mVertices.size(), &mFaces[0], mFaces.size());
+		}
+		return mCollisionGeometry;
 	}
 
 	// create model component from this resource
@@ -65,6 +80,10 @@ namespace sark {
 		}
 		arrbuf.SetDrawMode(ArrayBuffer::DrawMode::TRIANGLES);
 
+		// the faces are in system memory here, so the model does not
+		// have to read back its buffers for collision detection.
+		model->SetCollisionGeometry(GetCollisionGeometry());
+
 		return model;
 	}
 
@@ -8,6 +8,8 @@
 
 namespace sark {
 
+	class CollisionGeometry;
+
 	// OBJ model format resource.
 	class OBJResource : public IModelResource, public IResourceLoader<OBJResource> {
 	private:
@@ -23,6 +25,10 @@ namespace sark {
 		// texture coordinate array
 		std::vector<Vector2> mTexcoords;
 
+		// collision geometry shared by the created models.
+		// it is built on the first request.
+		mutable s_ptr<CollisionGeometry> mCollisionGeometry;
+
 	public:
 		OBJResource();
 		~OBJResource();
@@ -39,6 +45,11 @@ namespace sark {
 		// get texture coordinates of the object
 		std::vector<Vector2> GetTexcoords() const;
 		
+		// get collision geometry of the faces.
+		// the models created from this resource share it.
+		// *return: NULL if the object has no faces.
+		s_ptr<CollisionGeometry> GetCollisionGeometry() const;
+
 		// make this model resource to be center
 		void MakeItCenter() override;
 
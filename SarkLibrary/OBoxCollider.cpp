@@ -1,8 +1,6 @@
 #include "OBoxCollider.h"
 #include "tools.h"
 #include "ASceneComponent.h"
-#include "SphereCollider.h"
-#include "AABoxCollider.h"
 
 namespace sark {
 
@@ -31,29 +29,6 @@ namespace sark {
 		return ACollider::OBOX;
 	}
 
-	bool OBoxCollider::IntersectWith(const ACollider* coll) const {
-		switch (coll->GetType()) {
-		case ACollider::SPHERE:{
-				const SphereCollider& sphere = reinterpret_cast<const SphereCollider&>(*coll);
-				return tool::Sphere_OBoxIntersection(sphere.pos, sphere.r, pos, ext, axis);
-			}
-			break;
-		case ACollider::AABOX:{
-				const AABoxCollider& aab = reinterpret_cast<const AABoxCollider&>(*coll);
-				return tool::AABox_OBoxIntersection(aab.min, aab.max, pos, ext, axis);
-			}
-			break;
-		case ACollider::OBOX:{
-				const OBoxCollider& obB = reinterpret_cast<const OBoxCollider&>(*coll);
-				return tool::OBox_OBoxIntersection(pos, ext, axis, obB.pos, obB.ext, obB.axis);
-			}
-			break;
-		case ACollider::CONVEXHULL:
-			break;
-		}
-		return false;
-	}
-
 	void OBoxCollider::Update() {
 		// to orient the object, it needs the rotation matrix R.
 		// therefore, transposition of R can transform the object
@@ -68,4 +43,52 @@ namespace sark {
 		pos = mReference->GetTransform().GetPosition();
 	}
 
+	// get world space bounding box.
+	void OBoxCollider::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		// half extent on each world axis is the sum of
+		// the projected half extents of the box axes.
+		Vector3 half(GetMargin());
+		for (uinteger i = 0; i < 3; i++) {
+			half.x += math::abs(axis[i].x) * ext.v[i];
+			half.y += math::abs(axis[i].y) * ext.v[i];
+			half.z += math::abs(axis[i].z) * ext.v[i];
+		}
+		out_min = pos - half;
+		out_max = pos + half;
+	}
+
+	// get the unit axes, and the half-extentions along them.
+	void OBoxCollider::GetOrthonormal(Vector3& out_ext, Vector3 out_axis[3]) const {
+		for (uinteger i = 0; i < 3; i++) {
+			const real len = axis[i].Magnitude();
+			out_axis[i] = axis[i] / len;
+			out_ext.v[i] = ext.v[i] * len;
+		}
+	}
+
+	// the eight corners.
+	uinteger OBoxCollider::GetVertexCount() const {
+		return 8;
+	}
+
+	// get the corner.
+	const Vector3 OBoxCollider::GetWorldPoint(uinteger index) const {
+		Vector3 P = pos;
+		for (uinteger i = 0; i < 3; i++)
+			P += axis[i] * ((index & (1 << i)) ? ext.v[i] : -ext.v[i]);
+		return P;
+	}
+
+	// the corner on the side of the direction.
+	const Vector3 OBoxCollider::CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const {
+		uinteger index = 0;
+		for (uinteger i = 0; i < 3; i++) {
+			if (direction.Dot(axis[i]) >= 0)
+				index |= (1 << i);
+		}
+		if (inout_vertex != NULL)
+			*inout_vertex = index;
+		return GetWorldPoint(index);
+	}
+
 }
\ No newline at end of file
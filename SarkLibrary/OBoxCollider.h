@@ -3,6 +3,7 @@
 
 #include "core.h"
 #include "ACollider.h"
+#include "ASupportShape.h"
 
 namespace sark {
 
@@ -10,7 +11,11 @@ namespace sark {
 	// box which has the own orientation.
 	// it is represented as center position
 	// of box and its own basis with extensions.
-	class OBoxCollider : public ACollider {
+	class OBoxCollider : public ACollider, public ASupportShape {
+	protected:
+		// the corner on the side of the direction.
+		const Vector3 CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const override;
+
 	public:
 		// center position of box.
 		Vector3 pos;
@@ -18,7 +23,9 @@ namespace sark {
 		// half-extention of each axis.
 		Vector3 ext;
 
-		// orthonormal axis
+		// orthonormal axis.
+		// it is the columns of the transform after Update, so the axes
+		// are scaled by the scale of the reference. (see GetOrthonormal)
 		Vector3 axis[3];
 
 		OBoxCollider(ASceneComponent* reference);
@@ -31,11 +38,22 @@ namespace sark {
 		// get type.
 		const Type GetType() const override;
 
-		// intersection test.
-		bool IntersectWith(const ACollider* coll) const override;
-
 		// update obox
 		void Update() override;
+
+		// get world space bounding box.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const override;
+
+		// get the unit axes, and the half-extentions along them.
+		// the analytic tests need the orthonormal axes.
+		void GetOrthonormal(Vector3& out_ext, Vector3 out_axis[3]) const;
+
+		// the eight corners.
+		uinteger GetVertexCount() const override;
+
+		// get the corner. the bits of index choose the positive side of
+		// each axis.
+		const Vector3 GetWorldPoint(uinteger index) const override;
 	};
 
 }
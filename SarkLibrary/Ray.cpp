@@ -5,9 +5,64 @@
 #include "AABoxCollider.h"
 #include "OBoxCollider.h"
 #include "ConvexHull.h"
+#include "GJK_EPA.h"
 
 namespace sark {
 
+	namespace {
+
+		// the origin of the ray, which is cast on the support shapes.
+		class PointShape : public ASupportShape {
+		private:
+			Vector3 mPosition;
+
+		protected:
+			const Vector3 CoreSupportPoint(const Vector3&, uinteger*) const override {
+				return mPosition;
+			}
+
+		public:
+			PointShape(const Vector3& position) : mPosition(position) {}
+
+			uinteger GetVertexCount() const override {
+				return 1;
+			}
+
+			const Vector3 GetWorldPoint(uinteger) const override {
+				return mPosition;
+			}
+		};
+
+		// GJK ray cast of the origin on the support shape. the ray which
+		// starts inside of it does not hit.
+		bool SupportCast(const Ray& ray, const ASupportShape* shape, Vector3& out_P, Vector3& out_N) {
+			const PointShape origin(ray.pos);
+			real toi;
+			if (!GJK_EPA::DoLinearCast(&origin, shape, ray.dir * ray.limit, &toi, &out_N))
+				return false;
+			out_P = ray.pos + ray.dir * (ray.limit * toi);
+			return true;
+		}
+
+		// normal of the box face which the point is on.
+		// the point and the normal are in the space of the box.
+		Vector3 BoxNormal(const Vector3& P, const Vector3& ext) {
+			uinteger face = 0;
+			real farthest = -1;
+			for (uinteger a = 0; a < 3; a++) {
+				const real d = (ext.v[a] > 0 ? math::abs(P.v[a]) / ext.v[a] : REAL_MAX);
+				if (d > farthest) {
+					farthest = d;
+					face = a;
+				}
+			}
+			Vector3 N(0.f);
+			N.v[face] = (P.v[face] < 0 ? -1.f : 1.f);
+			return N;
+		}
+
+	}
+
 	Ray::Ray()
 		: pos(0), dir(Vector3::Forward), limit(0) {}
 
@@ -17,21 +72,45 @@ namespace sark {
 	Ray::Ray(const Vector3& A, const Vector3& B)
 		: pos(A), dir(B - A), limit(1.f) {}
 
-	bool Ray::IntersectWith(const ACollider* coll, Vector3* out_P) const {
+	bool Ray::IntersectWith(const ACollider* coll, Vector3* out_P, Vector3* out_N) const {
+		Vector3 P, N;
+
+		// the shapes with margin are rounded off, so they are cast by GJK.
+		const ASupportShape* shape = ACollider::GetSupportShape(coll);
+		if (shape->GetMargin() != 0) {
+			if (!SupportCast(*this, shape, P, N))
+				return false;
+			if (out_P != NULL)
+				*out_P = P;
+			if (out_N != NULL)
+				*out_N = N;
+			return true;
+		}
+
 		switch (coll->GetType()) {
 		case ACollider::SPHERE:{
 				const SphereCollider& sphere = reinterpret_cast<const SphereCollider&>(*coll);
-				return tool::Ray_SphereIntersection(pos, dir, limit, sphere.pos, sphere.r, out_P);
+				if (!tool::Ray_SphereIntersection(pos, dir, limit, sphere.pos, sphere.r, &P))
+					return false;
+				N = (sphere.r > 0 ? (P - sphere.pos) / sphere.r : -dir.Normal());
 			}
 			break;
 		case ACollider::AABOX:{
 				const AABoxCollider& aab = reinterpret_cast<const AABoxCollider&>(*coll);
-				return tool::Ray_AABoxIntersection(pos, dir, limit, aab.min, aab.max, out_P);
+				if (!tool::Ray_AABoxIntersection(pos, dir, limit, aab.min, aab.max, &P))
+					return false;
+				N = BoxNormal(P - (aab.min + aab.max) / 2.f, (aab.max - aab.min) / 2.f);
 			}
 			break;
 		case ACollider::OBOX:{
 				const OBoxCollider& ob = reinterpret_cast<const OBoxCollider&>(*coll);
-				return tool::Ray_OBoxIntersection(pos, dir, limit, ob.pos, ob.ext, ob.axis, out_P);
+				Vector3 ext, axis[3];
+				ob.GetOrthonormal(ext, axis);
+				if (!tool::Ray_OBoxIntersection(pos, dir, limit, ob.pos, ext, axis, &P))
+					return false;
+				const Vector3 d = P - ob.pos;
+				const Vector3 n = BoxNormal(Vector3(d.Dot(axis[0]), d.Dot(axis[1]), d.Dot(axis[2])), ext);
+				N = axis[0] * n.x + axis[1] * n.y + axis[2] * n.z;
 			}
 			break;
 		case ACollider::CONVEXHULL:{
@@ -42,22 +121,58 @@ namespace sark {
 					// it cannot be tested.
 					return false;
 				}
+				// test the ray in object space of the hull.
+				// the ray parameter is kept by affine transform, so the limit is the same.
+				const Matrix4& M = cvx.GetWorldMatrix();
+				const Matrix4 invM = M.AffineInverse();
+				const Vector3 localPos = (invM * Vector4(pos, 1.f)).xyz;
+				const Vector3 localDir = (invM * Vector4(dir, 0.f)).xyz;
+				const real dirSq = localDir.MagnitudeSq();
+
 				ConvexHull::FaceIterator fitr = faces.cbegin();
 				ConvexHull::FaceIterator fend = faces.cend();
-				const ConvexHull::PointSet points = cvx.GetTransPointSet();
+				const ConvexHull::PointSet& points = cvx.GetPointSet();
 
+				// the nearest face. the ray is clipped by each hit.
+				real nearest = limit;
+				Vector3 localP, localN;
+				bool hit = false;
 				for (; fitr != fend; fitr++) {
 					const Vector3& A = points[fitr->a];
 					const Vector3& B = points[fitr->b];
 					const Vector3& C = points[fitr->c];
-					if (tool::Ray_TriangleIntersection(pos, dir, limit, A, B, C, out_P)) {
-						return true;
+					if (tool::Ray_TriangleIntersection(localPos, localDir, nearest, A, B, C, &localP)) {
+						nearest = (localP - localPos).Dot(localDir) / dirSq;
+						localN = (B - A).Cross(C - A);
+						hit = true;
 					}
 				}
+				if (!hit)
+					return false;
+
+				// the parameter of the hit is the same in world space, and
+				// the normal is transformed by the transpose of the inverse.
+				P = pos + dir * nearest;
+				for (uinteger j = 0; j < 3; j++)
+					N.v[j] = invM.m[0][j] * localN.x + invM.m[1][j] * localN.y + invM.m[2][j] * localN.z;
+				N.Normalize();
+				if (N.Dot(dir) > 0)
+					N = -N;
 			}
 			break;
+		case ACollider::CAPSULE:
+			if (!SupportCast(*this, shape, P, N))
+				return false;
+			break;
+		case ACollider::TYPE_COUNT:
+			return false;
 		}
-		return false;
+
+		if (out_P != NULL)
+			*out_P = P;
+		if (out_N != NULL)
+			*out_N = N;
+		return true;
 	}
 
 }
\ No newline at end of file
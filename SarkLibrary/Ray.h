@@ -27,8 +27,14 @@ namespace sark {
 
 		// test intersection with collider
 		// and return intersected position if it does.
+		// *param:
+		//     coll  - collider by the last update.
+		//     out_P - the nearest intersected point.
+		//     out_N - unit normal of the collider at the point. it faces
+		//             the ray on the faces of convex hull.
+		// the colliders with margin are cast by GJK. (see ASupportShape::SetMargin)
 		bool IntersectWith(const ACollider* coll,
-			Vector3* out_P = NULL) const;
+			Vector3* out_P = NULL, Vector3* out_N = NULL) const;
 	};
 
 }
@@ -1,11 +1,32 @@
 #include "RigidBody.h"
 #include "ASceneComponent.h"
 #include "Transform.h"
+#include "fastmath.hpp"
+#ifndef SARKLIB_HEADLESS
 #include "Engine.h"
+#endif
 #include "Debug.h"
 
 namespace sark {
 
+	namespace {
+
+		// delta time of the frame.
+		// the headless build has no engine, so it steps by fixed 1/60 second.
+		inline real DeltaTime() {
+#ifndef SARKLIB_HEADLESS
+			return Engine::GetInstance()->GetTimer().GetDeltaTime();
+#else
+			return 1.f / 60.f;
+#endif
+		}
+
+	}
+
+	real RigidBody::SLEEP_LINEAR_VELOCITY = 0.2f;
+	real RigidBody::SLEEP_ANGULAR_VELOCITY = 0.2f;
+	real RigidBody::SLEEP_TIME = 0.5f;
+
 	RigidBody::RigidBody(ASceneComponent* reference,
 		const real invMass, const Matrix3& invI0,
 		const Vector3& velocity, const Vector3& angularVelocity,
@@ -13,7 +34,8 @@ namespace sark {
 		: mReference(reference), mInvMass(invMass), mInvI0(invI0),
 		mVelocity(velocity), mAngularVelocity(angularVelocity),
 		mGravityOn(gravityOn),
-		mForce(0.f), mTorque(0.f)
+		mForce(0.f), mTorque(0.f),
+		mAwake(true), mSleepTime(0), mBullet(false)
 	{
 		if (mReference == NULL) {
 			LogError("component reference can't be NULL for rigid body");
@@ -66,6 +88,8 @@ namespace sark {
 	// set current linear velocity.
 	void RigidBody::SetVelocity(const Vector3& velocity) {
 		mVelocity = velocity;
+		if (!mAwake)
+			SetAwake(true);
 	}
 
 	// get current angular velocity.
@@ -75,11 +99,15 @@ namespace sark {
 	// set current angular velocity.
 	void RigidBody::SetAngularVelocity(const Vector3& angularVelocity) {
 		mAngularVelocity = angularVelocity;
+		if (!mAwake)
+			SetAwake(true);
 	}
 
 	// add linear force to this rigid body.
 	void RigidBody::AddForce(const Vector3& force) {
 		mForce += force;
+		if (!mAwake)
+			SetAwake(true);
 	}
 
 	// add force which is affected onto the given position.
@@ -97,6 +125,8 @@ namespace sark {
 
 		mForce += linearF;
 		mTorque += r.Cross(force - linearF);
+		if (!mAwake)
+			SetAwake(true);
 	}
 
 	// is this body affected by gravity.
@@ -114,6 +144,60 @@ namespace sark {
 		return (mInvMass == 0);
 	}
 
+	// is this body awake?
+	bool RigidBody::IsAwake() const {
+		return mAwake;
+	}
+
+	// wake up or put to sleep.
+	void RigidBody::SetAwake(bool awake) {
+		if (awake) {
+			mAwake = true;
+			mSleepTime = 0;
+		}
+		else {
+			mAwake = false;
+			mVelocity = 0.f;
+			mAngularVelocity = 0.f;
+			mForce = 0.f;
+			mTorque = 0.f;
+		}
+	}
+
+	// is this body bullet?
+	bool RigidBody::IsBullet() const {
+		return mBullet;
+	}
+
+	// set this body to be bullet or not.
+	void RigidBody::SetBullet(bool bullet) {
+		mBullet = bullet;
+	}
+
+	// is this body awake and not fixed?
+	bool RigidBody::IsActive() const {
+		return (mAwake && mInvMass != 0);
+	}
+
+	// get how long the body has been still.
+	real RigidBody::GetSleepTime() const {
+		return mSleepTime;
+	}
+
+	// count the time while the velocities are under the thresholds.
+	void RigidBody::UpdateSleepTime() {
+		if (!mAwake || mInvMass == 0)
+			return;
+
+		const real linear = SLEEP_LINEAR_VELOCITY * SLEEP_LINEAR_VELOCITY;
+		const real angular = SLEEP_ANGULAR_VELOCITY * SLEEP_ANGULAR_VELOCITY;
+		if (mVelocity.MagnitudeSq() > linear || mAngularVelocity.MagnitudeSq() > angular) {
+			mSleepTime = 0;
+			return;
+		}
+		mSleepTime += DeltaTime();
+	}
+
 	// update translational terms and rotational terms.
 	void RigidBody::Update() {
 		if (mInvMass == 0) {
@@ -122,7 +206,11 @@ namespace sark {
 			return;
 		}
 
-		const real& dt = Engine::GetInstance()->GetTimer().GetDeltaTime();
+		// sleeping body keeps its place.
+		if (!mAwake)
+			return;
+
+		const real dt = DeltaTime();
 		Transform& transRef = mReference->GetTransform();
 
 		if (mGravityOn)
@@ -151,7 +239,7 @@ namespace sark {
 			//  = ||*t
 			real half_theta = magw*dt / 2.f;
 			Vector3 unitw = mAngularVelocity / magw;
-			Quaternion q_w(math::sin(half_theta)*unitw, math::cos(half_theta));
+			Quaternion q_w(math::fast::sin(half_theta)*unitw, math::fast::cos(half_theta));
 
 			// q(t+t) = q_w(t)q(t)
 			transRef.RotateMore(q_w);
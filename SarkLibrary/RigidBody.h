@@ -12,6 +12,16 @@ namespace sark {
 	// a solid body in which deformation is neglected."
 	// -wikipedia
 	class RigidBody {
+	public:
+		// a body is still when its velocities are under them.
+		// the linear one is above the velocity which gravity adds in a
+		// frame, since the resting contacts bounce by restitution.
+		static real SLEEP_LINEAR_VELOCITY;
+		static real SLEEP_ANGULAR_VELOCITY;
+
+		// seconds to be still before sleeping.
+		static real SLEEP_TIME;
+
 	private:
 		// it consider the scene component position
 		// as center of mass by default.
@@ -44,6 +54,16 @@ namespace sark {
 		// refernece pointer.
 		ASceneComponent* mReference;
 
+		// sleeping body is not integrated, and the contacts between
+		// sleeping (or fixed) bodies are not tested.
+		bool mAwake;
+
+		// how long the body has been still.
+		real mSleepTime;
+
+		// fast body, which is swept against the others. (see IsBullet)
+		bool mBullet;
+
 	public:
 		RigidBody(ASceneComponent* reference,
 			const real invMass, const Matrix3& invI0,
@@ -96,6 +116,34 @@ namespace sark {
 		// is this body fixed.
 		bool IsFixed() const;
 
+		// is this body awake? fixed body is never simulated, so it is
+		// also not active. (see IsActive)
+		bool IsAwake() const;
+		// wake up or put to sleep. sleeping body loses its velocities.
+		// *note: the forces and the velocities wake the sleeping body up
+		// without restarting the sleep time of the awake one. the
+		// islands of the contacts are woken and put to sleep together
+		// by the collision. (see Collision::ProcessConvexCollision)
+		void SetAwake(bool awake);
+
+		// is this body bullet?
+		// the motion of bullet on a frame is swept against the other
+		// convex bodies, and it stops at the first impact, so it does not
+		// pass through the thin bodies. (see Collision::ProcessConvexCollision)
+		bool IsBullet() const;
+		// set this body to be bullet or not.
+		void SetBullet(bool bullet);
+
+		// is this body awake and not fixed?
+		bool IsActive() const;
+
+		// get how long the body has been still.
+		real GetSleepTime() const;
+
+		// count the time while the velocities are under the thresholds.
+		// it is called after the contacts are resolved.
+		void UpdateSleepTime();
+
 		// update translational terms and rotational terms.
 		void Update();
 	};
@@ -2,6 +2,7 @@
 #include "Mesh.h"
 #include "RigidBody.h"
 #include "ACollider.h"
+#include "CollisionGeometry.h"
 #include "primitives.hpp"
 
 namespace sark {
@@ -59,6 +60,10 @@ namespace sark {
 			AttributeSemantic::INDICES, indices);
 
 		arrBuf.SetDrawMode(ArrayBuffer::DrawMode::TRIANGLES);
+
+		s_ptr<CollisionGeometry> geometry(new CollisionGeometry());
+		geometry->Build(&positions[0], positions.size(), &indices[0], indices.size());
+		SetCollisionGeometry(geometry);
 	}
 
 	// create sphere from given properties
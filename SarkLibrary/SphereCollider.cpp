@@ -1,8 +1,6 @@
 #include "SphereCollider.h"
 #include "tools.h"
 #include "ASceneComponent.h"
-#include "AABoxCollider.h"
-#include "OBoxCollider.h"
 
 namespace sark {
 
@@ -21,33 +19,33 @@ namespace sark {
 		return ACollider::SPHERE;
 	}
 
-	// intersection test.
-	bool SphereCollider::IntersectWith(const ACollider* coll) const {
-		switch (coll->GetType()) {
-		case ACollider::SPHERE:{
-				const SphereCollider& sphereB = reinterpret_cast<const SphereCollider&>(*coll);
-				return tool::Sphere_SphereIntersection(pos, r, sphereB.pos, sphereB.r);
-			}
-			break;
-		case ACollider::AABOX:{
-				const AABoxCollider& aab = reinterpret_cast<const AABoxCollider&>(*coll);
-				return tool::Sphere_AABoxIntersection(pos, r, aab.min, aab.max);
-			}
-			break;
-		case ACollider::OBOX:{
-				const OBoxCollider& ob = reinterpret_cast<const OBoxCollider&>(*coll);
-				return tool::Sphere_OBoxIntersection(pos, r, ob.pos, ob.ext, ob.axis);
-			}
-			break;
-		case ACollider::CONVEXHULL:
-			break;
-		}
-		return false;
-	}
-
 	// update sphere
 	void SphereCollider::Update() {
 		pos = mReference->GetTransform().GetPosition();
 	}
 
+	// get world space bounding box.
+	void SphereCollider::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		out_min = pos - (r + GetMargin());
+		out_max = pos + (r + GetMargin());
+	}
+
+	// sphere has no vertex.
+	uinteger SphereCollider::GetVertexCount() const {
+		return 0;
+	}
+
+	// get the center.
+	const Vector3 SphereCollider::GetWorldPoint(uinteger) const {
+		return pos;
+	}
+
+	// the point at the radius in the direction.
+	const Vector3 SphereCollider::CoreSupportPoint(const Vector3& direction, uinteger*) const {
+		const real len = direction.Magnitude();
+		if (len == 0)
+			return pos;
+		return pos + direction * (r / len);
+	}
+
 }
\ No newline at end of file
@@ -3,11 +3,16 @@
 
 #include "core.h"
 #include "ACollider.h"
+#include "ASupportShape.h"
 
 namespace sark {
 
 	// center and radius form of sphere
-	class SphereCollider : public ACollider {
+	class SphereCollider : public ACollider, public ASupportShape {
+	protected:
+		// the point at the radius in the direction.
+		const Vector3 CoreSupportPoint(const Vector3& direction, uinteger* inout_vertex) const override;
+
 	public:
 		// origin position of sphere
 		Vector3 pos;
@@ -22,11 +27,17 @@ namespace sark {
 		// get type of collider
 		const Type GetType() const override;
 
-		// intersection test.
-		bool IntersectWith(const ACollider* coll) const override;
-
 		// update sphere
 		void Update() override;
+
+		// get world space bounding box.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const override;
+
+		// sphere has no vertex.
+		uinteger GetVertexCount() const override;
+
+		// get the center.
+		const Vector3 GetWorldPoint(uinteger index) const override;
 	};
 
 }
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include "SweepAndPrune.h"
+#include "Debug.h"
+
+namespace sark {
+
+	namespace {
+
+		// order of end points. min is in front of max for the same value.
+		inline bool EndPointLess(real lv, uinteger ld, real rv, uinteger rd) {
+			return (lv < rv || (lv == rv && (ld & 1) < (rd & 1)));
+		}
+
+	}
+
+	SweepAndPrune::SweepAndPrune()
+		: mAddedCount(0), mRemovedCount(0) {}
+
+	SweepAndPrune::~SweepAndPrune() {}
+
+	// add proxy.
+	// its end points are put on the back, and moved on the next sort.
+	SweepAndPrune::ProxyID SweepAndPrune::AddProxy(const Vector3& min, const Vector3& max, uinteger userData) {
+		ProxyID id;
+		if (mFreeProxies.empty()) {
+			id = mProxies.size();
+			mProxies.push_back(Proxy());
+		}
+		else {
+			id = mFreeProxies.back();
+			mFreeProxies.pop_back();
+		}
+		Proxy& proxy = mProxies[id];
+		proxy.min = min;
+		proxy.max = max;
+		proxy.userData = userData;
+		proxy.alive = true;
+
+		for (uinteger a = 0; a < 3; a++) {
+			EndPoint ep;
+			ep.value = min.v[a];
+			ep.data = id << 1;
+			mEndPoints[a].push_back(ep);
+
+			ep.value = max.v[a];
+			ep.data = (id << 1) | 1;
+			mEndPoints[a].push_back(ep);
+		}
+		mAddedCount++;
+		return id;
+	}
+
+	// remove proxy.
+	// the id is not reused until its end points are dropped.
+	void SweepAndPrune::RemoveProxy(ProxyID proxy) {
+		ONLYDBG_CODEBLOCK(
+		if (proxy >= mProxies.size() || !mProxies[proxy].alive) {
+			LogWarn("invalid proxy");
+			return;
+		}
+		);
+		mProxies[proxy].alive = false;
+		mRemovedCount++;
+	}
+
+	// update bounding box of proxy.
+	void SweepAndPrune::UpdateProxy(ProxyID proxy, const Vector3& min, const Vector3& max) {
+		mProxies[proxy].min = min;
+		mProxies[proxy].max = max;
+	}
+
+	// change user data of proxy.
+	void SweepAndPrune::SetUserData(ProxyID proxy, uinteger userData) {
+		mProxies[proxy].userData = userData;
+	}
+
+	// get user data of proxy.
+	uinteger SweepAndPrune::GetUserData(ProxyID proxy) const {
+		return mProxies[proxy].userData;
+	}
+
+	// get the number of proxies.
+	uinteger SweepAndPrune::GetProxyCount() const {
+		return mEndPoints[0].size() / 2 - mRemovedCount;
+	}
+
+	// remove all proxies.
+	void SweepAndPrune::Clear() {
+		mProxies.clear();
+		mFreeProxies.clear();
+		for (uinteger a = 0; a < 3; a++)
+			mEndPoints[a].clear();
+		ClearPairs();
+		mAddedCount = 0;
+		mRemovedCount = 0;
+	}
+
+	// overlap test of the current bounding boxes.
+	bool SweepAndPrune::Overlap(ProxyID a, ProxyID b) const {
+		const Proxy& A = mProxies[a];
+		const Proxy& B = mProxies[b];
+		for (uinteger i = 0; i < 3; i++) {
+			if (A.min.v[i] > B.max.v[i] || A.max.v[i] < B.min.v[i])
+				return false;
+		}
+		return true;
+	}
+
+	// drop the end points and pairs of the removed proxies.
+	void SweepAndPrune::RemoveDeadProxies() {
+		for (uinteger a = 0; a < 3; a++) {
+			std::vector<EndPoint>& eps = mEndPoints[a];
+			uinteger n = 0;
+			for (uinteger i = 0; i < eps.size(); i++) {
+				if (!mProxies[eps[i].data >> 1].alive) {
+					// free the id once, at its min point on x axis.
+					if (a == 0 && (eps[i].data & 1) == 0)
+						mFreeProxies.push_back(eps[i].data >> 1);
+					continue;
+				}
+				eps[n++] = eps[i];
+			}
+			eps.resize(n);
+		}
+
+		uinteger n = 0;
+		for (uinteger i = 0; i < mProxyPairs.size(); i++) {
+			const ProxyPair& pair = mProxyPairs[i];
+			if (mProxies[pair.a].alive && mProxies[pair.b].alive) {
+				mPairIndices[PairKey(pair.a, pair.b)] = n;
+				mProxyPairs[n++] = pair;
+			}
+			else {
+				mPairIndices.erase(PairKey(pair.a, pair.b));
+			}
+		}
+		mProxyPairs.resize(n);
+		mRemovedCount = 0;
+	}
+
+	// sort the end points and find all the pairs from scratch.
+	void SweepAndPrune::Rebuild() {
+		for (uinteger a = 0; a < 3; a++) {
+			std::vector<EndPoint>& eps = mEndPoints[a];
+			for (auto& ep : eps) {
+				const Proxy& proxy = mProxies[ep.data >> 1];
+				ep.value = (ep.data & 1) ? proxy.max.v[a] : proxy.min.v[a];
+			}
+			std::sort(eps.begin(), eps.end(), [](const EndPoint& l, const EndPoint& r) {
+				return EndPointLess(l.value, l.data, r.value, r.data);
+			});
+		}
+
+		// sweep on x axis. the proxies opened before a min point
+		// overlap with its proxy on x axis.
+		mProxyPairs.clear();
+		mPairIndices.clear();
+		std::vector<ProxyID> open;
+		for (auto& ep : mEndPoints[0]) {
+			const ProxyID id = ep.data >> 1;
+			if (ep.data & 1) {
+				open.erase(std::find(open.begin(), open.end(), id));
+				continue;
+			}
+			for (auto other : open) {
+				if (Overlap(id, other))
+					AddPair(id, other);
+			}
+			open.push_back(id);
+		}
+	}
+
+	// update the order of an axis by insertion sort.
+	// when a min point passes over a max point of another proxy, both
+	// proxies begin or end to overlap on the axis. the pair is added if
+	// they overlap on all the axes, or it is removed.
+	void SweepAndPrune::SortAxis(uinteger axis) {
+		std::vector<EndPoint>& eps = mEndPoints[axis];
+		for (auto& ep : eps) {
+			const Proxy& proxy = mProxies[ep.data >> 1];
+			ep.value = (ep.data & 1) ? proxy.max.v[axis] : proxy.min.v[axis];
+		}
+
+		const uinteger count = eps.size();
+		for (uinteger i = 1; i < count; i++) {
+			const EndPoint key = eps[i];
+			if (!EndPointLess(key.value, key.data, eps[i - 1].value, eps[i - 1].data))
+				continue;
+
+			const ProxyID keyId = key.data >> 1;
+			const bool keyIsMax = (key.data & 1) != 0;
+			uinteger j = i;
+			do {
+				const EndPoint& prev = eps[j - 1];
+				const ProxyID prevId = prev.data >> 1;
+				const bool prevIsMax = (prev.data & 1) != 0;
+
+				// key moves toward the front over prev.
+				if (keyId == prevId) {
+					// inverted box of a proxy. it never makes a pair.
+				}
+				else if (!keyIsMax && prevIsMax) {
+					if (Overlap(keyId, prevId))
+						AddPair(keyId, prevId);
+				}
+				else if (keyIsMax && !prevIsMax) {
+					// the pair can exist only if they overlap on the axes to
+					// sort next, or their sort removes it. it saves the most
+					// of the lookups of the pairs, which do not exist.
+					const Proxy& A = mProxies[keyId];
+					const Proxy& B = mProxies[prevId];
+					bool separated = false;
+					for (uinteger a = axis + 1; a < 3 && !separated; a++)
+						separated = (A.min.v[a] > B.max.v[a] || A.max.v[a] < B.min.v[a]);
+					if (!separated)
+						RemovePair(keyId, prevId);
+				}
+
+				eps[j] = prev;
+				j--;
+			} while (j > 0 && EndPointLess(key.value, key.data, eps[j - 1].value, eps[j - 1].data));
+
+			eps[j] = key;
+		}
+	}
+
+	// update the order by the bounding boxes and get the overlapping pairs.
+	const SweepAndPrune::PairArray& SweepAndPrune::FindPairs() {
+		if (mRemovedCount > 0)
+			RemoveDeadProxies();
+
+		// insertion sort is nearly linear for the coherent frames,
+		// but not for many new proxies, e.g. the first frame.
+		const uinteger count = mEndPoints[0].size() / 2;
+		if (mAddedCount * 8 > count) {
+			Rebuild();
+		}
+		else {
+			for (uinteger a = 0; a < 3; a++)
+				SortAxis(a);
+		}
+		mAddedCount = 0;
+
+		mPairs.resize(mProxyPairs.size());
+		for (uinteger i = 0; i < mProxyPairs.size(); i++) {
+			const uinteger a = mProxies[mProxyPairs[i].a].userData;
+			const uinteger b = mProxies[mProxyPairs[i].b].userData;
+			mPairs[i].a = (a < b ? a : b);
+			mPairs[i].b = (a < b ? b : a);
+		}
+		return mPairs;
+	}
+
+}
@@ -0,0 +1,92 @@
+#ifndef __SWEEP_AND_PRUNE_H__
+#define __SWEEP_AND_PRUNE_H__
+
+#include <vector>
+#include "core.h"
+#include "ABroadphase.h"
+
+namespace sark {
+
+	// incremental sweep and prune broad-phase.
+	// it keeps the end points of the proxies (axis aligned boxes)
+	// sorted on each axis, and the overlapping pairs over frames.
+	// since the bodies move a little between frames, insertion sort
+	// updates the order in nearly linear time, and only the swaps of
+	// end points on the sort add or remove the pairs.
+	//   proxy = sap.AddProxy(min, max, userData);
+	//   ... every frame ...
+	//   sap.UpdateProxy(proxy, min, max);
+	//   const SweepAndPrune::PairArray& pairs = sap.FindPairs();
+	class SweepAndPrune : public ABroadphase {
+	private:
+		struct Proxy {
+			Vector3 min, max;
+			uinteger userData;
+			bool alive;
+		};
+
+		// end point of a proxy on an axis.
+		// 'data' is (proxy id << 1 | 1 if it is max).
+		struct EndPoint {
+			real value;
+			uinteger data;
+		};
+
+		std::vector<Proxy> mProxies;
+		std::vector<ProxyID> mFreeProxies;
+
+		// sorted end points of each axis.
+		// min is in front of max for the same value, so the touching
+		// boxes overlap as AABox_AABoxIntersection.
+		std::vector<EndPoint> mEndPoints[3];
+
+		uinteger mAddedCount;
+		uinteger mRemovedCount;
+
+		bool Overlap(ProxyID a, ProxyID b) const;
+
+		// drop the end points and pairs of the removed proxies.
+		void RemoveDeadProxies();
+
+		// sort the end points and find all the pairs from scratch.
+		void Rebuild();
+
+		// update the order of an axis by insertion sort.
+		void SortAxis(uinteger axis);
+
+	public:
+		SweepAndPrune();
+		virtual ~SweepAndPrune();
+
+		// add proxy.
+		// *param:
+		//     min,max  - world space bounding box.
+		//     userData - value which is emitted as the pair.
+		// *return: id of the proxy.
+		virtual ProxyID AddProxy(const Vector3& min, const Vector3& max, uinteger userData);
+
+		// remove proxy.
+		virtual void RemoveProxy(ProxyID proxy);
+
+		// update bounding box of proxy.
+		virtual void UpdateProxy(ProxyID proxy, const Vector3& min, const Vector3& max);
+
+		// change user data of proxy.
+		virtual void SetUserData(ProxyID proxy, uinteger userData);
+
+		// get user data of proxy.
+		virtual uinteger GetUserData(ProxyID proxy) const;
+
+		// get the number of proxies.
+		virtual uinteger GetProxyCount() const;
+
+		// remove all proxies.
+		virtual void Clear();
+
+		// update the order by the bounding boxes and get the overlapping pairs.
+		// the pairs are not sorted.
+		virtual const PairArray& FindPairs();
+	};
+
+}
+#endif
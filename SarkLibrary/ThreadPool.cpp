@@ -0,0 +1,150 @@
+#include "ThreadPool.h"
+
+namespace sark {
+
+	namespace {
+
+		inline uint64 PackRange(uinteger front, uinteger back) {
+			return ((uint64)front << 32) | back;
+		}
+
+	}
+
+	ThreadPool::ThreadPool(uinteger threadCount)
+		: mThreadCount(threadCount), mBody(NULL), mCount(0), mGrain(1),
+		mGeneration(0), mRunningWorkers(0), mQuit(false)
+	{
+		if (mThreadCount == 0) {
+			mThreadCount = std::thread::hardware_concurrency();
+			if (mThreadCount == 0)
+				mThreadCount = 1;
+		}
+
+		mQueues.reset(new WorkQueue[mThreadCount]);
+		for (uinteger i = 0; i < mThreadCount; i++)
+			mQueues[i].range.store(0);
+		for (uinteger i = 1; i < mThreadCount; i++)
+			mThreads.push_back(std::thread(&ThreadPool::WorkerMain, this, i));
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQuit = true;
+		}
+		mWakeCondition.notify_all();
+		for (auto& t : mThreads)
+			t.join();
+	}
+
+	// get the number of workers, including the calling thread.
+	uinteger ThreadPool::GetThreadCount() const {
+		return mThreadCount;
+	}
+
+	// wait for a loop, and run it.
+	void ThreadPool::WorkerMain(uinteger worker) {
+		uint64 generation = 0;
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mWakeCondition.wait(lock, [&]() { return mQuit || mGeneration != generation; });
+				if (mQuit)
+					return;
+				generation = mGeneration;
+			}
+
+			RunWorker(worker);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (--mRunningWorkers == 0)
+				mDoneCondition.notify_one();
+		}
+	}
+
+	bool ThreadPool::PopFront(uinteger worker, uinteger& out_chunk) {
+		std::atomic<uint64>& range = mQueues[worker].range;
+		uint64 r = range.load();
+		for (;;) {
+			const uinteger front = (uinteger)(r >> 32);
+			const uinteger back = (uinteger)r;
+			if (front >= back)
+				return false;
+			if (range.compare_exchange_weak(r, PackRange(front + 1, back))) {
+				out_chunk = front;
+				return true;
+			}
+		}
+	}
+
+	bool ThreadPool::StealBack(uinteger victim, uinteger& out_chunk) {
+		std::atomic<uint64>& range = mQueues[victim].range;
+		uint64 r = range.load();
+		for (;;) {
+			const uinteger front = (uinteger)(r >> 32);
+			const uinteger back = (uinteger)r;
+			if (front >= back)
+				return false;
+			if (range.compare_exchange_weak(r, PackRange(front, back - 1))) {
+				out_chunk = back - 1;
+				return true;
+			}
+		}
+	}
+
+	// run the chunks of own queue, and steal the others.
+	// no chunk is added while the loop runs, so the worker is done
+	// when all the queues are empty.
+	void ThreadPool::RunWorker(uinteger worker) {
+		uinteger chunk;
+		for (;;) {
+			bool found = PopFront(worker, chunk);
+			for (uinteger i = 1; !found && i < mThreadCount; i++)
+				found = StealBack((worker + i) % mThreadCount, chunk);
+			if (!found)
+				return;
+
+			const uinteger begin = chunk * mGrain;
+			const uinteger end = (begin + mGrain < mCount ? begin + mGrain : mCount);
+			(*mBody)(begin, end, worker);
+		}
+	}
+
+	// run body over [0, count) in parallel and wait for it.
+	void ThreadPool::ParallelFor(uinteger count, uinteger grain, const RangeBody& body) {
+		if (count == 0)
+			return;
+		if (grain == 0)
+			grain = 1;
+
+		const uinteger chunks = (count + grain - 1) / grain;
+		if (mThreadCount == 1 || chunks == 1) {
+			body(0, count, 0);
+			return;
+		}
+
+		// even share of the chunks for each worker.
+		for (uinteger i = 0; i < mThreadCount; i++) {
+			const uinteger front = (uinteger)((uint64)chunks * i / mThreadCount);
+			const uinteger back = (uinteger)((uint64)chunks * (i + 1) / mThreadCount);
+			mQueues[i].range.store(PackRange(front, back));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mBody = &body;
+			mCount = count;
+			mGrain = grain;
+			mRunningWorkers = mThreadCount - 1;
+			mGeneration++;
+		}
+		mWakeCondition.notify_all();
+
+		RunWorker(0);
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		mDoneCondition.wait(lock, [&]() { return mRunningWorkers == 0; });
+		mBody = NULL;
+	}
+
+}
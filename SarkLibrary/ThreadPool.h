@@ -0,0 +1,84 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include "core.h"
+#include "IUncopiable.hpp"
+
+namespace sark {
+
+	// pool of the worker threads which run parallel loops by work stealing.
+	// the range of a loop is split into the chunks, and each worker gets
+	// an even share of them in its own queue. a worker takes the chunks
+	// from the front of its queue, and steals from the back of the others
+	// when its queue is empty, so the uneven chunks are balanced.
+	// the calling thread works as worker 0 and the threads are kept
+	// over the loops, so a small loop does not pay for thread creation.
+	//   ThreadPool pool(4);
+	//   pool.ParallelFor(count, 16, [&](uinteger begin, uinteger end, uinteger worker) { ... });
+	class ThreadPool : public IUncopiable {
+	public:
+		// body of parallel loop.
+		// it processes [begin, end) of the range on the worker.
+		// worker is in [0, GetThreadCount()), to index the per-thread data.
+		typedef std::function<void(uinteger begin, uinteger end, uinteger worker)> RangeBody;
+
+	private:
+		// chunk range of a worker. (front << 32 | back)
+		// the owner pops the front and the thieves pop the back,
+		// both by compare-and-swap on the same word.
+		// it is padded to a cache line against false sharing.
+		struct WorkQueue {
+			std::atomic<uint64> range;
+			char padding[64 - sizeof(std::atomic<uint64>)];
+		};
+
+		std::vector<std::thread> mThreads;
+		std::unique_ptr<WorkQueue[]> mQueues;
+		uinteger mThreadCount;
+
+		// the loop in progress.
+		const RangeBody* mBody;
+		uinteger mCount;
+		uinteger mGrain;
+
+		std::mutex mMutex;
+		std::condition_variable mWakeCondition;
+		std::condition_variable mDoneCondition;
+		uint64 mGeneration;
+		uinteger mRunningWorkers;
+		bool mQuit;
+
+		void WorkerMain(uinteger worker);
+
+		// run the chunks of own queue, and steal the others.
+		void RunWorker(uinteger worker);
+
+		bool PopFront(uinteger worker, uinteger& out_chunk);
+		bool StealBack(uinteger victim, uinteger& out_chunk);
+
+	public:
+		// threadCount includes the calling thread. 0 means hardware concurrency.
+		explicit ThreadPool(uinteger threadCount = 0);
+		~ThreadPool();
+
+		// get the number of workers, including the calling thread.
+		uinteger GetThreadCount() const;
+
+		// run body over [0, count) in parallel and wait for it.
+		// *param:
+		//     count - size of the range.
+		//     grain - the number of indices in a chunk. (1 or more)
+		//     body  - body of the loop. (see RangeBody)
+		// *note: it should not be called from the body.
+		void ParallelFor(uinteger count, uinteger grain, const RangeBody& body);
+	};
+
+}
+#endif
@@ -196,8 +196,9 @@ namespace sark {
 				mAbsoluteTM = mLocalTM;
 			}
 			else {
+				// both are TRS matrices, so affine product is enough.
 				mAbsoluteTM
-					= mReference->mParent->mTransform.GetMatrix() * mLocalTM;
+					= mReference->mParent->mTransform.GetMatrix().AffineMul(mLocalTM);
 			}
 		}
 	}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include "TriangleBVH.h"
+
+namespace sark {
+
+	TriangleBVH::TriangleBVH() {}
+
+	bool TriangleBVH::Overlap(const Vector3& amin, const Vector3& amax, const Vector3& bmin, const Vector3& bmax) {
+		return (amin.x <= bmax.x && bmin.x <= amax.x
+			&& amin.y <= bmax.y && bmin.y <= amax.y
+			&& amin.z <= bmax.z && bmin.z <= amax.z);
+	}
+
+	// build the nodes of mFaces.
+	void TriangleBVH::Build() {
+		mNodes.clear();
+		if (mFaces.empty())
+			return;
+
+		std::vector<Vector3> centers(mFaces.size());
+		for (uinteger i = 0; i < mFaces.size(); i++)
+			centers[i] = (mPoints[mFaces[i].a] + mPoints[mFaces[i].b] + mPoints[mFaces[i].c]) / 3.f;
+
+		// a binary tree of leaves of LEAF_SIZE / 2 or more triangles.
+		mNodes.reserve(2 * (mFaces.size() / (LEAF_SIZE / 2) + 1));
+		BuildNode(0, mFaces.size(), centers);
+	}
+
+	// build the subtree of the faces [begin, end).
+	// the faces are split at the median of the centroids on the longest
+	// axis, so the depth is log2 of the number of leaves.
+	void TriangleBVH::BuildNode(uinteger begin, uinteger end, std::vector<Vector3>& centers) {
+		const uinteger nodeIndex = mNodes.size();
+		mNodes.push_back(Node());
+
+		Vector3 min = mPoints[mFaces[begin].a];
+		Vector3 max = min;
+		Vector3 cmin = centers[begin];
+		Vector3 cmax = cmin;
+		for (uinteger i = begin; i < end; i++) {
+			for (uinteger k = 0; k < 3; k++) {
+				const Position3& P = mPoints[mFaces[i].idx[k]];
+				for (uinteger a = 0; a < 3; a++) {
+					min.v[a] = math::min(min.v[a], P.v[a]);
+					max.v[a] = math::max(max.v[a], P.v[a]);
+				}
+			}
+			for (uinteger a = 0; a < 3; a++) {
+				cmin.v[a] = math::min(cmin.v[a], centers[i].v[a]);
+				cmax.v[a] = math::max(cmax.v[a], centers[i].v[a]);
+			}
+		}
+		mNodes[nodeIndex].min = min;
+		mNodes[nodeIndex].max = max;
+
+		if (end - begin <= LEAF_SIZE) {
+			mNodes[nodeIndex].index = begin;
+			mNodes[nodeIndex].count = end - begin;
+			return;
+		}
+
+		uinteger axis = 0;
+		const Vector3 extent = cmax - cmin;
+		if (extent.y > extent.v[axis])
+			axis = 1;
+		if (extent.z > extent.v[axis])
+			axis = 2;
+
+		// sort the faces and their centroids together by the indices.
+		const uinteger mid = begin + (end - begin) / 2;
+		std::vector<uinteger> order(end - begin);
+		for (uinteger i = 0; i < order.size(); i++)
+			order[i] = begin + i;
+		std::nth_element(order.begin(), order.begin() + (mid - begin), order.end(),
+			[&](uinteger l, uinteger r) { return centers[l].v[axis] < centers[r].v[axis]; });
+		std::vector<TriangleFace32> faces(order.size());
+		std::vector<Vector3> sortedCenters(order.size());
+		for (uinteger i = 0; i < order.size(); i++) {
+			faces[i] = mFaces[order[i]];
+			sortedCenters[i] = centers[order[i]];
+		}
+		std::copy(faces.begin(), faces.end(), mFaces.begin() + begin);
+		std::copy(sortedCenters.begin(), sortedCenters.end(), centers.begin() + begin);
+
+		BuildNode(begin, mid, centers);
+		mNodes[nodeIndex].index = mNodes.size();
+		mNodes[nodeIndex].count = 0;
+		BuildNode(mid, end, centers);
+	}
+
+	// remove all triangles.
+	void TriangleBVH::Clear() {
+		mNodes.clear();
+		mPoints.clear();
+		mFaces.clear();
+	}
+
+	// is it empty?
+	bool TriangleBVH::Empty() const {
+		return mFaces.empty();
+	}
+
+	// get the number of triangles.
+	uinteger TriangleBVH::GetTriangleCount() const {
+		return mFaces.size();
+	}
+
+	// get world space triangle.
+	void TriangleBVH::GetWorldTriangle(uinteger index, const Matrix4& TM,
+		Position3& out_A, Position3& out_B, Position3& out_C) const
+	{
+		Position3* out[3] = { &out_A, &out_B, &out_C };
+		for (uinteger k = 0; k < 3; k++) {
+			const Position3& P = mPoints[mFaces[index].idx[k]];
+			*out[k] = Position3(
+				TM.m[0][0] * P.x + TM.m[0][1] * P.y + TM.m[0][2] * P.z + TM.m[0][3],
+				TM.m[1][0] * P.x + TM.m[1][1] * P.y + TM.m[1][2] * P.z + TM.m[1][3],
+				TM.m[2][0] * P.x + TM.m[2][1] * P.y + TM.m[2][2] * P.z + TM.m[2][3]);
+		}
+	}
+
+	// get object space bounding box of the whole triangles.
+	void TriangleBVH::GetBounds(Vector3& out_min, Vector3& out_max) const {
+		if (mNodes.empty()) {
+			out_min = out_max = Vector3(0.f);
+			return;
+		}
+		out_min = mNodes[0].min;
+		out_max = mNodes[0].max;
+	}
+
+}
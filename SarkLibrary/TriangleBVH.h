@@ -0,0 +1,181 @@
+#ifndef __TRIANGLE_BVH_H__
+#define __TRIANGLE_BVH_H__
+
+#include <vector>
+#include "core.h"
+#include "primitives.hpp"
+#include "IUncopiable.hpp"
+#include "tools.h"
+#include "Debug.h"
+
+namespace sark {
+
+	// bounding volume hierarchy of the triangles of a mesh.
+	// it is built once in object space, from a copy of the positions and
+	// the faces, so it is kept over the frames while the mesh moves.
+	// two of them are traversed together under the relative transform,
+	// and only the triangles of the overlapping leaves are reported.
+	//   bvh.Build(&positions[0], positions.size(), &faces[0], faces.size());
+	//   bvh1.FindOverlaps(TM1, bvh2, TM2, [&](uinteger tri1, uinteger tri2) { ... });
+	class TriangleBVH : public IUncopiable {
+	public:
+		// the maximum number of triangles in a leaf.
+		static const uinteger LEAF_SIZE = 4;
+
+	private:
+		// the maximum depth of traversal.
+		static const uinteger STACK_SIZE = 256;
+
+		// nodes are in depth first order. the first child of an inner node
+		// is the next node, and 'index' is the second one.
+		struct Node {
+			Vector3 min, max;
+
+			// first triangle of leaf, or the second child of inner node.
+			uinteger index;
+
+			// the number of triangles of leaf. inner node is 0.
+			uinteger count;
+
+			bool IsLeaf() const { return count != 0; }
+		};
+
+		std::vector<Node> mNodes;
+		std::vector<Position3> mPoints;
+
+		// faces in the order of the leaves.
+		std::vector<TriangleFace32> mFaces;
+
+		// build the subtree of the faces [begin, end).
+		// 'centers' are the centroids of mFaces.
+		void BuildNode(uinteger begin, uinteger end, std::vector<Vector3>& centers);
+
+		void Build();
+
+		static bool Overlap(const Vector3& amin, const Vector3& amax, const Vector3& bmin, const Vector3& bmax);
+
+	public:
+		TriangleBVH();
+
+		// build the hierarchy of the faces.
+		// _Face is TriangleFace16 or TriangleFace32.
+		// *param:
+		//     points     - object space positions.
+		//     pointCount - the number of positions.
+		//     faces      - triangle indices of positions.
+		//     faceCount  - the number of faces.
+		template<class _Face>
+		void Build(const Position3* points, uinteger pointCount, const _Face* faces, uinteger faceCount);
+
+		// remove all triangles.
+		void Clear();
+
+		// is it empty?
+		bool Empty() const;
+
+		// get the number of triangles.
+		uinteger GetTriangleCount() const;
+
+		// get world space triangle.
+		// *param:
+		//     index - index of triangle, as reported by FindOverlaps.
+		//     TM    - world transform of the mesh.
+		//     out_A,out_B,out_C - three points of the triangle.
+		void GetWorldTriangle(uinteger index, const Matrix4& TM,
+			Position3& out_A, Position3& out_B, Position3& out_C) const;
+
+		// get object space bounding box of the whole triangles.
+		void GetBounds(Vector3& out_min, Vector3& out_max) const;
+
+		// visit the pairs of triangles whose leaves overlap.
+		// the boxes of the other hierarchy are transformed into the object
+		// space of this one, and the overlap tests are conservative.
+		// *param:
+		//     TM1      - world transform of this hierarchy.
+		//     other    - the other hierarchy.
+		//     TM2      - world transform of the other one.
+		//     callback - void(uinteger tri1, uinteger tri2). the indices are
+		//                for GetWorldTriangle of each hierarchy.
+		template<class _Callback>
+		void FindOverlaps(const Matrix4& TM1, const TriangleBVH& other, const Matrix4& TM2,
+			_Callback callback) const;
+	};
+
+
+	//----- template implementation of TriangleBVH -----//
+
+	// build the hierarchy of the faces.
+	template<class _Face>
+	void TriangleBVH::Build(const Position3* points, uinteger pointCount, const _Face* faces, uinteger faceCount) {
+		mPoints.assign(points, points + pointCount);
+		mFaces.resize(faceCount);
+		for (uinteger i = 0; i < faceCount; i++)
+			mFaces[i] = TriangleFace32(faces[i].a, faces[i].b, faces[i].c);
+		Build();
+	}
+
+	// visit the pairs of triangles whose leaves overlap.
+	template<class _Callback>
+	void TriangleBVH::FindOverlaps(const Matrix4& TM1, const TriangleBVH& other, const Matrix4& TM2,
+		_Callback callback) const
+	{
+		if (mNodes.empty() || other.mNodes.empty())
+			return;
+
+		// object space of the other one to this one.
+		const Matrix4 R = TM1.AffineInverse().AffineMul(TM2);
+
+		// pairs of this and the other node.
+		struct NodePair {
+			uinteger node1, node2;
+		};
+		NodePair stack[STACK_SIZE];
+		uinteger top = 0;
+		stack[top].node1 = 0;
+		stack[top++].node2 = 0;
+
+		Vector3 min2, max2;
+		while (top > 0) {
+			const NodePair pair = stack[--top];
+			const Node& node1 = mNodes[pair.node1];
+			const Node& node2 = other.mNodes[pair.node2];
+			tool::TransformAABox(R, node2.min, node2.max, min2, max2);
+			if (!Overlap(node1.min, node1.max, min2, max2))
+				continue;
+
+			if (node1.IsLeaf() && node2.IsLeaf()) {
+				for (uinteger i = 0; i < node1.count; i++) {
+					for (uinteger j = 0; j < node2.count; j++)
+						callback(node1.index + i, node2.index + j);
+				}
+				continue;
+			}
+
+			ONLYDBG_CODEBLOCK(
+			if (top + 2 > STACK_SIZE) {
+				LogFatal("hierarchy is too deep");
+				return;
+			}
+			);
+
+			// descend the inner node, or the larger one of two inner nodes.
+			bool descend1 = node2.IsLeaf();
+			if (!node1.IsLeaf() && !node2.IsLeaf())
+				descend1 = ((node1.max - node1.min).MagnitudeSq() >= (max2 - min2).MagnitudeSq());
+			if (descend1) {
+				stack[top].node1 = pair.node1 + 1;
+				stack[top++].node2 = pair.node2;
+				stack[top].node1 = node1.index;
+				stack[top++].node2 = pair.node2;
+			}
+			else {
+				stack[top].node1 = pair.node1;
+				stack[top++].node2 = pair.node2 + 1;
+				stack[top].node1 = pair.node1;
+				stack[top++].node2 = node2.index;
+			}
+		}
+	}
+
+}
+#endif
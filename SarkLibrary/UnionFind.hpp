@@ -0,0 +1,64 @@
+#ifndef __UNION_FIND_HPP__
+#define __UNION_FIND_HPP__
+
+#include <vector>
+#include "core.h"
+
+namespace sark {
+
+	// disjoint sets of the elements [0, count).
+	// the simulation islands are the sets of the bodies joined by
+	// the contacts.
+	//   sets.Reset(bodyCount);
+	//   sets.Union(a, b);
+	//   if (sets.Find(a) == sets.Find(c)) { ... }
+	class UnionFind {
+	private:
+		std::vector<uinteger> mParents;
+		std::vector<uinteger> mSizes;
+
+	public:
+		UnionFind() {}
+
+		// make each element its own set.
+		void Reset(uinteger count) {
+			mParents.resize(count);
+			mSizes.assign(count, 1);
+			for (uinteger i = 0; i < count; i++)
+				mParents[i] = i;
+		}
+
+		// get the number of elements.
+		uinteger Count() const {
+			return mParents.size();
+		}
+
+		// get the representative element of the set.
+		// the path is halved on the way, so the trees stay flat.
+		uinteger Find(uinteger x) {
+			while (mParents[x] != x) {
+				mParents[x] = mParents[mParents[x]];
+				x = mParents[x];
+			}
+			return x;
+		}
+
+		// merge the sets of two elements.
+		// the smaller set goes under the larger one.
+		void Union(uinteger a, uinteger b) {
+			a = Find(a);
+			b = Find(b);
+			if (a == b)
+				return;
+			if (mSizes[a] < mSizes[b]) {
+				uinteger t = a;
+				a = b;
+				b = t;
+			}
+			mParents[b] = a;
+			mSizes[a] += mSizes[b];
+		}
+	};
+
+}
+#endif
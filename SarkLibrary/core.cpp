@@ -2,6 +2,8 @@
 #include <memory.h>
 
 #include "core.h"
+#include "simd.hpp"
+#include "fastmath.hpp"
 #include "Debug.h"
 
 
@@ -12,21 +14,6 @@ namespace sark{
 	Type of vector 2D
 	*/
 
-	Vector2::Vector2() :x(0.0f), y(0.0f)
-	{ }
-	Vector2::Vector2(real val) : x(val), y(val)
-	{ }
-	Vector2::Vector2(real _x, real _y)
-		: x(_x), y(_y)
-	{ }
-	Vector2::Vector2(const Vector2& v){
-		x = v.x; y = v.y;
-	}
-	Vector2& Vector2::operator=(const Vector2& v){
-		x = v.x; y = v.y;
-		return *this;
-	}
-
 	void Vector2::Set(real _x, real _y){
 		x = _x; y = _y;
 	}
@@ -195,128 +182,18 @@ namespace sark{
 		return Vector2(fConstant * v.x, fConstant * v.y);
 	}
 
-	// x-axis right
-	const Vector2 Vector2::Right(1, 0);
-	// y-axis up
-	const Vector2 Vector2::Up(0, 1);
-
-	// general gravity force. 9.8 m/s^2 of negative y-axis
-	const Vector2 Vector2::Gravity(0, -9.80665f);
-
 
 
 	/**
 	Type of vector 3D
 	*/
 
-	Vector3::Vector3() :x(0.0f), y(0.0f), z(0.0f)
-	{ }
-	Vector3::Vector3(real val) : x(val), y(val), z(val)
-	{ }
-	Vector3::Vector3(real _x, real _y, real _z)
-		: x(_x), y(_y), z(_z)
-	{ }
-	Vector3::Vector3(const Vector3& v){
-		x = v.x; y = v.y; z = v.z;
-	}
-	Vector3& Vector3::operator=(const Vector3& v){
-		x = v.x; y = v.y; z = v.z;
-		return *this;
-	}
-
-	void Vector3::Set(real _x, real _y, real _z){
-		x = _x; y = _y; z = _z;
-	}
-
 	// explicitly type cast
 	Vector3::Vector3(const Vector2& v){
 		x = v.x; y = v.y; z = 0.0f;
 	}
 
 
-	// vector magnitude
-	real Vector3::Magnitude() const{
-		return math::sqrt(math::sqre(x) + math::sqre(y) + math::sqre(z));
-	}
-
-	real Vector3::MagnitudeSq() const{
-		return math::sqre(x) + math::sqre(y) + math::sqre(z);
-	}
-
-	// unary - operator
-	const Vector3 Vector3::operator-() const{
-		return Vector3(-x, -y, -z);
-	}
-
-
-	// vector plus operator
-	const Vector3 Vector3::operator+(const Vector3& v) const{
-		return Vector3(x + v.x, y + v.y, z + v.z);
-	}
-
-	Vector3& Vector3::operator+=(const Vector3& v){
-		x += v.x; y += v.y; z += v.z;
-		return *this;
-	}
-
-	const Vector3 Vector3::operator+(real fConstant) const{
-		return Vector3(x + fConstant, y + fConstant, z + fConstant);
-	}
-
-	Vector3& Vector3::operator+=(real fConstant){
-		x += fConstant; y += fConstant; z += fConstant;
-		return *this;
-	}
-
-
-	// vector minus operator
-	const Vector3 Vector3::operator-(const Vector3& v) const{
-		return Vector3(x - v.x, y - v.y, z - v.z);
-	}
-
-	Vector3& Vector3::operator-=(const Vector3& v){
-		x -= v.x; y -= v.y; z -= v.z;
-		return *this;
-	}
-
-	const Vector3 Vector3::operator-(real fConstant) const{
-		return Vector3(x - fConstant, y - fConstant, z - fConstant);
-	}
-
-	Vector3& Vector3::operator-=(real fConstant){
-		x -= fConstant; y -= fConstant; z -= fConstant;
-		return *this;
-	}
-
-
-	// vector constant multiplication operator (it is not cross operation)
-	const Vector3 Vector3::operator*(const Vector3& v) const{
-		return Vector3(x*v.x, y*v.y, z*v.z);
-	}
-
-	Vector3& Vector3::operator*=(const Vector3& v){
-		x *= v.x; y *= v.y; z *= v.z;
-		return *this;
-	}
-
-	const Vector3 Vector3::operator*(real fConstant) const{
-		return Vector3(x*fConstant, y*fConstant, z*fConstant);
-	}
-
-	Vector3& Vector3::operator*=(real fConstant){
-		x *= fConstant; y *= fConstant; z *= fConstant;
-		return *this;
-	}
-
-
-	// vector x matrix
-	const Vector3 Vector3::operator*(const Matrix3& mat3) const{
-		return Vector3(
-			x*mat3.m[0][0] + y*mat3.m[1][0] + z*mat3.m[2][0],
-			x*mat3.m[0][1] + y*mat3.m[1][1] + z*mat3.m[2][1],
-			x*mat3.m[0][2] + y*mat3.m[1][2] + z*mat3.m[2][2]);
-	}
-
 	// vector x matrix for this
 	Vector3& Vector3::operator*=(const Matrix3& mat3){
 		Set(x*mat3.m[0][0] + y*mat3.m[1][0] + z*mat3.m[2][0],
@@ -364,35 +241,27 @@ namespace sark{
 		return (x == 0.0f && y == 0.0f && z == 0.0f);
 	}
 
-	// dot product
-	real Vector3::Dot(const Vector3& v) const{
-		return x*v.x + y*v.y + z*v.z;
-	}
-
-	// cross product
-	const Vector3 Vector3::Cross(const Vector3& v) const{
-		return Vector3(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x);
-	}
-
 
 	// get normal and normalize this
 	const Vector3 Vector3::Normal() const{
-		real mag = Magnitude();
+		real magSq = MagnitudeSq();
 		ONLYDBG_CODEBLOCK(
-		if (math::real_equal(mag, 0.f))
+		if (magSq < math::EPSILON * math::EPSILON)
 			LogFatal("division by zero");
 		);
-		return Vector3(x / mag, y / mag, z / mag);
+		real invMag = math::fast::rsqrt(magSq);
+		return Vector3(x * invMag, y * invMag, z * invMag);
 	}
 	void Vector3::Normalize(){
-		real mag = Magnitude();
+		real magSq = MagnitudeSq();
 		ONLYDBG_CODEBLOCK(
-		if (math::real_equal(mag, 0.f))
+		if (magSq < math::EPSILON * math::EPSILON)
 			LogFatal("division by zero");
 		);
-		x /= mag;
-		y /= mag;
-		z /= mag;
+		real invMag = math::fast::rsqrt(magSq);
+		x *= invMag;
+		y *= invMag;
+		z *= invMag;
 	}
 
 
@@ -403,69 +272,19 @@ namespace sark{
 
 	// calculate radians of given two vectors
 	real Vector3::Angle(const Vector3& v1, const Vector3& v2){
-		return math::acos(v1.Normal().Dot(v2.Normal()));
+		return math::fast::acos(v1.Normal().Dot(v2.Normal()));
 	}
 
-	// Vector3 friend operators
-	const Vector3 operator+(real fConstant, const Vector3& v){
-		return Vector3(fConstant + v.x, fConstant + v.y, fConstant + v.z);
-	}
-
-	const Vector3 operator-(real fConstant, const Vector3& v){
-		return Vector3(fConstant - v.x, fConstant - v.y, fConstant - v.z);
-	}
-
-	const Vector3 operator*(real fConstant, const Vector3& v){
-		return Vector3(fConstant * v.x, fConstant * v.y, fConstant * v.z);
-	}
-
-	// x-axis right
-	const Vector3 Vector3::Right(1, 0, 0);
-	// y-axis up
-	const Vector3 Vector3::Up(0, 1, 0);
-	// negative z-axis forward
-	const Vector3 Vector3::Forward(0, 0, -1);
-
-	// general gravity force. 9.8 m/s^2 of negative y-axis
-	const Vector3 Vector3::Gravity(0, -9.80665f, 0);
-
 
 
 	/**
 	Type of vector 4D
 	*/
 
-	Vector4::Vector4(){
-		x = 0.0f; y = 0.0f; z = 0.0f; w = 0.0f;
-	}
-	Vector4::Vector4(real val){
-		x = y = z = w = val;
-	}
-	Vector4::Vector4(real _x, real _y, real _z, real _w){
-		x = _x; y = _y; z = _z; w = _w;
-	}
-	Vector4::Vector4(const Vector3& vec3, real _w){
-		xyz = vec3; w = _w;
-	}
-	Vector4::Vector4(const Vector4& v){
-		x = v.x; y = v.y; z = v.z; w = v.w;
-	}
-	Vector4& Vector4::operator=(const Vector4& v){
-		x = v.x; y = v.y; z = v.z; w = v.w;
-		return *this;
-	}
-
 	void Vector4::Set(real _x, real _y, real _z, real _w){
 		x = _x; y = _y; z = _z; w = _w;
 	}
 
-	// explicitly type cast
-	Vector4::Vector4(const Vector2& v){
-		x = v.x; y = v.y; z = 0.0f; w = 0.0f;
-	}
-	Vector4::Vector4(const Vector3& v){
-		x = v.x; y = v.y; z = v.z; w = 0.0f;
-	}
 
 
 	// vector magnitude
@@ -485,12 +304,23 @@ namespace sark{
 
 	// vector plus operator
 	const Vector4 Vector4::operator+(const Vector4& v) const{
+#ifdef SARKLIB_USING_SIMD
+		Vector4 out;
+		simd::store(out.v, simd::add(simd::load(this->v), simd::load(v.v)));
+		return out;
+#else
 		return Vector4(x + v.x, y + v.y, z + v.z, w + v.w);
+#endif
 	}
 
 	Vector4& Vector4::operator+=(const Vector4& v){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(this->v, simd::add(simd::load(this->v), simd::load(v.v)));
+		return *this;
+#else
 		x += v.x; y += v.y; z += v.z; w += v.w;
 		return *this;
+#endif
 	}
 
 	const Vector4 Vector4::operator+(real fConstant) const{
@@ -505,12 +335,23 @@ namespace sark{
 
 	// vector minus operator
 	const Vector4 Vector4::operator-(const Vector4& v) const{
+#ifdef SARKLIB_USING_SIMD
+		Vector4 out;
+		simd::store(out.v, simd::sub(simd::load(this->v), simd::load(v.v)));
+		return out;
+#else
 		return Vector4(x - v.x, y - v.y, z - v.z, w - v.w);
+#endif
 	}
 
 	Vector4& Vector4::operator-=(const Vector4& v){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(this->v, simd::sub(simd::load(this->v), simd::load(v.v)));
+		return *this;
+#else
 		x -= v.x; y -= v.y; z -= v.z; w -= v.w;
 		return *this;
+#endif
 	}
 
 	const Vector4 Vector4::operator-(real fConstant) const{
@@ -525,40 +366,73 @@ namespace sark{
 
 	// vector constant multiplication operator (it is not cross operation)
 	const Vector4 Vector4::operator*(const Vector4& v) const{
+#ifdef SARKLIB_USING_SIMD
+		Vector4 out;
+		simd::store(out.v, simd::mul(simd::load(this->v), simd::load(v.v)));
+		return out;
+#else
 		return Vector4(x*v.x, y*v.y, z*v.z, w*v.w);
+#endif
 	}
 
 	Vector4& Vector4::operator*=(const Vector4& v){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(this->v, simd::mul(simd::load(this->v), simd::load(v.v)));
+		return *this;
+#else
 		x *= v.x; y *= v.y; z *= v.z; w *= v.w;
 		return *this;
+#endif
 	}
 
 	const Vector4 Vector4::operator*(real fConstant) const{
+#ifdef SARKLIB_USING_SIMD
+		Vector4 out;
+		simd::store(out.v, simd::mul(simd::load(v), simd::splat(fConstant)));
+		return out;
+#else
 		return Vector4(x*fConstant, y*fConstant, z*fConstant, w*fConstant);
+#endif
 	}
 
 	Vector4& Vector4::operator*=(real fConstant){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(v, simd::mul(simd::load(v), simd::splat(fConstant)));
+		return *this;
+#else
 		x *= fConstant; y *= fConstant; z *= fConstant; w *= fConstant;
 		return *this;
+#endif
 	}
 
 
 	// vector x matrix
 	const Vector4 Vector4::operator*(const Matrix4& mat4) const{
+#ifdef SARKLIB_USING_SIMD
+		Vector4 out;
+		simd::store(out.v, simd::mul_vec4x4(simd::load(v), &mat4.m[0][0]));
+		return out;
+#else
 		return Vector4(
 			x*mat4.m[0][0] + y*mat4.m[1][0] + z*mat4.m[2][0] + w*mat4.m[3][0],
 			x*mat4.m[0][1] + y*mat4.m[1][1] + z*mat4.m[2][1] + w*mat4.m[3][1],
 			x*mat4.m[0][2] + y*mat4.m[1][2] + z*mat4.m[2][2] + w*mat4.m[3][2],
 			x*mat4.m[0][3] + y*mat4.m[1][3] + z*mat4.m[2][3] + w*mat4.m[3][3]);
+#endif
 	}
 
 	// vector x matrix for this
 	Vector4& Vector4::operator*=(const Matrix4& mat4){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(v, simd::mul_vec4x4(simd::load(v), &mat4.m[0][0]));
+		return *this;
+#else
 		Set(x*mat4.m[0][0] + y*mat4.m[1][0] + z*mat4.m[2][0] + w*mat4.m[3][0],
 			x*mat4.m[0][1] + y*mat4.m[1][1] + z*mat4.m[2][1] + w*mat4.m[3][1],
 			x*mat4.m[0][2] + y*mat4.m[1][2] + z*mat4.m[2][2] + w*mat4.m[3][2],
 			x*mat4.m[0][3] + y*mat4.m[1][3] + z*mat4.m[2][3] + w*mat4.m[3][3]);
 		return *this;
+#endif
 	}
 
 
@@ -603,7 +477,11 @@ namespace sark{
 
 	// dot product
 	real Vector4::Dot(const Vector4& v) const{
+#ifdef SARKLIB_USING_SIMD
+		return simd::dot(simd::load(this->v), simd::load(v.v));
+#else
 		return x*v.x + y*v.y + z*v.z + w*v.w;
+#endif
 	}
 
 	// get normal and normalize this
@@ -652,31 +530,9 @@ namespace sark{
 	Type of 3x3 square matrix defined as row X col order
 	*/
 
-	Matrix3::Matrix3(real diagonal){
-		memset(m, 0, sizeof(real)* 9);
-		m[0][0] = m[1][1] = m[2][2] = diagonal;
-	}
-	Matrix3::Matrix3(real _00, real _01, real _02,
-		real _10, real _11, real _12,
-		real _20, real _21, real _22)
-	{
-		m[0][0] = _00; m[0][1] = _01; m[0][2] = _02;
-		m[1][0] = _10; m[1][1] = _11; m[1][2] = _12;
-		m[2][0] = _20; m[2][1] = _21; m[2][2] = _22;
-	}
 	Matrix3::Matrix3(real** mat3){
 		memcpy(m, mat3, sizeof(real)* 9);
 	}
-	Matrix3::Matrix3(const Vector3& row0, const Vector3& row1, const Vector3& row2){
-		row[0] = row0; row[1] = row1; row[2] = row2;
-	}
-	Matrix3::Matrix3(const Matrix3& mat3){
-		memcpy(m, mat3.m, sizeof(real)* 9);
-	}
-	Matrix3& Matrix3::operator=(const Matrix3& mat3){
-		memcpy(m, mat3.m, sizeof(real)* 9);
-		return *this;
-	}
 
 	// set matrix elements
 	void Matrix3::Set(real _00, real _01, real _02,
@@ -760,13 +616,6 @@ namespace sark{
 		return *this;
 	}
 
-	const Vector3 Matrix3::operator*(const Vector3& vec3) const{
-		return Vector3(
-			m[0][0] * vec3.x + m[0][1] * vec3.y + m[0][2] * vec3.z,
-			m[1][0] * vec3.x + m[1][1] * vec3.y + m[1][2] * vec3.z,
-			m[2][0] * vec3.x + m[2][1] * vec3.y + m[2][2] * vec3.z
-			);
-	}
 
 	const Matrix3 Matrix3::operator*(real fConstant) const{
 		return Matrix3(
@@ -944,38 +793,9 @@ namespace sark{
 	Type of 4x4 square matrix defined as row X col order
 	*/
 
-	Matrix4::Matrix4(real diagonal){
-		memset(m, 0, sizeof(real)* 16);
-		m[0][0] = m[1][1] = m[2][2] = m[3][3] = diagonal;
-		
-	}
-	Matrix4::Matrix4(real _00, real _01, real _02, real _03,
-		real _10, real _11, real _12, real _13,
-		real _20, real _21, real _22, real _23,
-		real _30, real _31, real _32, real _33)
-	{
-		m[0][0] = _00; m[0][1] = _01; m[0][2] = _02; m[0][3] = _03;
-		m[1][0] = _10; m[1][1] = _11; m[1][2] = _12; m[1][3] = _13;
-		m[2][0] = _20; m[2][1] = _21; m[2][2] = _22; m[2][3] = _23;
-		m[3][0] = _30; m[3][1] = _31; m[3][2] = _32; m[3][3] = _33;
-	}
 	Matrix4::Matrix4(real** mat4){
 		memcpy(m, mat4, sizeof(real)* 16);
 	}
-	Matrix4::Matrix4(const Vector4& row0,
-		const Vector4& row1,
-		const Vector4& row2,
-		const Vector4& row3)
-	{
-		row[0] = row0; row[1] = row1; row[2] = row2; row[3] = row3;
-	}
-	Matrix4::Matrix4(const Matrix4& mat4){
-		memcpy(m, mat4.m, sizeof(real)* 16);
-	}
-	Matrix4& Matrix4::operator=(const Matrix4& mat4){
-		memcpy(m, mat4.m, sizeof(real)* 16);
-		return *this;
-	}
 
 	Matrix4::Matrix4(const Matrix3& mat3){
 		m[0][0] = mat3.m[0][0]; m[0][1] = mat3.m[0][1]; m[0][2] = mat3.m[0][2]; m[0][3] = 0.0f;
@@ -1012,11 +832,18 @@ namespace sark{
 
 	// matrix plus operator
 	const Matrix4 Matrix4::operator+(const Matrix4& mat4) const{
+#ifdef SARKLIB_USING_SIMD
+		Matrix4 out;
+		for (int i = 0; i < 4; i++)
+			simd::store(out.m[i], simd::add(simd::load(m[i]), simd::load(mat4.m[i])));
+		return out;
+#else
 		return Matrix4(
 			m[0][0] + mat4.m[0][0], m[0][1] + mat4.m[0][1], m[0][2] + mat4.m[0][2], m[0][3] + mat4.m[0][3],
 			m[1][0] + mat4.m[1][0], m[1][1] + mat4.m[1][1], m[1][2] + mat4.m[1][2], m[1][3] + mat4.m[1][3],
 			m[2][0] + mat4.m[2][0], m[2][1] + mat4.m[2][1], m[2][2] + mat4.m[2][2], m[2][3] + mat4.m[2][3],
 			m[3][0] + mat4.m[3][0], m[3][1] + mat4.m[3][1], m[3][2] + mat4.m[3][2], m[3][3] + mat4.m[3][3]);
+#endif
 	}
 
 	Matrix4& Matrix4::operator+=(const Matrix4& mat4){
@@ -1030,11 +857,18 @@ namespace sark{
 
 	// matrix minus operator
 	const Matrix4 Matrix4::operator-(const Matrix4& mat4) const{
+#ifdef SARKLIB_USING_SIMD
+		Matrix4 out;
+		for (int i = 0; i < 4; i++)
+			simd::store(out.m[i], simd::sub(simd::load(m[i]), simd::load(mat4.m[i])));
+		return out;
+#else
 		return Matrix4(
 			m[0][0] - mat4.m[0][0], m[0][1] - mat4.m[0][1], m[0][2] - mat4.m[0][2], m[0][3] - mat4.m[0][3],
 			m[1][0] - mat4.m[1][0], m[1][1] - mat4.m[1][1], m[1][2] - mat4.m[1][2], m[1][3] - mat4.m[1][3],
 			m[2][0] - mat4.m[2][0], m[2][1] - mat4.m[2][1], m[2][2] - mat4.m[2][2], m[2][3] - mat4.m[2][3],
 			m[3][0] - mat4.m[3][0], m[3][1] - mat4.m[3][1], m[3][2] - mat4.m[3][2], m[3][3] - mat4.m[3][3]);
+#endif
 	}
 
 	Matrix4& Matrix4::operator-=(const Matrix4& mat4){
@@ -1047,6 +881,8 @@ namespace sark{
 
 
 	// matrix multiply operator
+	// the scalar product is used with SARKLIB_USING_SIMD too. the compiler
+	// vectorizes it as well as the hand-written SSE rows, and it was not slower.
 	const Matrix4 Matrix4::operator*(const Matrix4& mat4) const{
 		return Matrix4(
 			m[0][0] * mat4.m[0][0] + m[0][1] * mat4.m[1][0] + m[0][2] * mat4.m[2][0] + m[0][3] * mat4.m[3][0],
@@ -1094,20 +930,34 @@ namespace sark{
 	}
 
 	const Vector4 Matrix4::operator*(const Vector4& vec4) const{
+#ifdef SARKLIB_USING_SIMD
+		Vector4 out;
+		simd::store(out.v, simd::mul4x4_vec(&m[0][0], simd::load(vec4.v)));
+		return out;
+#else
 		return Vector4(
 			m[0][0] * vec4.x + m[0][1] * vec4.y + m[0][2] * vec4.z + m[0][3] * vec4.w,
 			m[1][0] * vec4.x + m[1][1] * vec4.y + m[1][2] * vec4.z + m[1][3] * vec4.w,
 			m[2][0] * vec4.x + m[2][1] * vec4.y + m[2][2] * vec4.z + m[2][3] * vec4.w,
 			m[3][0] * vec4.x + m[3][1] * vec4.y + m[3][2] * vec4.z + m[3][3] * vec4.w
 			);
+#endif
 	}
 
 	const Matrix4 Matrix4::operator*(real fConstant) const{
+#ifdef SARKLIB_USING_SIMD
+		Matrix4 out;
+		simd::real4 c = simd::splat(fConstant);
+		for (int i = 0; i < 4; i++)
+			simd::store(out.m[i], simd::mul(simd::load(m[i]), c));
+		return out;
+#else
 		return Matrix4(
 			m[0][0] * fConstant, m[0][1] * fConstant, m[0][2] * fConstant, m[0][3] * fConstant,
 			m[1][0] * fConstant, m[1][1] * fConstant, m[1][2] * fConstant, m[1][3] * fConstant,
 			m[2][0] * fConstant, m[2][1] * fConstant, m[2][2] * fConstant, m[2][3] * fConstant,
 			m[3][0] * fConstant, m[3][1] * fConstant, m[3][2] * fConstant, m[3][3] * fConstant);
+#endif
 	}
 
 	Matrix4& Matrix4::operator*=(real fConstant){
@@ -1169,19 +1019,38 @@ namespace sark{
 
 	// get transposition of this matrix
 	const Matrix4 Matrix4::Transposition() const{
+#ifdef SARKLIB_USING_SIMD
+		simd::real4 r0 = simd::load(m[0]), r1 = simd::load(m[1]);
+		simd::real4 r2 = simd::load(m[2]), r3 = simd::load(m[3]);
+		simd::transpose(r0, r1, r2, r3);
+
+		Matrix4 out;
+		simd::store(out.m[0], r0); simd::store(out.m[1], r1);
+		simd::store(out.m[2], r2); simd::store(out.m[3], r3);
+		return out;
+#else
 		return Matrix4(
 			m[0][0], m[1][0], m[2][0], m[3][0],
 			m[0][1], m[1][1], m[2][1], m[3][1],
 			m[0][2], m[1][2], m[2][2], m[3][2],
 			m[0][3], m[1][3], m[2][3], m[3][3]);
+#endif
 	}
 
 	// transpose this matrix
 	void Matrix4::Transpose(){
+#ifdef SARKLIB_USING_SIMD
+		simd::real4 r0 = simd::load(m[0]), r1 = simd::load(m[1]);
+		simd::real4 r2 = simd::load(m[2]), r3 = simd::load(m[3]);
+		simd::transpose(r0, r1, r2, r3);
+		simd::store(m[0], r0); simd::store(m[1], r1);
+		simd::store(m[2], r2); simd::store(m[3], r3);
+#else
 		Set(m[0][0], m[1][0], m[2][0], m[3][0],
 			m[0][1], m[1][1], m[2][1], m[3][1],
 			m[0][2], m[1][2], m[2][2], m[3][2],
 			m[0][3], m[1][3], m[2][3], m[3][3]);
+#endif
 	}
 
 	// matrix cofactor matrix
@@ -1235,6 +1104,18 @@ namespace sark{
 
 	// matrix inverse
 	const Matrix4 Matrix4::Inverse() const{
+#ifdef SARKLIB_SIMD_SSE
+		Matrix4 out;
+		real det = simd::inverse4x4(&m[0][0], &out.m[0][0]);
+		(void)det; // only checked on debug.
+
+		ONLYDBG_CODEBLOCK(
+		if (det == 0.f)
+			LogFatal("uninvertible matrix");
+		);
+
+		return out;
+#else
 		const Matrix4 adjM = this->Adjugate();
 		real det = m[0][0] * adjM.m[0][0] + m[0][1] * adjM.m[1][0] + m[0][2] * adjM.m[2][0] + m[0][3] * adjM.m[3][0];
 
@@ -1244,6 +1125,7 @@ namespace sark{
 		);
 
 		return adjM / det;
+#endif
 	}
 
 	// matrix determination
@@ -1294,6 +1176,87 @@ namespace sark{
 		}
 	}
 
+	// check if the last row is (0, 0, 0, 1)
+	bool Matrix4::IsAffine() const{
+		return (m[3][0] == 0.0f && m[3][1] == 0.0f && m[3][2] == 0.0f && m[3][3] == 1.0f);
+	}
+
+	// affine transform product. (this x mat4)
+	const Matrix4 Matrix4::AffineMul(const Matrix4& mat4) const{
+#ifdef SARKLIB_USING_SIMD
+		Matrix4 out;
+		simd::mul3x4(&m[0][0], &mat4.m[0][0], &out.m[0][0]);
+		return out;
+#else
+		// the last row of mat4 is (0, 0, 0, 1), so each row adds the
+		// vector (0, 0, 0, translation) instead of the fourth product.
+		// the rows keep the same form as the full product, so they are
+		// vectorized in the same way.
+		return Matrix4(
+			m[0][0] * mat4.m[0][0] + m[0][1] * mat4.m[1][0] + m[0][2] * mat4.m[2][0] + 0.0f,
+			m[0][0] * mat4.m[0][1] + m[0][1] * mat4.m[1][1] + m[0][2] * mat4.m[2][1] + 0.0f,
+			m[0][0] * mat4.m[0][2] + m[0][1] * mat4.m[1][2] + m[0][2] * mat4.m[2][2] + 0.0f,
+			m[0][0] * mat4.m[0][3] + m[0][1] * mat4.m[1][3] + m[0][2] * mat4.m[2][3] + m[0][3],
+
+			m[1][0] * mat4.m[0][0] + m[1][1] * mat4.m[1][0] + m[1][2] * mat4.m[2][0] + 0.0f,
+			m[1][0] * mat4.m[0][1] + m[1][1] * mat4.m[1][1] + m[1][2] * mat4.m[2][1] + 0.0f,
+			m[1][0] * mat4.m[0][2] + m[1][1] * mat4.m[1][2] + m[1][2] * mat4.m[2][2] + 0.0f,
+			m[1][0] * mat4.m[0][3] + m[1][1] * mat4.m[1][3] + m[1][2] * mat4.m[2][3] + m[1][3],
+
+			m[2][0] * mat4.m[0][0] + m[2][1] * mat4.m[1][0] + m[2][2] * mat4.m[2][0] + 0.0f,
+			m[2][0] * mat4.m[0][1] + m[2][1] * mat4.m[1][1] + m[2][2] * mat4.m[2][1] + 0.0f,
+			m[2][0] * mat4.m[0][2] + m[2][1] * mat4.m[1][2] + m[2][2] * mat4.m[2][2] + 0.0f,
+			m[2][0] * mat4.m[0][3] + m[2][1] * mat4.m[1][3] + m[2][2] * mat4.m[2][3] + m[2][3],
+
+			0.0f, 0.0f, 0.0f, 1.0f);
+#endif
+	}
+
+	// inverse of affine transform.
+	const Matrix4 Matrix4::AffineInverse() const{
+		// cofactors of upper-left 3x3 part
+		real c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+		real c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+		real c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+		real det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+
+		ONLYDBG_CODEBLOCK(
+		if (det == 0.f)
+			LogFatal("uninvertible matrix");
+		);
+
+		real invDet = 1.0f / det;
+		Matrix4 inv(
+			c00 * invDet,
+			(m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet,
+			(m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet,
+			0.0f,
+			c01 * invDet,
+			(m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet,
+			(m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet,
+			0.0f,
+			c02 * invDet,
+			(m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet,
+			(m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet,
+			0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f);
+
+		// -inv(A)t
+		inv.m[0][3] = -(inv.m[0][0] * m[0][3] + inv.m[0][1] * m[1][3] + inv.m[0][2] * m[2][3]);
+		inv.m[1][3] = -(inv.m[1][0] * m[0][3] + inv.m[1][1] * m[1][3] + inv.m[1][2] * m[2][3]);
+		inv.m[2][3] = -(inv.m[2][0] * m[0][3] + inv.m[2][1] * m[1][3] + inv.m[2][2] * m[2][3]);
+		return inv;
+	}
+
+	// inverse of rigid transform.
+	const Matrix4 Matrix4::RigidInverse() const{
+		return Matrix4(
+			m[0][0], m[1][0], m[2][0], -(m[0][0] * m[0][3] + m[1][0] * m[1][3] + m[2][0] * m[2][3]),
+			m[0][1], m[1][1], m[2][1], -(m[0][1] * m[0][3] + m[1][1] * m[1][3] + m[2][1] * m[2][3]),
+			m[0][2], m[1][2], m[2][2], -(m[0][2] * m[0][3] + m[1][2] * m[1][3] + m[2][2] * m[2][3]),
+			0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
 	const Matrix4 operator*(real fConstant, const Matrix4& mat4){
 		return Matrix4(
 			mat4.m[0][0] * fConstant, mat4.m[0][1] * fConstant, mat4.m[0][2] * fConstant, mat4.m[0][3] * fConstant,
@@ -1320,24 +1283,6 @@ namespace sark{
 	Type of quaternion
 	*/
 
-	Quaternion::Quaternion(){
-		s = 0.0f;
-		x = y = z = 0.0f;
-	}
-	Quaternion::Quaternion(real _x, real _y, real _z, real _s){
-		s = _s;
-		x = _x; y = _y; z = _z;
-	}
-
-	Quaternion::Quaternion(const Vector3& v, real _s){
-		s = _s;
-		x = v.x; y = v.y; z = v.z;
-	}
-	Quaternion::Quaternion(const Vector2& v, real _z, real _s){
-		s = _s;
-		x = v.x; y = v.y; z = _z;
-	}
-
 	Quaternion::Quaternion(const Vector3& rotationAxis, real theta, bool axis_normalized){
 		MakeRotatingQuat(rotationAxis, theta, axis_normalized);
 	}
@@ -1353,13 +1298,6 @@ namespace sark{
 	}
 
 
-	Quaternion::Quaternion(const Quaternion& q){
-		s = q.s; x = q.x; y = q.y; z = q.z;
-	}
-	Quaternion& Quaternion::operator=(const Quaternion& q){
-		s = q.s; x = q.x; y = q.y; z = q.z;
-		return *this;
-	}
 
 	void Quaternion::Set(real _x, real _y, real _z, real _s){
 		s = _s;
@@ -1379,38 +1317,88 @@ namespace sark{
 
 	// quaternion plus operation
 	const Quaternion Quaternion::operator+(const Quaternion& q) const{
+#ifdef SARKLIB_USING_SIMD
+		Quaternion out;
+		simd::store(&out.x, simd::add(simd::load(&x), simd::load(&q.x)));
+		return out;
+#else
 		return Quaternion(x + q.x, y + q.y, z + q.z, s + q.s);
+#endif
 	}
 	Quaternion& Quaternion::operator+=(const Quaternion& q){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(&x, simd::add(simd::load(&x), simd::load(&q.x)));
+		return *this;
+#else
 		s += q.s;
 		x += q.x; y += q.y; z += q.z;
 		return *this;
+#endif
 	}
 
 	// quaternion minus operation
 	const Quaternion Quaternion::operator-(const Quaternion& q) const{
+#ifdef SARKLIB_USING_SIMD
+		Quaternion out;
+		simd::store(&out.x, simd::sub(simd::load(&x), simd::load(&q.x)));
+		return out;
+#else
 		return Quaternion(x - q.x, y - q.y, z - q.z, s - q.s);
+#endif
 	}
 	Quaternion& Quaternion::operator-=(const Quaternion& q){
+#ifdef SARKLIB_USING_SIMD
+		simd::store(&x, simd::sub(simd::load(&x), simd::load(&q.x)));
+		return *this;
+#else
 		s -= q.s;
 		x -= q.x; y -= q.y; z -= q.z;
 		return *this;
+#endif
 	}
 
 	// Hamilton product: [s1, v1]*[s2, v2] = [s1*s2 - dot(v1,v2), s1*v2 + s2*v1 + cross(v1,v2)]
 	const Quaternion Quaternion::operator*(const Quaternion& q) const{
+#ifdef SARKLIB_USING_SIMD
+		// each lane of (x, y, z, s) is sum of four terms:
+		// s*(qx, qy, qz, qs) + x*(qs, -qz, qy, -qx) + y*(qz, qs, -qx, -qy) + z*(-qy, qx, qs, -qz)
+		const simd::real4 a = simd::load(&x);
+		const simd::real4 b = simd::load(&q.x);
+		simd::real4 r = simd::mul(simd::lane<3>(a), b);
+		r = simd::madd(simd::mul(simd::lane<0>(a), simd::reverse(b)), simd::set(1.f, -1.f, 1.f, -1.f), r);
+		r = simd::madd(simd::mul(simd::lane<1>(a), simd::swap_halves(b)), simd::set(1.f, 1.f, -1.f, -1.f), r);
+		r = simd::madd(simd::mul(simd::lane<2>(a), simd::swap_pairs(b)), simd::set(-1.f, 1.f, 1.f, -1.f), r);
+
+		Quaternion out;
+		simd::store(&out.x, r);
+		return out;
+#else
 		return Quaternion(
 			s*q.x + x*q.s + y*q.z - z*q.y,
 			s*q.y - x*q.z + y*q.s + z*q.x,
 			s*q.z + x*q.y - y*q.x + z*q.s,
 			s*q.s - x*q.x - y*q.y - z*q.z);
+#endif
 	}
 	Quaternion& Quaternion::operator*=(const Quaternion& q){
+#ifdef SARKLIB_USING_SIMD
+		// each lane of (x, y, z, s) is sum of four terms:
+		// s*(qx, qy, qz, qs) + x*(qs, -qz, qy, -qx) + y*(qz, qs, -qx, -qy) + z*(-qy, qx, qs, -qz)
+		const simd::real4 a = simd::load(&x);
+		const simd::real4 b = simd::load(&q.x);
+		simd::real4 r = simd::mul(simd::lane<3>(a), b);
+		r = simd::madd(simd::mul(simd::lane<0>(a), simd::reverse(b)), simd::set(1.f, -1.f, 1.f, -1.f), r);
+		r = simd::madd(simd::mul(simd::lane<1>(a), simd::swap_halves(b)), simd::set(1.f, 1.f, -1.f, -1.f), r);
+		r = simd::madd(simd::mul(simd::lane<2>(a), simd::swap_pairs(b)), simd::set(-1.f, 1.f, 1.f, -1.f), r);
+		simd::store(&x, r);
+		return *this;
+#else
 		Set(s*q.x + x*q.s + y*q.z - z*q.y,
 			s*q.y - x*q.z + y*q.s + z*q.x,
 			s*q.z + x*q.y - y*q.x + z*q.s,
 			s*q.s - x*q.x - y*q.y - z*q.z);
 		return *this;
+#endif
 	}
 
 	// quaternion constant multiplication operator
@@ -1440,7 +1428,11 @@ namespace sark{
 
 	// quaternion dot product
 	real Quaternion::Dot(const Quaternion& q) const{
+#ifdef SARKLIB_USING_SIMD
+		return simd::dot(simd::load(&x), simd::load(&q.x));
+#else
 		return x*q.x + y*q.y + z*q.z + s*q.s;
+#endif
 	}
 
 	// get conjugation
@@ -1462,24 +1454,48 @@ namespace sark{
 
 	// get normalized quaternion of this
 	const Quaternion Quaternion::Normal() const{
-		real mag = Magnitude();
+#ifdef SARKLIB_USING_SIMD
+		const simd::real4 a = simd::load(&x);
+		real magSq = simd::dot(a, a);
+		ONLYDBG_CODEBLOCK(
+		if (magSq == 0.f)
+			LogFatal("division by zero");
+		);
+		Quaternion out;
+		simd::store(&out.x, simd::mul(a, simd::splat(math::fast::rsqrt(magSq))));
+		return out;
+#else
+		real magSq = MagnitudeSq();
 		ONLYDBG_CODEBLOCK(
-		if (mag == 0.f)
+		if (magSq == 0.f)
 			LogFatal("division by zero");
 		);
-		return Quaternion(x / mag, y / mag, z / mag, s / mag);
+		real invMag = math::fast::rsqrt(magSq);
+		return Quaternion(x * invMag, y * invMag, z * invMag, s * invMag);
+#endif
 	}
 	// normalize this
 	void Quaternion::Normalize(){
-		real mag = Magnitude();
+#ifdef SARKLIB_USING_SIMD
+		const simd::real4 a = simd::load(&x);
+		real magSq = simd::dot(a, a);
 		ONLYDBG_CODEBLOCK(
-		if (mag == 0.f)
+		if (magSq == 0.f)
 			LogFatal("division by zero");
 		);
-		s /= mag;
-		x /= mag;
-		y /= mag;
-		z /= mag;
+		simd::store(&x, simd::mul(a, simd::splat(math::fast::rsqrt(magSq))));
+#else
+		real magSq = MagnitudeSq();
+		ONLYDBG_CODEBLOCK(
+		if (magSq == 0.f)
+			LogFatal("division by zero");
+		);
+		real invMag = math::fast::rsqrt(magSq);
+		s *= invMag;
+		x *= invMag;
+		y *= invMag;
+		z *= invMag;
+#endif
 	}
 
 	// inverse, q^{-1} = conj(q)/(norm(q)^2)
@@ -1495,10 +1511,10 @@ namespace sark{
 	// make this as the rotating quaternion from given axis vector and theta
 	void Quaternion::MakeRotatingQuat(const Vector3& axis, real theta, bool axis_normalized){
 		if (axis_normalized)
-			v = math::sin(theta / 2.0f) * axis;
+			v = math::fast::sin(theta / 2.0f) * axis;
 		else
-			v = math::sin(theta / 2.0f) * axis.Normal();
-		s = math::cos(theta / 2.0f);
+			v = math::fast::sin(theta / 2.0f) * axis.Normal();
+		s = math::fast::cos(theta / 2.0f);
 	}
 	// make this as the rotating quaternion from given each axis rotating factor
 	// (roll: z, pitch: x, yaw: y axis rotating factor)
@@ -1559,6 +1575,30 @@ namespace sark{
 
 	// convert quaternion to matrix 4D (only for rotation quaternion)
 	const Matrix4 Quaternion::ToMatrix4(bool isNormalized){
+#ifdef SARKLIB_USING_SIMD
+		simd::real4 q = simd::load(&x);
+		if (!isNormalized){
+			real mag = math::sqrt(simd::dot(q, q));
+			ONLYDBG_CODEBLOCK(
+			if (mag == 0.f)
+				LogFatal("division by zero");
+			);
+			q = simd::mul(q, simd::splat(1.f / mag));
+		}
+
+		// 2*x*(x, y, z, s), 2*y*(x, y, z, s) and 2*z*(x, y, z, s)
+		const simd::real4 q2 = simd::add(q, q);
+		real xq[4], yq[4], zq[4];
+		simd::store(xq, simd::mul(simd::lane<0>(q), q2));
+		simd::store(yq, simd::mul(simd::lane<1>(q), q2));
+		simd::store(zq, simd::mul(simd::lane<2>(q), q2));
+
+		return Matrix4(
+			1.0f - (yq[1] + zq[2]), xq[1] - zq[3], xq[2] + yq[3], 0.0f,
+			xq[1] + zq[3], 1.0f - (xq[0] + zq[2]), yq[2] - xq[3], 0.0f,
+			xq[2] - yq[3], yq[2] + xq[3], 1.0f - (xq[0] + yq[1]), 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f);
+#else
 		real xx, xy, xz, xs;
 		real yy, yz, ys;
 		real zz, zs;
@@ -1596,6 +1636,7 @@ namespace sark{
 			2.0f*(xy + zs), 1.0f - 2.0f*(xx + zz), 2.0f*(yz - xs), 0.0f,
 			2.0f*(xz - ys), 2.0f*(yz + xs), 1.0f - 2.0f*(xx + yy), 0.0f,
 			0.0f, 0.0f, 0.0f, 1.0f);
+#endif
 	}
 
 	// rotate input vector from given axis vector and theta
@@ -1623,12 +1664,12 @@ namespace sark{
 	// q0 and q1 must be unit quaternion, and 0<=t<=1.
 	const Quaternion Quaternion::Slerp(const Quaternion& q0, const Quaternion& q1, real t){
 		// the angle  of q0 and q1,  = acos(q0q1)
-		real phi = math::acos(q0.Dot(q1));
+		real phi = math::fast::acos(q0.Dot(q1));
 		if (math::real_equal(phi, 0.f))
 			return q0;
 
-		real sin_phi = math::sin(phi);
-		return (math::sin(phi*(1.f - t)) / sin_phi)*q0 + (math::sin(phi*t) / sin_phi)*q1;
+		real sin_phi = math::fast::sin(phi);
+		return (math::fast::sin(phi*(1.f - t)) / sin_phi)*q0 + (math::fast::sin(phi*t) / sin_phi)*q1;
 	}
 
 }
\ No newline at end of file
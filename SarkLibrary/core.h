@@ -11,7 +11,14 @@ and declare useful functions additionally which are not included in 'math.h'
 #include <float.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <GL/glew.h>
+
+// headless build without graphics api.
+// only the math and physics parts are available on this mode.
+// (e.g. benchmarks or tools running on a machine without GL)
+//#define SARKLIB_HEADLESS
+#ifndef SARKLIB_HEADLESS
+	#include <GL/glew.h>
+#endif
 
 namespace sark{
 
@@ -50,7 +57,56 @@ namespace sark{
 	typedef int32		integer;
 #endif
 
+	// fast approximated math mode.
+	// normalization, angle and rotation of the hot paths use the
+	// approximated kernels of math::fast instead of math.h.
+	// (see fastmath.hpp for the error bounds)
+	// it is ignored on double precision mode.
+	//#define SARKLIB_USING_FASTMATH
+#if defined(SARKLIB_USING_FASTMATH) && defined(SARKLIB_USING_DOUBLE)
+	#undef SARKLIB_USING_FASTMATH
+#endif
+
+	// opt-in SIMD kernels of Vector4, Matrix4 and Quaternion.
+	// it uses SSE on x86/x64 and NEON on ARM, and it also makes
+	// those types to have 16-byte aligned storage.
+	// it is ignored on double precision mode or unknown architecture.
+	//#define SARKLIB_USING_SIMD
+#ifdef SARKLIB_USING_SIMD
+	#if defined(SARKLIB_USING_DOUBLE)
+		#undef SARKLIB_USING_SIMD
+	#elif defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+		#define SARKLIB_SIMD_SSE
+	#elif defined(_M_ARM) || defined(_M_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#define SARKLIB_SIMD_NEON
+	#else
+		#undef SARKLIB_USING_SIMD
+	#endif
+#endif
+
+#ifdef SARKLIB_USING_SIMD
+	#define SARKLIB_ALIGN16 alignas(16)
+#else
+	#define SARKLIB_ALIGN16
+#endif
+
+	// definition of the constant static members in the headers.
+	// they are usable on constant expressions of every translation unit.
+	// C++17 makes them inline, and the older compilers merge the
+	// duplicated definitions by selectany (MSVC) or weak symbol.
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+	#define SARKLIB_CONSTEXPR_MEMBER inline constexpr
+#elif defined(_MSC_VER)
+	#define SARKLIB_CONSTEXPR_MEMBER __declspec(selectany) constexpr
+#else
+	#define SARKLIB_CONSTEXPR_MEMBER __attribute__((weak)) constexpr
+#endif
+
+#ifndef SARKLIB_HEADLESS
 	typedef GLuint ObjectHandle;
+#else
+	typedef unsigned int ObjectHandle;
+#endif
 
 
 	// standard shared pointer alias
@@ -64,48 +120,48 @@ namespace sark{
 	// namespace of math library
 	namespace math{
 #ifdef SARKLIB_USING_DOUBLE
-		const real		PI = 3.141592653589;
-		const real_d	PI_d = 3.141592653589;
-		const real		EPSILON = DBL_EPSILON;
-		const real_d	EPSILON_d = DBL_EPSILON;
+		constexpr real		PI = 3.141592653589;
+		constexpr real_d	PI_d = 3.141592653589;
+		constexpr real		EPSILON = DBL_EPSILON;
+		constexpr real_d	EPSILON_d = DBL_EPSILON;
 #else
-		const real		PI = 3.141592f;
-		const real_d	PI_d = 3.141592653589;
-		const real		EPSILON = FLT_EPSILON;
-		const real_d	EPSILON_d = DBL_EPSILON;
+		constexpr real		PI = 3.141592f;
+		constexpr real_d	PI_d = 3.141592653589;
+		constexpr real		EPSILON = FLT_EPSILON;
+		constexpr real_d	EPSILON_d = DBL_EPSILON;
 #endif
 
-		inline real rad2deg(real rad){
+		constexpr real rad2deg(real rad){
 			return rad * 180.0f / PI;
 		}
 
-		inline real deg2rad(real deg){
+		constexpr real deg2rad(real deg){
 			return deg * PI / 180.0f;
 		}
 
-		inline int8 sign(real value){
+		constexpr int8 sign(real value){
 			return (value > 0.0 ? 1 : (value < 0.0 ? -1 : 0));
 		}
 
-		inline real sqre(real value){
+		constexpr real sqre(real value){
 			return value*value;
 		}
 
-		inline real clamp(real value, real min, real max){
+		constexpr real clamp(real value, real min, real max){
 			return (value < min ? min : (value > max ? max : value));
 		}
 
 		#ifdef max
 			#undef max
 		#endif
-		inline real max(real v1, real v2){
+		constexpr real max(real v1, real v2){
 			return (v1 > v2 ? v1 : v2);
 		}
 
 		#ifdef min
 			#undef min
 		#endif
-		inline real min(real v1, real v2){
+		constexpr real min(real v1, real v2){
 			return (v1 < v2 ? v1 : v2);
 		}
 
@@ -151,7 +207,7 @@ namespace sark{
 
 
 		// linear interpolations
-		inline real lerp(real q0, real q1, real t){
+		constexpr real lerp(real q0, real q1, real t){
 			return t*(q1 - q0) + q0;
 		}
 
@@ -189,11 +245,11 @@ namespace sark{
 			};
 		};
 
-		Vector2();
-		Vector2(real val);
-		Vector2(real _x, real _y);
-		Vector2(const Vector2& v);
-		Vector2& operator=(const Vector2& v);
+		constexpr Vector2();
+		constexpr Vector2(real val);
+		constexpr Vector2(real _x, real _y);
+		Vector2(const Vector2& v) = default;
+		Vector2& operator=(const Vector2& v) = default;
 
 		void Set(real _x, real _y);
 
@@ -296,11 +352,11 @@ namespace sark{
 			};
 		};
 
-		Vector3();
-		Vector3(real val);
-		Vector3(real _x, real _y, real _z);
-		Vector3(const Vector3& v);
-		Vector3& operator=(const Vector3& v);
+		constexpr Vector3();
+		constexpr Vector3(real val);
+		constexpr Vector3(real _x, real _y, real _z);
+		Vector3(const Vector3& v) = default;
+		Vector3& operator=(const Vector3& v) = default;
 
 		void Set(real _x, real _y, real _z);
 
@@ -311,45 +367,45 @@ namespace sark{
 		// vector magnitude
 		real Magnitude() const;
 
-		real MagnitudeSq() const;
+		constexpr real MagnitudeSq() const;
 
 
 		// unary - operator
-		const Vector3 operator-() const;
+		constexpr const Vector3 operator-() const;
 
 
 		// vector plus operator
-		const Vector3 operator+(const Vector3& v) const;
+		constexpr const Vector3 operator+(const Vector3& v) const;
 		Vector3& operator+=(const Vector3& v);
 
-		const Vector3 operator+(real fConstant) const;
+		constexpr const Vector3 operator+(real fConstant) const;
 		Vector3& operator+=(real fConstant);
 
-		friend const Vector3 operator+(real fConstant, const Vector3& v);
+		friend constexpr const Vector3 operator+(real fConstant, const Vector3& v);
 
 
 		// vector minus operator
-		const Vector3 operator-(const Vector3& v) const;
+		constexpr const Vector3 operator-(const Vector3& v) const;
 		Vector3& operator-=(const Vector3& v);
 
-		const Vector3 operator-(real fConstant) const;
+		constexpr const Vector3 operator-(real fConstant) const;
 		Vector3& operator-=(real fConstant);
 
-		friend const Vector3 operator-(real fConstant, const Vector3& v);
+		friend constexpr const Vector3 operator-(real fConstant, const Vector3& v);
 
 
 		// vector constant multiplication operator (it is not cross operation)
-		const Vector3 operator*(const Vector3& v) const;
+		constexpr const Vector3 operator*(const Vector3& v) const;
 		Vector3& operator*=(const Vector3& v);
 
-		const Vector3 operator*(real fConstant) const;
+		constexpr const Vector3 operator*(real fConstant) const;
 		Vector3& operator*=(real fConstant);
 
-		friend const Vector3 operator*(real fConstant, const Vector3& v);
+		friend constexpr const Vector3 operator*(real fConstant, const Vector3& v);
 
 
 		// vector x matrix
-		const Vector3 operator*(const Matrix3& mat3) const;
+		constexpr const Vector3 operator*(const Matrix3& mat3) const;
 		// vector x matrix for this
 		Vector3& operator*=(const Matrix3& mat3);
 
@@ -370,10 +426,10 @@ namespace sark{
 		bool IsZero() const;
 
 		// dot product
-		real Dot(const Vector3& v) const;
+		constexpr real Dot(const Vector3& v) const;
 
 		// cross product
-		const Vector3 Cross(const Vector3& v) const;
+		constexpr const Vector3 Cross(const Vector3& v) const;
 
 
 		// get normal and normalize this
@@ -406,7 +462,7 @@ namespace sark{
 	/**
 	Type of vector 4D
 	*/
-	class Vector4{
+	class SARKLIB_ALIGN16 Vector4{
 	public:
 		union{
 			struct{
@@ -415,27 +471,24 @@ namespace sark{
 			struct{
 				real v[4];
 			};
-			struct{
-				Vector3 xyz;
-				real w;
-			};
+			Vector3 xyz;
 			struct{
 				real r, g, b, a;
 			};
 		};
 
-		Vector4();
-		Vector4(real val);
-		Vector4(real _x, real _y, real _z, real _w);
-		Vector4(const Vector3& vec3, real _w);
-		Vector4(const Vector4& v);
-		Vector4& operator=(const Vector4& v);
+		constexpr Vector4();
+		constexpr Vector4(real val);
+		constexpr Vector4(real _x, real _y, real _z, real _w);
+		constexpr Vector4(const Vector3& vec3, real _w);
+		Vector4(const Vector4& v) = default;
+		Vector4& operator=(const Vector4& v) = default;
 
 		void Set(real _x, real _y, real _z, real _w);
 
 		// explicit type cast
-		explicit Vector4(const Vector2& v);
-		explicit Vector4(const Vector3& v);
+		constexpr explicit Vector4(const Vector2& v);
+		constexpr explicit Vector4(const Vector3& v);
 
 
 		// vector magnitude
@@ -517,23 +570,28 @@ namespace sark{
 
 	//=============== Matrix Types =================
 
-	// matrix determinant inline functions
-	//template<typedef type>
-	//inline type det2x2(type e00, type e01, type e10, type e11){
-	//	return (e00*e11 - e01*e10);
-	//}
-	#define det2x2(a,b,c,d) ((a)*(d) - (b)*(c))
+	// matrix determinant functions
+	constexpr real det2x2(real a, real b,
+		real c, real d)
+	{
+		return a*d - b*c;
+	}
 
-	#define det3x3(	a, b, c, \
-		d, e, f, \
-		g, h, i) \
-		((a)*det2x2(e, f, h, i) - (b)*det2x2(d, f, g, i) + (c)*det2x2(d, e, g, h))
+	constexpr real det3x3(real a, real b, real c,
+		real d, real e, real f,
+		real g, real h, real i)
+	{
+		return a*det2x2(e, f, h, i) - b*det2x2(d, f, g, i) + c*det2x2(d, e, g, h);
+	}
 
-	#define det4x4(	a, b, c, d, \
-		e, f, g, h, \
-		i, j, k, l, \
-		m, n, o, p) \
-		((a)*det3x3(f, g, h, j, k, l, n, o, p) - (b)*det3x3(e, g, h, i, k, l, m, o, p) + (c)*det3x3(e, f, h, i, j, l, m, n, p) - (d)*det3x3(e, f, g, i, j, k, m, n, o))
+	constexpr real det4x4(real a, real b, real c, real d,
+		real e, real f, real g, real h,
+		real i, real j, real k, real l,
+		real m, real n, real o, real p)
+	{
+		return a*det3x3(f, g, h, j, k, l, n, o, p) - b*det3x3(e, g, h, i, k, l, m, o, p)
+			+ c*det3x3(e, f, h, i, j, l, m, n, p) - d*det3x3(e, f, g, i, j, k, m, n, o);
+	}
 
 
 	/**
@@ -542,22 +600,20 @@ namespace sark{
 	class Matrix3{
 	public:
 		union{
-			struct{
-				Vector3 row[3];
-			};
+			Vector3 row[3];
 			struct{
 				real m[3][3]; //row x col
 			};
 		};
 
-		Matrix3(real diagonal = 0.f);
-		Matrix3(real _00, real _01, real _02,
+		constexpr Matrix3(real diagonal = 0.f);
+		constexpr Matrix3(real _00, real _01, real _02,
 			real _10, real _11, real _12,
 			real _20, real _21, real _22);
 		Matrix3(real** mat3);
-		Matrix3(const Vector3& row0, const Vector3& row1, const Vector3& row2);
-		Matrix3(const Matrix3& mat3);
-		Matrix3& operator=(const Matrix3& mat3);
+		constexpr Matrix3(const Vector3& row0, const Vector3& row1, const Vector3& row2);
+		Matrix3(const Matrix3& mat3) = default;
+		Matrix3& operator=(const Matrix3& mat3) = default;
 
 		// set matrix elements
 		void Set(real _00, real _01, real _02,
@@ -584,7 +640,7 @@ namespace sark{
 		const Matrix3 operator*(const Matrix3& mat3) const;
 		Matrix3& operator*=(const Matrix3& mat3);
 
-		const Vector3 operator*(const Vector3& vec3) const;
+		constexpr const Vector3 operator*(const Vector3& vec3) const;
 
 		const Matrix3 operator*(real fConstant) const;
 		Matrix3& operator*=(real fConstant);
@@ -637,29 +693,27 @@ namespace sark{
 	/**
 	Type of 4x4 square matrix defined as row X col order
 	*/
-	class Matrix4{
+	class SARKLIB_ALIGN16 Matrix4{
 	public:
 		union{
-			struct{
-				Vector4 row[4];
-			};
+			Vector4 row[4];
 			struct{
 				real m[4][4]; //row x col
 			};
 		};
 
-		Matrix4(real diagonal = 0.f);
-		Matrix4(real _00, real _01, real _02, real _03,
+		constexpr Matrix4(real diagonal = 0.f);
+		constexpr Matrix4(real _00, real _01, real _02, real _03,
 			real _10, real _11, real _12, real _13,
 			real _20, real _21, real _22, real _23,
 			real _30, real _31, real _32, real _33);
 		Matrix4(real** mat4);
-		Matrix4(const Vector4& row0, 
+		constexpr Matrix4(const Vector4& row0, 
 			const Vector4& row1, 
 			const Vector4& row2, 
 			const Vector4& row3);
-		Matrix4(const Matrix4& mat4);
-		Matrix4& operator=(const Matrix4& mat4);
+		Matrix4(const Matrix4& mat4) = default;
+		Matrix4& operator=(const Matrix4& mat4) = default;
 
 		explicit Matrix4(const Matrix3& mat3);
 
@@ -739,30 +793,48 @@ namespace sark{
 
 		// to rotation quaternion
 		const Quaternion ToQuaternion() const;
+
+
+		// *note: below methods regard this matrix as affine transform,
+		// that the last row is (0, 0, 0, 1). they ignore the last row
+		// and the result always has (0, 0, 0, 1) as the last row.
+
+		// check if the last row is (0, 0, 0, 1)
+		bool IsAffine() const;
+
+		// affine transform product. (this x mat4)
+		// it takes 36 multiplications instead of 64.
+		const Matrix4 AffineMul(const Matrix4& mat4) const;
+
+		// inverse of affine transform (it can have scaling).
+		// inv([A|t]) = [inv(A)|-inv(A)t]
+		const Matrix4 AffineInverse() const;
+
+		// inverse of rigid transform (rotation and translation only).
+		// inv([R|t]) = [R^t|-R^t t]
+		// *note: it does not check if the rotation part is orthonormal.
+		const Matrix4 RigidInverse() const;
 	};
 
 
 	/**
 	Type of quaternion
 	*/
-	class Quaternion{
+	class SARKLIB_ALIGN16 Quaternion{
 	public:
 		union{
 			struct{ // q = [s + xi+yj+zk], s is scalar and (x,y,z) is vector part
 				real x, y, z;
 				real s;
 			};
-			struct{
-				Vector3 v;
-				real s;
-			};
+			Vector3 v;
 		};
 
-		Quaternion();
-		Quaternion(real _x, real _y, real _z, real _s);
+		constexpr Quaternion();
+		constexpr Quaternion(real _x, real _y, real _z, real _s);
 
-		Quaternion(const Vector3& v, real _s);
-		Quaternion(const Vector2& v, real _z, real _s);
+		constexpr Quaternion(const Vector3& v, real _s);
+		constexpr Quaternion(const Vector2& v, real _z, real _s);
 
 		Quaternion(const Vector3& rotationAxis, real theta, bool axis_normalized);
 		Quaternion(const real roll, real pitch, real yaw);
@@ -770,8 +842,8 @@ namespace sark{
 		Quaternion(const Matrix3& rotMat);
 		Quaternion(const Matrix4& rotMat);
 
-		Quaternion(const Quaternion& q);
-		Quaternion& operator=(const Quaternion& q);
+		Quaternion(const Quaternion& q) = default;
+		Quaternion& operator=(const Quaternion& q) = default;
 
 		void Set(real _x, real _y, real _z, real _s);
 
@@ -853,5 +925,225 @@ namespace sark{
 		static const Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, real t);
 	};
 
+
+
+	//==============================================
+	//		inline definitions of math types
+	//==============================================
+	// the small operations of Vector3 and Matrix3 x Vector3 are
+	// defined here rather than core.cpp. they are the most frequent
+	// ones in the physics code, and the compiler can fold the
+	// temporaries of chained expressions when they are inlined.
+	// (e.g. CN.Dot((invI * r.Cross(CN)).Cross(r)))
+	// the constructors and the non-modifying operations are constexpr,
+	// so constant tables of these types are built at compile time.
+	// *note: constexpr functions have a single return statement (C++11).
+
+	constexpr Vector2::Vector2() : x(0.0f), y(0.0f)
+	{ }
+	constexpr Vector2::Vector2(real val) : x(val), y(val)
+	{ }
+	constexpr Vector2::Vector2(real _x, real _y)
+		: x(_x), y(_y)
+	{ }
+
+	constexpr Vector3::Vector3() : x(0.0f), y(0.0f), z(0.0f)
+	{ }
+	constexpr Vector3::Vector3(real val) : x(val), y(val), z(val)
+	{ }
+	constexpr Vector3::Vector3(real _x, real _y, real _z)
+		: x(_x), y(_y), z(_z)
+	{ }
+
+	// x-axis right
+	SARKLIB_CONSTEXPR_MEMBER Vector2 Vector2::Right(1, 0);
+	// y-axis up
+	SARKLIB_CONSTEXPR_MEMBER Vector2 Vector2::Up(0, 1);
+
+	// general gravity force. 9.8 m/s^2 of negative y-axis
+	SARKLIB_CONSTEXPR_MEMBER Vector2 Vector2::Gravity(0, -9.80665f);
+
+	// x-axis right
+	SARKLIB_CONSTEXPR_MEMBER Vector3 Vector3::Right(1, 0, 0);
+	// y-axis up
+	SARKLIB_CONSTEXPR_MEMBER Vector3 Vector3::Up(0, 1, 0);
+	// negative z-axis forward
+	SARKLIB_CONSTEXPR_MEMBER Vector3 Vector3::Forward(0, 0, -1);
+
+	// general gravity force. 9.8 m/s^2 of negative y-axis
+	SARKLIB_CONSTEXPR_MEMBER Vector3 Vector3::Gravity(0, -9.80665f, 0);
+
+	inline void Vector3::Set(real _x, real _y, real _z){
+		x = _x; y = _y; z = _z;
+	}
+
+	// vector magnitude
+	inline real Vector3::Magnitude() const{
+		return math::sqrt(math::sqre(x) + math::sqre(y) + math::sqre(z));
+	}
+
+	constexpr real Vector3::MagnitudeSq() const{
+		return math::sqre(x) + math::sqre(y) + math::sqre(z);
+	}
+
+	// unary - operator
+	constexpr const Vector3 Vector3::operator-() const{
+		return Vector3(-x, -y, -z);
+	}
+
+	// vector plus operator
+	constexpr const Vector3 Vector3::operator+(const Vector3& v) const{
+		return Vector3(x + v.x, y + v.y, z + v.z);
+	}
+	inline Vector3& Vector3::operator+=(const Vector3& v){
+		x += v.x; y += v.y; z += v.z;
+		return *this;
+	}
+	constexpr const Vector3 Vector3::operator+(real fConstant) const{
+		return Vector3(x + fConstant, y + fConstant, z + fConstant);
+	}
+	inline Vector3& Vector3::operator+=(real fConstant){
+		x += fConstant; y += fConstant; z += fConstant;
+		return *this;
+	}
+	constexpr const Vector3 operator+(real fConstant, const Vector3& v){
+		return Vector3(fConstant + v.x, fConstant + v.y, fConstant + v.z);
+	}
+
+	// vector minus operator
+	constexpr const Vector3 Vector3::operator-(const Vector3& v) const{
+		return Vector3(x - v.x, y - v.y, z - v.z);
+	}
+	inline Vector3& Vector3::operator-=(const Vector3& v){
+		x -= v.x; y -= v.y; z -= v.z;
+		return *this;
+	}
+	constexpr const Vector3 Vector3::operator-(real fConstant) const{
+		return Vector3(x - fConstant, y - fConstant, z - fConstant);
+	}
+	inline Vector3& Vector3::operator-=(real fConstant){
+		x -= fConstant; y -= fConstant; z -= fConstant;
+		return *this;
+	}
+	constexpr const Vector3 operator-(real fConstant, const Vector3& v){
+		return Vector3(fConstant - v.x, fConstant - v.y, fConstant - v.z);
+	}
+
+	// vector constant multiplication operator (it is not cross operation)
+	constexpr const Vector3 Vector3::operator*(const Vector3& v) const{
+		return Vector3(x*v.x, y*v.y, z*v.z);
+	}
+	inline Vector3& Vector3::operator*=(const Vector3& v){
+		x *= v.x; y *= v.y; z *= v.z;
+		return *this;
+	}
+	constexpr const Vector3 Vector3::operator*(real fConstant) const{
+		return Vector3(x*fConstant, y*fConstant, z*fConstant);
+	}
+	inline Vector3& Vector3::operator*=(real fConstant){
+		x *= fConstant; y *= fConstant; z *= fConstant;
+		return *this;
+	}
+	constexpr const Vector3 operator*(real fConstant, const Vector3& v){
+		return Vector3(fConstant * v.x, fConstant * v.y, fConstant * v.z);
+	}
+
+	// vector x matrix
+	constexpr const Vector3 Vector3::operator*(const Matrix3& mat3) const{
+		return Vector3(
+			x*mat3.m[0][0] + y*mat3.m[1][0] + z*mat3.m[2][0],
+			x*mat3.m[0][1] + y*mat3.m[1][1] + z*mat3.m[2][1],
+			x*mat3.m[0][2] + y*mat3.m[1][2] + z*mat3.m[2][2]);
+	}
+
+	// dot product
+	constexpr real Vector3::Dot(const Vector3& v) const{
+		return x*v.x + y*v.y + z*v.z;
+	}
+
+	// cross product
+	constexpr const Vector3 Vector3::Cross(const Vector3& v) const{
+		return Vector3(y*v.z - z*v.y, z*v.x - x*v.z, x*v.y - y*v.x);
+	}
+
+	constexpr Vector4::Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f)
+	{ }
+	constexpr Vector4::Vector4(real val) : x(val), y(val), z(val), w(val)
+	{ }
+	constexpr Vector4::Vector4(real _x, real _y, real _z, real _w)
+		: x(_x), y(_y), z(_z), w(_w)
+	{ }
+	constexpr Vector4::Vector4(const Vector3& vec3, real _w)
+		: x(vec3.x), y(vec3.y), z(vec3.z), w(_w)
+	{ }
+	constexpr Vector4::Vector4(const Vector2& v)
+		: x(v.x), y(v.y), z(0.0f), w(0.0f)
+	{ }
+	constexpr Vector4::Vector4(const Vector3& v)
+		: x(v.x), y(v.y), z(v.z), w(0.0f)
+	{ }
+
+	constexpr Matrix3::Matrix3(real diagonal)
+		: m{ { diagonal, 0.0f, 0.0f },
+			{ 0.0f, diagonal, 0.0f },
+			{ 0.0f, 0.0f, diagonal } }
+	{ }
+	constexpr Matrix3::Matrix3(real _00, real _01, real _02,
+		real _10, real _11, real _12,
+		real _20, real _21, real _22)
+		: m{ { _00, _01, _02 }, { _10, _11, _12 }, { _20, _21, _22 } }
+	{ }
+	constexpr Matrix3::Matrix3(const Vector3& row0, const Vector3& row1, const Vector3& row2)
+		: m{ { row0.x, row0.y, row0.z },
+			{ row1.x, row1.y, row1.z },
+			{ row2.x, row2.y, row2.z } }
+	{ }
+
+	// matrix x vector
+	constexpr const Vector3 Matrix3::operator*(const Vector3& vec3) const{
+		return Vector3(
+			m[0][0] * vec3.x + m[0][1] * vec3.y + m[0][2] * vec3.z,
+			m[1][0] * vec3.x + m[1][1] * vec3.y + m[1][2] * vec3.z,
+			m[2][0] * vec3.x + m[2][1] * vec3.y + m[2][2] * vec3.z
+			);
+	}
+
+	constexpr Matrix4::Matrix4(real diagonal)
+		: m{ { diagonal, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, diagonal, 0.0f, 0.0f },
+			{ 0.0f, 0.0f, diagonal, 0.0f },
+			{ 0.0f, 0.0f, 0.0f, diagonal } }
+	{ }
+	constexpr Matrix4::Matrix4(real _00, real _01, real _02, real _03,
+		real _10, real _11, real _12, real _13,
+		real _20, real _21, real _22, real _23,
+		real _30, real _31, real _32, real _33)
+		: m{ { _00, _01, _02, _03 },
+			{ _10, _11, _12, _13 },
+			{ _20, _21, _22, _23 },
+			{ _30, _31, _32, _33 } }
+	{ }
+	constexpr Matrix4::Matrix4(const Vector4& row0,
+		const Vector4& row1,
+		const Vector4& row2,
+		const Vector4& row3)
+		: m{ { row0.x, row0.y, row0.z, row0.w },
+			{ row1.x, row1.y, row1.z, row1.w },
+			{ row2.x, row2.y, row2.z, row2.w },
+			{ row3.x, row3.y, row3.z, row3.w } }
+	{ }
+
+	constexpr Quaternion::Quaternion() : x(0.0f), y(0.0f), z(0.0f), s(0.0f)
+	{ }
+	constexpr Quaternion::Quaternion(real _x, real _y, real _z, real _s)
+		: x(_x), y(_y), z(_z), s(_s)
+	{ }
+	constexpr Quaternion::Quaternion(const Vector3& v, real _s)
+		: x(v.x), y(v.y), z(v.z), s(_s)
+	{ }
+	constexpr Quaternion::Quaternion(const Vector2& v, real _z, real _s)
+		: x(v.x), y(v.y), z(_z), s(_s)
+	{ }
+
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+#ifndef __FASTMATH_HPP__
+#define __FASTMATH_HPP__
+
+#include "core.h"
+
+#if defined(SARKLIB_USING_FASTMATH) && (defined(_M_IX86) || defined(_M_X64) || defined(__SSE__))
+	#include <xmmintrin.h>
+	#define SARKLIB_FASTMATH_SSE
+#endif
+
+// approximated elementary functions for the hot paths of math and physics.
+// functions of math::fast are the exact ones of math.h, unless
+// SARKLIB_USING_FASTMATH is defined (see core.h). the approx_* kernels are
+// always available, to compare with or to use them explicitly.
+//
+// maximum errors of the kernels, measured over their whole input range:
+//     approx_rsqrt - relative 2.5e-7 (SSE), 5.0e-6 (portable)
+//     approx_sin   - absolute 2.0e-7 on |x| <= 1000
+//     approx_cos   - absolute 2.0e-7 on |x| <= 1000
+//     approx_acos  - absolute 5.0e-7 rad
+//     approx_atan2 - absolute 2.0e-6 rad
+// *note: approx_sin/cos lose accuracy on large |x|, since the range
+// reduction is done by single precision. |x| must be less than 6.0e9.
+namespace sark{
+	namespace math{
+		namespace fast{
+
+			// 1/sqrt(x), x > 0.
+			// initial guess by instruction (or bit trick) refined by Newton's method.
+			inline float approx_rsqrt(float x){
+#ifdef SARKLIB_FASTMATH_SSE
+				float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+				return y * (1.5f - 0.5f * x * y * y);
+#else
+				union{ float f; uint32 i; } u;
+				u.f = x;
+				u.i = 0x5f375a86 - (u.i >> 1);
+				float y = u.f;
+				// the bit trick has 3.5e-2 error, so it needs two steps.
+				y = y * (1.5f - 0.5f * x * y * y);
+				return y * (1.5f - 0.5f * x * y * y);
+#endif
+			}
+
+			// sine by minimax polynomial on [-PI/2, PI/2].
+			inline float approx_sin_kernel(float r){
+				float r2 = r * r;
+				float p = -2.3889859e-8f;
+				p = p * r2 + 2.7525562e-6f;
+				p = p * r2 - 1.9840874e-4f;
+				p = p * r2 + 8.3333310e-3f;
+				p = p * r2 - 1.6666667e-1f;
+				return r + r * r2 * p;
+			}
+
+			// *note: PI is split into two parts on the range reduction,
+			// to keep precision of the reduced argument r.
+
+			// floor by integer conversion. (floorf can be a library call)
+			inline int32 approx_floor(float x){
+				int32 i = (int32)x;
+				return (x < (float)i ? i - 1 : i);
+			}
+
+			inline float approx_sin(float x){
+				// x = k*PI + r, |r| <= PI/2, sin(x) = (-1)^k * sin(r)
+				int32 k = approx_floor(x * 0.318309886f + 0.5f);
+				float fk = (float)k;
+				float r = (x - fk * 3.140625f) - fk * 9.67653589793e-4f;
+				float s = approx_sin_kernel(r);
+				return (k & 1) ? -s : s;
+			}
+
+			inline float approx_cos(float x){
+				// x = (k + 1/2)*PI + r, |r| <= PI/2, cos(x) = -(-1)^k * sin(r)
+				int32 k = approx_floor(x * 0.318309886f);
+				float h = (float)k + 0.5f;
+				float r = (x - h * 3.140625f) - h * 9.67653589793e-4f;
+				float s = approx_sin_kernel(r);
+				return (k & 1) ? s : -s;
+			}
+
+			// arc cosine, x in [-1, 1]. (Abramowitz and Stegun 4.4.46)
+			// it clamps x into the range, so slightly over 1 by rounding is safe.
+			inline float approx_acos(float x){
+				float a = (x < 0.f ? -x : x);
+				if (a > 1.f)
+					a = 1.f;
+				float p = -0.0012624911f;
+				p = p * a + 0.0066700901f;
+				p = p * a - 0.0170881256f;
+				p = p * a + 0.0308918810f;
+				p = p * a - 0.0501743046f;
+				p = p * a + 0.0889789874f;
+				p = p * a - 0.2145988016f;
+				p = p * a + 1.5707963050f;
+				float r = ::sqrtf(1.f - a) * p;
+				return (x < 0.f ? 3.14159265f - r : r);
+			}
+
+			// arc tangent of y/x in [-PI, PI] by minimax polynomial on [0, 1].
+			inline float approx_atan2(float y, float x){
+				float ax = (x < 0.f ? -x : x);
+				float ay = (y < 0.f ? -y : y);
+				float mx = (ax > ay ? ax : ay);
+				if (mx == 0.f)
+					return 0.f;
+				float mn = (ax > ay ? ay : ax);
+				float t = mn / mx;
+				float t2 = t * t;
+				float p = -0.01172120f;
+				p = p * t2 + 0.05265332f;
+				p = p * t2 - 0.11643287f;
+				p = p * t2 + 0.19354346f;
+				p = p * t2 - 0.33262347f;
+				p = p * t2 + 0.99997726f;
+				float r = p * t;
+				if (ay > ax)
+					r = 1.57079633f - r;
+				if (x < 0.f)
+					r = 3.14159265f - r;
+				return (y < 0.f ? -r : r);
+			}
+
+
+			// functions selected by SARKLIB_USING_FASTMATH.
+#ifdef SARKLIB_USING_FASTMATH
+			inline real rsqrt(real x){ return approx_rsqrt(x); }
+			inline real sin(real x){ return approx_sin(x); }
+			inline real cos(real x){ return approx_cos(x); }
+			inline real acos(real x){ return approx_acos(x); }
+			inline real atan2(real y, real x){ return approx_atan2(y, x); }
+#else
+			inline real rsqrt(real x){ return 1.f / math::sqrt(x); }
+			inline real sin(real x){ return math::sin(x); }
+			inline real cos(real x){ return math::cos(x); }
+			inline real acos(real x){ return math::acos(x); }
+			inline real atan2(real y, real x){ return math::atan2(y, x); }
+#endif
+
+		}
+	}
+}
+#endif
@@ -24,10 +24,10 @@ namespace sark{
 			};
 		};
 
-		TrianglePrimitive()
+		constexpr TrianglePrimitive()
 			: a(0), b(0), c(0)
 		{}
-		TrianglePrimitive(_T _a, _T _b, _T _c)
+		constexpr TrianglePrimitive(_T _a, _T _b, _T _c)
 			: a(_a), b(_b), c(_c)
 		{}
 	};
@@ -50,10 +50,10 @@ namespace sark{
 			};
 		};
 
-		QuadPrimitive()
+		constexpr QuadPrimitive()
 			: a(0), b(0), c(0), d(0)
 		{}
-		QuadPrimitive(_T _a, _T _b, _T _c, _T _d)
+		constexpr QuadPrimitive(_T _a, _T _b, _T _c, _T _d)
 			: a(_a), b(_b), c(_c), d(_d)
 		{}
 	};
@@ -0,0 +1,307 @@
+#ifndef __SIMD_HPP__
+#define __SIMD_HPP__
+
+#include "core.h"
+
+// thin wrappers of 4-wide single precision SIMD instructions.
+// they are used by the math kernels in core.cpp only when
+// SARKLIB_USING_SIMD is defined (see core.h).
+// *note: every load/store is unaligned one, because the heap of
+// 32-bit targets does not guarantee the 16-byte alignment
+// of Vector4, Matrix4 and Quaternion.
+#ifdef SARKLIB_USING_SIMD
+
+#if defined(SARKLIB_SIMD_SSE)
+	#include <emmintrin.h>
+#elif defined(SARKLIB_SIMD_NEON)
+	#include <arm_neon.h>
+#endif
+
+namespace sark{
+	namespace simd{
+
+#if defined(SARKLIB_SIMD_SSE)
+		typedef __m128 real4;
+
+		inline real4 load(const real* p){ return _mm_loadu_ps(p); }
+		inline void store(real* p, real4 v){ _mm_storeu_ps(p, v); }
+		inline real4 set(real x, real y, real z, real w){ return _mm_setr_ps(x, y, z, w); }
+		inline real4 splat(real s){ return _mm_set1_ps(s); }
+
+		inline real4 add(real4 a, real4 b){ return _mm_add_ps(a, b); }
+		inline real4 sub(real4 a, real4 b){ return _mm_sub_ps(a, b); }
+		inline real4 mul(real4 a, real4 b){ return _mm_mul_ps(a, b); }
+		inline real4 div(real4 a, real4 b){ return _mm_div_ps(a, b); }
+		inline real4 neg(real4 a){ return _mm_sub_ps(_mm_setzero_ps(), a); }
+
+		// a*b + c
+		inline real4 madd(real4 a, real4 b, real4 c){ return _mm_add_ps(_mm_mul_ps(a, b), c); }
+
+		inline real4 min(real4 a, real4 b){ return _mm_min_ps(a, b); }
+		inline real4 max(real4 a, real4 b){ return _mm_max_ps(a, b); }
+
+		// lane-wise comparison a > b as all-bits mask, and selection by the mask.
+		inline real4 cmpgt(real4 a, real4 b){ return _mm_cmpgt_ps(a, b); }
+		inline real4 select(real4 mask, real4 a, real4 b){
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		// bits of the mask lanes. the i-th bit is the i-th lane.
+		inline int movemask(real4 mask){ return _mm_movemask_ps(mask); }
+
+		// broadcast i-th lane into whole lanes.
+		template<int i>
+		inline real4 lane(real4 v){ return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i)); }
+
+		// lane swizzles. (3,2,1,0), (1,0,3,2) and (2,3,0,1) order.
+		inline real4 reverse(real4 v){ return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+		inline real4 swap_pairs(real4 v){ return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+		inline real4 swap_halves(real4 v){ return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
+
+		// horizontal summation of four lanes.
+		inline real hsum(real4 v){
+			real4 t = _mm_add_ps(v, _mm_movehl_ps(v, v));
+			t = _mm_add_ss(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1)));
+			return _mm_cvtss_f32(t);
+		}
+
+		// transpose 4x4 matrix of given rows.
+		inline void transpose(real4& r0, real4& r1, real4& r2, real4& r3){
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		}
+
+		// load four packed (x, y, z) triples as x, y and z lanes.
+		// p: x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+		inline void load3x4(const real* p, real4& x, real4& y, real4& z){
+			const real4 p0 = _mm_loadu_ps(p);
+			const real4 p1 = _mm_loadu_ps(p + 4);
+			const real4 p2 = _mm_loadu_ps(p + 8);
+			const real4 t0 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+			const real4 t1 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+			x = _mm_shuffle_ps(p0, t0, _MM_SHUFFLE(2, 0, 3, 0));
+			y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+			z = _mm_shuffle_ps(t1, p2, _MM_SHUFFLE(3, 0, 3, 1));
+		}
+
+		// store x, y and z lanes as four packed (x, y, z) triples.
+		inline void store3x4(real* p, real4 x, real4 y, real4 z){
+			const real4 a = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)); // x0 x2 y0 y2
+			const real4 b = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1)); // y1 y3 z1 z3
+			const real4 c = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0)); // z0 z2 x1 x3
+			_mm_storeu_ps(p, _mm_shuffle_ps(a, c, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(p + 4, _mm_shuffle_ps(b, a, _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm_storeu_ps(p + 8, _mm_shuffle_ps(c, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+
+#elif defined(SARKLIB_SIMD_NEON)
+		typedef float32x4_t real4;
+
+		inline real4 load(const real* p){ return vld1q_f32(p); }
+		inline void store(real* p, real4 v){ vst1q_f32(p, v); }
+		inline real4 set(real x, real y, real z, real w){
+			const real tmp[4] = { x, y, z, w };
+			return vld1q_f32(tmp);
+		}
+		inline real4 splat(real s){ return vdupq_n_f32(s); }
+
+		inline real4 add(real4 a, real4 b){ return vaddq_f32(a, b); }
+		inline real4 sub(real4 a, real4 b){ return vsubq_f32(a, b); }
+		inline real4 mul(real4 a, real4 b){ return vmulq_f32(a, b); }
+		inline real4 div(real4 a, real4 b){
+			// two newton-raphson steps of reciprocal estimation.
+			real4 r = vrecpeq_f32(b);
+			r = vmulq_f32(vrecpsq_f32(b, r), r);
+			r = vmulq_f32(vrecpsq_f32(b, r), r);
+			return vmulq_f32(a, r);
+		}
+		inline real4 neg(real4 a){ return vnegq_f32(a); }
+
+		// a*b + c
+		inline real4 madd(real4 a, real4 b, real4 c){ return vmlaq_f32(c, a, b); }
+
+		inline real4 min(real4 a, real4 b){ return vminq_f32(a, b); }
+		inline real4 max(real4 a, real4 b){ return vmaxq_f32(a, b); }
+
+		// lane-wise comparison a > b as all-bits mask, and selection by the mask.
+		inline real4 cmpgt(real4 a, real4 b){ return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+		inline real4 select(real4 mask, real4 a, real4 b){
+			return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+		}
+
+		// bits of the mask lanes. the i-th bit is the i-th lane.
+		inline int movemask(real4 mask){
+			const uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+			return (int)(vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1)
+				| (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3));
+		}
+
+		// broadcast i-th lane into whole lanes.
+		template<int i>
+		inline real4 lane(real4 v){ return vdupq_n_f32(vgetq_lane_f32(v, i)); }
+
+		// lane swizzles. (3,2,1,0), (1,0,3,2) and (2,3,0,1) order.
+		inline real4 swap_pairs(real4 v){ return vrev64q_f32(v); }
+		inline real4 swap_halves(real4 v){ return vextq_f32(v, v, 2); }
+		inline real4 reverse(real4 v){ return vrev64q_f32(vextq_f32(v, v, 2)); }
+
+		// horizontal summation of four lanes.
+		inline real hsum(real4 v){
+			float32x2_t t = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+			return vget_lane_f32(vpadd_f32(t, t), 0);
+		}
+
+		// transpose 4x4 matrix of given rows.
+		inline void transpose(real4& r0, real4& r1, real4& r2, real4& r3){
+			float32x4x2_t t01 = vtrnq_f32(r0, r1);
+			float32x4x2_t t23 = vtrnq_f32(r2, r3);
+			r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+			r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+			r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+			r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+		}
+
+		// load four packed (x, y, z) triples as x, y and z lanes.
+		inline void load3x4(const real* p, real4& x, real4& y, real4& z){
+			float32x4x3_t t = vld3q_f32(p);
+			x = t.val[0]; y = t.val[1]; z = t.val[2];
+		}
+
+		// store x, y and z lanes as four packed (x, y, z) triples.
+		inline void store3x4(real* p, real4 x, real4 y, real4 z){
+			float32x4x3_t t;
+			t.val[0] = x; t.val[1] = y; t.val[2] = z;
+			vst3q_f32(p, t);
+		}
+#endif
+
+		// dot product of four lanes.
+		inline real dot(real4 a, real4 b){ return hsum(mul(a, b)); }
+
+		// row-major affine 4x4 matrix product. out = A*B
+		// both of A and B are regarded to have (0, 0, 0, 1) as the last row,
+		// so it computes only three rows and the last row of out is (0, 0, 0, 1).
+		// 'out' can be same as A or B, because B is loaded first
+		// and each row of A is consumed before same row of out is written.
+		inline void mul3x4(const real* A, const real* B, real* out){
+			const real4 b0 = load(B);
+			const real4 b1 = load(B + 4);
+			const real4 b2 = load(B + 8);
+			const real4 b3 = set(0.f, 0.f, 0.f, 1.f);
+
+			#define SARK_MUL3X4_ROW(i) {\
+				const real4 a = load(A + i * 4);\
+				real4 r = mul(lane<0>(a), b0);\
+				r = madd(lane<1>(a), b1, r);\
+				r = madd(lane<2>(a), b2, r);\
+				store(out + i * 4, madd(lane<3>(a), b3, r)); }
+			SARK_MUL3X4_ROW(0)
+			SARK_MUL3X4_ROW(1)
+			SARK_MUL3X4_ROW(2)
+			#undef SARK_MUL3X4_ROW
+			store(out + 12, b3);
+		}
+
+		// row-major 4x4 matrix and column vector product. M*v
+		inline real4 mul4x4_vec(const real* M, real4 v){
+			real4 r0 = mul(load(M), v);
+			real4 r1 = mul(load(M + 4), v);
+			real4 r2 = mul(load(M + 8), v);
+			real4 r3 = mul(load(M + 12), v);
+			transpose(r0, r1, r2, r3);
+			return add(add(r0, r1), add(r2, r3));
+		}
+
+		// row vector and row-major 4x4 matrix product. v*M
+		inline real4 mul_vec4x4(real4 v, const real* M){
+			real4 r = mul(lane<0>(v), load(M));
+			r = madd(lane<1>(v), load(M + 4), r);
+			r = madd(lane<2>(v), load(M + 8), r);
+			return madd(lane<3>(v), load(M + 12), r);
+		}
+
+#if defined(SARKLIB_SIMD_SSE)
+		// inverse of row-major 4x4 matrix by 2x2 block-wise
+		// adjugate method. it returns the determinant of M.
+		// *note: the algorithm is from
+		// https://lxjk.github.io/2017/09/03/Fast-4x4-Matrix-Inverse-with-SSE-SIMD-Explained.html
+		inline real inverse4x4(const real* M, real* out){
+			#define SARK_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+			#define SARK_SWIZZLE(a, x, y, z, w) SARK_SHUFFLE(a, a, x, y, z, w)
+
+			struct mat2{
+				// 2x2 row-major product A*B
+				static real4 Mul(real4 a, real4 b){
+					return _mm_add_ps(_mm_mul_ps(a, SARK_SWIZZLE(b, 0, 3, 0, 3)),
+						_mm_mul_ps(SARK_SWIZZLE(a, 1, 0, 3, 2), SARK_SWIZZLE(b, 2, 1, 2, 1)));
+				}
+				// 2x2 row-major product adj(A)*B
+				static real4 AdjMul(real4 a, real4 b){
+					return _mm_sub_ps(_mm_mul_ps(SARK_SWIZZLE(a, 3, 3, 0, 0), b),
+						_mm_mul_ps(SARK_SWIZZLE(a, 1, 1, 2, 2), SARK_SWIZZLE(b, 2, 3, 0, 1)));
+				}
+				// 2x2 row-major product A*adj(B)
+				static real4 MulAdj(real4 a, real4 b){
+					return _mm_sub_ps(_mm_mul_ps(a, SARK_SWIZZLE(b, 3, 0, 3, 0)),
+						_mm_mul_ps(SARK_SWIZZLE(a, 1, 0, 3, 2), SARK_SWIZZLE(b, 2, 1, 2, 1)));
+				}
+			};
+
+			real4 r0 = load(M);
+			real4 r1 = load(M + 4);
+			real4 r2 = load(M + 8);
+			real4 r3 = load(M + 12);
+
+			// sub matrices
+			// M = | A B |
+			//     | C D |
+			real4 A = _mm_movelh_ps(r0, r1);
+			real4 B = _mm_movehl_ps(r1, r0);
+			real4 C = _mm_movelh_ps(r2, r3);
+			real4 D = _mm_movehl_ps(r3, r2);
+
+			// (|A|, |B|, |C|, |D|)
+			real4 detSub = _mm_sub_ps(
+				_mm_mul_ps(SARK_SHUFFLE(r0, r2, 0, 2, 0, 2), SARK_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+				_mm_mul_ps(SARK_SHUFFLE(r0, r2, 1, 3, 1, 3), SARK_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+			real4 detA = lane<0>(detSub);
+			real4 detB = lane<1>(detSub);
+			real4 detC = lane<2>(detSub);
+			real4 detD = lane<3>(detSub);
+
+			real4 D_C = mat2::AdjMul(D, C);
+			real4 A_B = mat2::AdjMul(A, B);
+
+			// inv(M) = 1/|M| * | X Y |
+			//                  | Z W |
+			real4 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), mat2::Mul(B, D_C));
+			real4 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), mat2::Mul(C, A_B));
+			real4 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), mat2::MulAdj(D, A_B));
+			real4 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), mat2::MulAdj(A, D_C));
+
+			// |M| = |A|*|D| + |B|*|C| - tr(adj(A)B * adj(D)C)
+			real4 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+			real tr = hsum(_mm_mul_ps(A_B, SARK_SWIZZLE(D_C, 0, 2, 1, 3)));
+			detM = _mm_sub_ps(detM, _mm_set1_ps(tr));
+
+			real4 rDetM = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+			X_ = _mm_mul_ps(X_, rDetM);
+			Y_ = _mm_mul_ps(Y_, rDetM);
+			Z_ = _mm_mul_ps(Z_, rDetM);
+			W_ = _mm_mul_ps(W_, rDetM);
+
+			store(out, SARK_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+			store(out + 4, SARK_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+			store(out + 8, SARK_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+			store(out + 12, SARK_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+
+			#undef SARK_SWIZZLE
+			#undef SARK_SHUFFLE
+			return _mm_cvtss_f32(detM);
+		}
+#endif
+
+	}
+}
+
+#endif // SARKLIB_USING_SIMD
+#endif
@@ -16,6 +16,7 @@
 #include "Collision.h"
 #include "GJK_EPA.h"
 #include "ConvexHull.h"
+#include "ConvexHullBuilder.h"
 #include "OBoxCollider.h"
 #include "SphereCollider.h"
 #include "RigidBody.h"
@@ -43,49 +44,17 @@ public:
 	ShaderProgram* renderer;
 	Texture* tex;
 
-	ConvexHull* makeBoxConvexHull(RigidCube* cube) {
-		real w = cube->GetWidth() / 2.f;
-		real h = cube->GetHeight() / 2.f;
-		real d = cube->GetDepth() / 2.f;
-
-		std::vector<Vector3> points = {
-			Vector3(-w, -h, -d), Vector3(w, -h, -d), Vector3(w, -h, d), Vector3(-w, -h, d),
-			Vector3(-w, h, -d), Vector3(w, h, -d), Vector3(w, h, d), Vector3(-w, h, d)
-		};
-		std::vector<TriangleFace16> faces = {
-			TriangleFace16(0, 1, 2), TriangleFace16(0, 2, 3),
-			TriangleFace16(0, 7, 4), TriangleFace16(0, 3, 7),
-			TriangleFace16(0, 4, 5), TriangleFace16(0, 5, 1),
-			TriangleFace16(2, 1, 5), TriangleFace16(2, 5, 6),
-			TriangleFace16(3, 2, 6), TriangleFace16(3, 6, 7),
-			TriangleFace16(4, 6, 5), TriangleFace16(4, 7, 6)
-		};
-		return new ConvexHull(cube, points, faces);
+	OBoxCollider* makeBoxCollider(RigidCube* cube) {
+		// the box pairs have the analytic contacts. (see Collision::ContactLevelDetection)
+		Vector3 halfExtents(cube->GetWidth() / 2.f, cube->GetHeight() / 2.f, cube->GetDepth() / 2.f);
+		return new OBoxCollider(cube, 0, halfExtents);
 	}
 
-	std::vector<Vector3> makeConvexPoints(ASceneComponent* comp) {
-		ArrayBuffer::AttributeAccessor<Position3> poss 
-			= comp->GetMesh()->GetArrayBuffer().GetAttributeAccessor<Position3>(AttributeSemantic::POSITION);
-		ArrayBuffer::AttributeAccessor<TriangleFace16> faces 
-			= comp->GetMesh()->GetArrayBuffer().GetAttributeAccessor<TriangleFace16>(AttributeSemantic::INDICES);
-		std::vector<Vector3> points;
-		uinteger sz = faces.Count();
-		for (uinteger i = 0; i < sz; i++) {
-			for (uinteger j = 0; j < 3; j++) {
-				bool unique = true;
-				uinteger sz = points.size();
-				for (uinteger k = 0; k < sz; k++) {
-					if (poss[faces[i].idx[j]] == points[k]) {
-						unique = false;
-						break;
-					}
-				}
-				if (unique) {
-					points.push_back(poss[faces[i].idx[j]]);
-				}
-			}
-		}
-		return points;
+	ConvexHull* makeConvexHull(ASceneComponent* comp) {
+		ConvexHullBuilder builder;
+		if (!builder.Build(comp->GetMesh()))
+			return NULL;
+		return new ConvexHull(comp, builder.GetPointSet(), builder.GetFaceSet());
 	}
 
 	PhysicsSimulationScene() {
@@ -98,7 +67,7 @@ public:
 		// --------------------------- sphere ---------------------------------
 		/*
 		RigidSphere* sphere = new RigidSphere(2.5, 20, 20, 1, 0, 0, true);
-		sphere->SetCollider(new ConvexHull(sphere, makeConvexPoints(sphere)));
+		sphere->SetCollider(new SphereCollider(sphere, 0, 2.5));
 		mLayers[LAYER_PHYSICS].Push(sphere);
 		sphere->GetTransform().Translate(0, 50, 0);
 		AddSceneComponent(sphere);
@@ -106,7 +75,7 @@ public:
 
 		// ----------------------------- box ----------------------------------
 		auto box = new RigidCube(5, 10, 5, 1, 0, 0, true);
-		box->SetCollider(makeBoxConvexHull(box));
+		box->SetCollider(makeBoxCollider(box));
 		mLayers[LAYER_PHYSICS].Push(box);
 		mLayers[LAYER_PICKABLE].Push(box);
 		box->GetTransform().Translate(0, 30, 0);
@@ -114,27 +83,27 @@ public:
 
 		// ----------------------------- room ---------------------------------
 		auto wall = new RigidCube(50, 1, 50, 0, 0, 0, false);
-		wall->SetCollider(makeBoxConvexHull(wall));
+		wall->SetCollider(makeBoxCollider(wall));
 		mLayers[LAYER_PHYSICS].Push(wall);
 		wall->GetTransform().Translate(0, 0, 0);
 		AddSceneComponent(wall);
 
 		wall = new RigidCube(50, 1, 50, 0, 0, 0, false);
-		wall->SetCollider(makeBoxConvexHull(wall));
+		wall->SetCollider(makeBoxCollider(wall));
 		mLayers[LAYER_PHYSICS].Push(wall);
 		wall->GetTransform().Rotate(0, math::deg2rad(90), math::deg2rad(90));
 		wall->GetTransform().Translate(-25, 25.5f, 0);
 		AddSceneComponent(wall);
 
 		wall = new RigidCube(50, 1, 50, 0, 0, 0, false);
-		wall->SetCollider(makeBoxConvexHull(wall));
+		wall->SetCollider(makeBoxCollider(wall));
 		mLayers[LAYER_PHYSICS].Push(wall);
 		wall->GetTransform().Rotate(0, math::deg2rad(90), math::deg2rad(-90));
 		wall->GetTransform().Translate(25, 25.5f, 0);
 		AddSceneComponent(wall);
 
 		wall = new RigidCube(50, 1, 50, 0, 0, 0, false);
-		wall->SetCollider(makeBoxConvexHull(wall));
+		wall->SetCollider(makeBoxCollider(wall));
 		mLayers[LAYER_PHYSICS].Push(wall);
 		wall->GetTransform().Rotate(0, math::deg2rad(90), 0);
 		wall->GetTransform().Translate(0, 25.5f, -25);
@@ -209,17 +178,11 @@ public:
 
 			Ray ray = mMainCam->ScreenToWorldRay(pos);
 
-			mLayers[LAYER_PICKABLE].Sort(mMainCam->GetEye());
-			Layer::ReplicaArrayIterator itr = mLayers[LAYER_PICKABLE].Begin();
-			Layer::ReplicaArrayIterator end = mLayers[LAYER_PICKABLE].End();
-			for (; itr != end; itr++) {
-				auto bs = (*itr)->GetCollider();
-				if (bs == NULL)
-					continue;
-
-				if (ray.IntersectWith(bs))
-					graspComponent = (*itr);
-			}
+			// pick the nearest one.
+			mLayers[LAYER_PICKABLE].UpdateBounds();
+			ASceneComponent* picked = mLayers[LAYER_PICKABLE].RayCast(ray);
+			if (picked != NULL)
+				graspComponent = picked;
 		});
 		Input::mouse.RegisterMouseHandler(
 			Input::Mouse::EVENT_LBUTTON_UP,
@@ -233,19 +196,12 @@ public:
 			[&](const Position2& pos, real ext)->void {
 			Ray ray = mMainCam->ScreenToWorldRay(pos);
 
-			mLayers[LAYER_PICKABLE].Sort(mMainCam->GetEye());
-			Layer::ReplicaArrayIterator itr = mLayers[LAYER_PICKABLE].Begin();
-			Layer::ReplicaArrayIterator end = mLayers[LAYER_PICKABLE].End();
-			for (; itr != end; itr++) {
-				auto bs = (*itr)->GetCollider();
-
-				if (bs == NULL)
-					continue;
-				Vector3 hitP;
-				if (ray.IntersectWith(bs, &hitP)) {
-					(*itr)->GetRigidBody()->AddForceOn(hitP, ray.dir*100.f);
-				}
-			}
+			std::vector<ASceneComponent*> hits;
+			std::vector<Vector3> hitPoints;
+			mLayers[LAYER_PICKABLE].UpdateBounds();
+			mLayers[LAYER_PICKABLE].RayCastAll(ray, hits, &hitPoints);
+			for (uinteger i = 0; i < hits.size(); i++)
+				hits[i]->GetRigidBody()->AddForceOn(hitPoints[i], ray.dir*100.f);
 		});
 		Input::mouse.RegisterMouseHandler(
 			Input::Mouse::EVENT_WHEEL,
@@ -488,17 +444,11 @@ public:
 
 			Ray ray = mMainCam->ScreenToWorldRay(pos);
 
-			mLayers[0].Sort(mMainCam->GetEye());
-			Layer::ReplicaArrayIterator itr = mLayers[0].Begin();
-			Layer::ReplicaArrayIterator end = mLayers[0].End();
-			for (; itr != end; itr++) {
-				auto bs = (*itr)->GetCollider();
-				if (bs == NULL)
-					continue;
-
-				if (ray.IntersectWith(bs))
-					graspComponent = (*itr);
-			}
+			// pick the nearest one.
+			mLayers[0].UpdateBounds();
+			ASceneComponent* picked = mLayers[0].RayCast(ray);
+			if (picked != NULL)
+				graspComponent = picked;
 		});
 		Input::mouse.RegisterMouseHandler(
 			Input::Mouse::EVENT_LBUTTON_UP,
@@ -807,17 +757,11 @@ public:
 
 			Ray ray = mMainCam->ScreenToWorldRay(pos);
 
-			mLayers[0].Sort(mMainCam->GetEye());
-			Layer::ReplicaArrayIterator itr = mLayers[0].Begin();
-			Layer::ReplicaArrayIterator end = mLayers[0].End();
-			for (; itr != end; itr++) {
-				auto bs = (*itr)->GetCollider();
-				if (bs == NULL)
-					continue;
-
-				if (ray.IntersectWith(bs))
-					graspComponent = (*itr);
-			}
+			// pick the nearest one.
+			mLayers[0].UpdateBounds();
+			ASceneComponent* picked = mLayers[0].RayCast(ray);
+			if (picked != NULL)
+				graspComponent = picked;
 		});
 		Input::mouse.RegisterMouseHandler(
 			Input::Mouse::EVENT_LBUTTON_UP,
@@ -955,11 +899,11 @@ public:
 		{
 			if (parentJoint == NULL) {
 				pid = -1;
-				invMd = Mp.Inverse();
+				invMd = Mp.AffineInverse();
 			}
 			else {
 				pid = parentJoint->id;
-				invMd = Mp.Inverse() * parentJoint->invMd;
+				invMd = Mp.AffineInverse().AffineMul(parentJoint->invMd);
 			}
 		}
 	};
@@ -1458,17 +1402,11 @@ public:
 
 			Ray ray = mMainCam->ScreenToWorldRay(pos);
 
-			mLayers[0].Sort(mMainCam->GetEye());
-			Layer::ReplicaArrayIterator itr = mLayers[0].Begin();
-			Layer::ReplicaArrayIterator end = mLayers[0].End();
-			for (; itr != end; itr++) {
-				auto bs = (*itr)->GetCollider();
-				if (bs == NULL)
-					continue;
-
-				if (ray.IntersectWith(bs))
-					graspComponent = (*itr);
-			}
+			// pick the nearest one.
+			mLayers[0].UpdateBounds();
+			ASceneComponent* picked = mLayers[0].RayCast(ray);
+			if (picked != NULL)
+				graspComponent = picked;
 		});
 		Input::mouse.RegisterMouseHandler(
 			Input::Mouse::EVENT_LBUTTON_UP,
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include "tools.h"
+#include "simd.hpp"
 
 namespace sark{
 	namespace tool{
@@ -7,17 +9,147 @@ namespace sark{
 		const Vector3 FarthestPointInDirection(
 			const std::vector<Vector3>& pointSet, const Vector3& direction)
 		{
-			integer idx = 0;
+			return pointSet[FarthestPointIndex(&pointSet[0], pointSet.size(), direction)];
+		}
+
+		// get index of farthest point by linear scan.
+		uinteger FarthestPointIndex(const Vector3* points, uinteger count,
+			const Vector3& direction)
+		{
+			uinteger idx = 0;
 			real maxd = -REAL_MAX;
-			uinteger size = pointSet.size();
-			for (uinteger i = 0; i < size; i++){
-				real d = direction.Dot(pointSet[i]);
+			uinteger i = 0;
+#ifdef SARKLIB_USING_SIMD
+			if (count >= 16){
+				// the farthest one of each lane. the indices are kept as real
+				// lanes, they are exact up to 2^24 points.
+				const simd::real4 dx = simd::splat(direction.x);
+				const simd::real4 dy = simd::splat(direction.y);
+				const simd::real4 dz = simd::splat(direction.z);
+				const simd::real4 four = simd::splat(4.f);
+				simd::real4 laneIdx = simd::set(0.f, 1.f, 2.f, 3.f);
+				simd::real4 bestd = simd::splat(-REAL_MAX);
+				simd::real4 bestIdx = simd::splat(0.f);
+
+				for (; i + 4 <= count; i += 4){
+					simd::real4 x, y, z;
+					simd::load3x4(&points[i].x, x, y, z);
+					const simd::real4 d = simd::madd(dx, x, simd::madd(dy, y, simd::mul(dz, z)));
+					const simd::real4 mask = simd::cmpgt(d, bestd);
+					bestd = simd::select(mask, d, bestd);
+					bestIdx = simd::select(mask, laneIdx, bestIdx);
+					laneIdx = simd::add(laneIdx, four);
+				}
+
+				real ds[4], is[4];
+				simd::store(ds, bestd);
+				simd::store(is, bestIdx);
+				for (uinteger k = 0; k < 4; k++){
+					uinteger ik = (uinteger)is[k];
+					if (maxd < ds[k] || (maxd == ds[k] && ik < idx)){
+						maxd = ds[k];
+						idx = ik;
+					}
+				}
+			}
+#endif
+			for (; i < count; i++){
+				real d = direction.Dot(points[i]);
 				if (maxd < d){
 					maxd = d;
 					idx = i;
 				}
 			}
-			return pointSet[idx];
+			return idx;
+		}
+
+		// build vertex adjacency of triangle faces.
+		void BuildVertexAdjacency(const std::vector<TriangleFace16>& faces, uinteger pointCount,
+			std::vector<uinteger>& out_offsets, std::vector<uint16>& out_adjacency)
+		{
+			// directed edges as (from << 16 | to), sorted to remove duplicates.
+			std::vector<uint32> edges;
+			edges.reserve(faces.size() * 6);
+			uinteger sz = faces.size();
+			for (uinteger i = 0; i < sz; i++){
+				for (uinteger j = 0; j < 3; j++){
+					uint32 u = faces[i].idx[j];
+					uint32 v = faces[i].idx[(j + 1) % 3];
+					edges.push_back((u << 16) | v);
+					edges.push_back((v << 16) | u);
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+			out_offsets.assign(pointCount + 1, 0);
+			out_adjacency.resize(edges.size());
+			sz = edges.size();
+			for (uinteger i = 0; i < sz; i++){
+				out_offsets[(edges[i] >> 16) + 1]++;
+				out_adjacency[i] = (uint16)(edges[i] & 0xffff);
+			}
+			for (uinteger i = 0; i < pointCount; i++)
+				out_offsets[i + 1] += out_offsets[i];
+		}
+
+		// get index of farthest point by hill climbing.
+		uinteger HillClimbFarthestPoint(const Vector3* points, uinteger count,
+			const uinteger* offsets, const uint16* adjacency,
+			const Vector3& direction, uinteger start)
+		{
+			// visited vertices of the flat region where the climbing stops.
+			const uinteger PLATEAU_MAX = 32;
+			uinteger plateau[PLATEAU_MAX];
+
+			uinteger cur = start;
+			real curd = direction.Dot(points[cur]);
+			while (true){
+				// move to the farthest neighbor.
+				uinteger next = cur;
+				real nextd = curd;
+				for (uinteger k = offsets[cur]; k < offsets[cur + 1]; k++){
+					real d = direction.Dot(points[adjacency[k]]);
+					if (nextd < d){
+						nextd = d;
+						next = adjacency[k];
+					}
+				}
+
+				// no neighbor is farther. the triangles split from a flat
+				// polygon have the neighbors of the same distance, and the
+				// rounding can hide a farther vertex behind them, so it walks
+				// over the vertices within the rounding error of 'curd' and
+				// climbs again from the first farther one.
+				if (next == cur){
+					const Vector3& p = points[cur];
+					const real tol = 4 * math::EPSILON * (math::abs(direction.x * p.x)
+						+ math::abs(direction.y * p.y) + math::abs(direction.z * p.z));
+					uinteger n = 1;
+					plateau[0] = cur;
+					for (uinteger i = 0; i < n && next == cur; i++){
+						for (uinteger k = offsets[plateau[i]]; k < offsets[plateau[i] + 1]; k++){
+							const uinteger v = adjacency[k];
+							const real d = direction.Dot(points[v]);
+							if (curd < d){
+								nextd = d;
+								next = v;
+								break;
+							}
+							if (d < curd - tol || std::find(plateau, plateau + n, v) != plateau + n)
+								continue;
+							// too large flat region, the linear scan is cheaper.
+							if (n == PLATEAU_MAX)
+								return FarthestPointIndex(points, count, direction);
+							plateau[n++] = v;
+						}
+					}
+					if (next == cur)
+						return cur;
+				}
+				cur = next;
+				curd = nextd;
+			}
 		}
 
 		// separate axis theorem
@@ -34,7 +166,7 @@ namespace sark{
 				if (minA > d){
 					minA = d;
 				}
-				else if (maxA < d){
+				if (maxA < d){
 					maxA = d;
 				}
 			}
@@ -44,7 +176,7 @@ namespace sark{
 				if (minB > d){
 					minB = d;
 				}
-				else if (maxB < d){
+				if (maxB < d){
 					maxB = d;
 				}
 			}
@@ -70,6 +202,125 @@ namespace sark{
 			return com;
 		}
 
+		// ======================================================
+		//		batch transform functions of point sets
+		// ======================================================
+
+		// transform AoS positions by given matrix at once.
+		void TransformPoints(const Matrix4& M,
+			const Position3* in, uinteger count, Position3* out)
+		{
+			uinteger i = 0;
+#ifdef SARKLIB_USING_SIMD
+			// four positions per iteration as x, y and z lanes.
+			const simd::real4 m00 = simd::splat(M.m[0][0]), m01 = simd::splat(M.m[0][1]),
+				m02 = simd::splat(M.m[0][2]), m03 = simd::splat(M.m[0][3]);
+			const simd::real4 m10 = simd::splat(M.m[1][0]), m11 = simd::splat(M.m[1][1]),
+				m12 = simd::splat(M.m[1][2]), m13 = simd::splat(M.m[1][3]);
+			const simd::real4 m20 = simd::splat(M.m[2][0]), m21 = simd::splat(M.m[2][1]),
+				m22 = simd::splat(M.m[2][2]), m23 = simd::splat(M.m[2][3]);
+
+			for (; i + 4 <= count; i += 4) {
+				simd::real4 x, y, z;
+				simd::load3x4(&in[i].x, x, y, z);
+				simd::store3x4(&out[i].x,
+					simd::madd(m00, x, simd::madd(m01, y, simd::madd(m02, z, m03))),
+					simd::madd(m10, x, simd::madd(m11, y, simd::madd(m12, z, m13))),
+					simd::madd(m20, x, simd::madd(m21, y, simd::madd(m22, z, m23))));
+			}
+#endif
+			for (; i < count; i++) {
+				const real x = in[i].x, y = in[i].y, z = in[i].z;
+				out[i].Set(
+					M.m[0][0] * x + M.m[0][1] * y + M.m[0][2] * z + M.m[0][3],
+					M.m[1][0] * x + M.m[1][1] * y + M.m[1][2] * z + M.m[1][3],
+					M.m[2][0] * x + M.m[2][1] * y + M.m[2][2] * z + M.m[2][3]);
+			}
+		}
+
+		// transform SoA positions by given matrix at once.
+		void TransformPoints(const Matrix4& M,
+			const real* in_x, const real* in_y, const real* in_z, uinteger count,
+			real* out_x, real* out_y, real* out_z)
+		{
+			uinteger i = 0;
+#ifdef SARKLIB_USING_SIMD
+			const simd::real4 m00 = simd::splat(M.m[0][0]), m01 = simd::splat(M.m[0][1]),
+				m02 = simd::splat(M.m[0][2]), m03 = simd::splat(M.m[0][3]);
+			const simd::real4 m10 = simd::splat(M.m[1][0]), m11 = simd::splat(M.m[1][1]),
+				m12 = simd::splat(M.m[1][2]), m13 = simd::splat(M.m[1][3]);
+			const simd::real4 m20 = simd::splat(M.m[2][0]), m21 = simd::splat(M.m[2][1]),
+				m22 = simd::splat(M.m[2][2]), m23 = simd::splat(M.m[2][3]);
+
+			for (; i + 4 <= count; i += 4) {
+				const simd::real4 x = simd::load(in_x + i);
+				const simd::real4 y = simd::load(in_y + i);
+				const simd::real4 z = simd::load(in_z + i);
+				simd::store(out_x + i, simd::madd(m00, x, simd::madd(m01, y, simd::madd(m02, z, m03))));
+				simd::store(out_y + i, simd::madd(m10, x, simd::madd(m11, y, simd::madd(m12, z, m13))));
+				simd::store(out_z + i, simd::madd(m20, x, simd::madd(m21, y, simd::madd(m22, z, m23))));
+			}
+#endif
+			for (; i < count; i++) {
+				const real x = in_x[i], y = in_y[i], z = in_z[i];
+				out_x[i] = M.m[0][0] * x + M.m[0][1] * y + M.m[0][2] * z + M.m[0][3];
+				out_y[i] = M.m[1][0] * x + M.m[1][1] * y + M.m[1][2] * z + M.m[1][3];
+				out_z[i] = M.m[2][0] * x + M.m[2][1] * y + M.m[2][2] * z + M.m[2][3];
+			}
+		}
+
+		// transform AoS direction vectors by given matrix at once.
+		void TransformVectors(const Matrix4& M,
+			const Vector3* in, uinteger count, Vector3* out)
+		{
+			uinteger i = 0;
+#ifdef SARKLIB_USING_SIMD
+			const simd::real4 m00 = simd::splat(M.m[0][0]), m01 = simd::splat(M.m[0][1]), m02 = simd::splat(M.m[0][2]);
+			const simd::real4 m10 = simd::splat(M.m[1][0]), m11 = simd::splat(M.m[1][1]), m12 = simd::splat(M.m[1][2]);
+			const simd::real4 m20 = simd::splat(M.m[2][0]), m21 = simd::splat(M.m[2][1]), m22 = simd::splat(M.m[2][2]);
+
+			for (; i + 4 <= count; i += 4) {
+				simd::real4 x, y, z;
+				simd::load3x4(&in[i].x, x, y, z);
+				simd::store3x4(&out[i].x,
+					simd::madd(m00, x, simd::madd(m01, y, simd::mul(m02, z))),
+					simd::madd(m10, x, simd::madd(m11, y, simd::mul(m12, z))),
+					simd::madd(m20, x, simd::madd(m21, y, simd::mul(m22, z))));
+			}
+#endif
+			for (; i < count; i++) {
+				const real x = in[i].x, y = in[i].y, z = in[i].z;
+				out[i].Set(
+					M.m[0][0] * x + M.m[0][1] * y + M.m[0][2] * z,
+					M.m[1][0] * x + M.m[1][1] * y + M.m[1][2] * z,
+					M.m[2][0] * x + M.m[2][1] * y + M.m[2][2] * z);
+			}
+		}
+
+		// transform axis aligned box by given matrix.
+		void TransformAABox(const Matrix4& M,
+			const Vector3& min, const Vector3& max,
+			Vector3& out_min, Vector3& out_max)
+		{
+			// each output axis takes the smaller and the larger of the
+			// terms of each input axis. (J. Arvo, Graphics Gems)
+			for (uinteger i = 0; i < 3; i++) {
+				out_min.v[i] = out_max.v[i] = M.m[i][3];
+				for (uinteger j = 0; j < 3; j++) {
+					const real a = M.m[i][j] * min.v[j];
+					const real b = M.m[i][j] * max.v[j];
+					if (a < b) {
+						out_min.v[i] += a;
+						out_max.v[i] += b;
+					}
+					else {
+						out_min.v[i] += b;
+						out_max.v[i] += a;
+					}
+				}
+			}
+		}
+
 		// ======================================================
 		//		intersection check functions of basic shapes
 		//
@@ -794,5 +1045,280 @@ namespace sark{
 			return true;
 		}
 
+		// sphere - sphere contact.
+		bool Sphere_SphereContact(
+			const Vector3& sphere1_p, const real& sphere1_r,
+			const Vector3& sphere2_p, const real& sphere2_r,
+			Vector3& out_n, Vector3& out_P, real& out_depth)
+		{
+			const Vector3 d = sphere1_p - sphere2_p;
+			const real distSq = d.MagnitudeSq();
+			if (distSq > math::sqre(sphere1_r + sphere2_r))
+				return false;
+
+			// the concentric spheres are pushed up.
+			const real dist = math::sqrt(distSq);
+			out_n = (dist > 0 ? d / dist : Vector3::Up);
+			out_P = sphere1_p - out_n * sphere1_r;
+			out_depth = sphere1_r + sphere2_r - dist;
+			return true;
+		}
+
+		// sphere - oriented box contact.
+		bool Sphere_OBoxContact(
+			const Vector3& sphere_p, const real& sphere_r,
+			const Vector3& ob_p, const Vector3& ob_ext, const Vector3 ob_axis[3],
+			Vector3& out_n, Vector3& out_P, real& out_depth)
+		{
+			// the center of sphere in box space, and the closest point
+			// of the box to it.
+			const Vector3 d = sphere_p - ob_p;
+			Vector3 local, closest;
+			bool inside = true;
+			for (uinteger i = 0; i < 3; i++){
+				local.v[i] = ob_axis[i].Dot(d);
+				closest.v[i] = math::max(-ob_ext.v[i], math::min(local.v[i], ob_ext.v[i]));
+				if (closest.v[i] != local.v[i])
+					inside = false;
+			}
+
+			if (inside){
+				// out through the nearest face.
+				uinteger face = 0;
+				real faceDist = REAL_MAX;
+				for (uinteger i = 0; i < 3; i++){
+					const real dist = ob_ext.v[i] - math::abs(local.v[i]);
+					if (dist < faceDist){
+						faceDist = dist;
+						face = i;
+					}
+				}
+				out_n = (local.v[face] >= 0 ? ob_axis[face] : -ob_axis[face]);
+				out_P = sphere_p - out_n * sphere_r;
+				out_depth = sphere_r + faceDist;
+				return true;
+			}
+
+			const Vector3 onBox = ob_p + ob_axis[0] * closest.x + ob_axis[1] * closest.y + ob_axis[2] * closest.z;
+			const Vector3 v = sphere_p - onBox;
+			const real distSq = v.MagnitudeSq();
+			if (distSq > math::sqre(sphere_r))
+				return false;
+
+			const real dist = math::sqrt(distSq);
+			out_n = v / dist;
+			out_P = sphere_p - out_n * sphere_r;
+			out_depth = sphere_r - dist;
+			return true;
+		}
+
+		namespace {
+
+			// the face axis of the other box replaces the current one only
+			// if it is better by them, so the reference face does not swap
+			// between the frames on a tie.
+			const real SAT_RELATIVE_TOLERANCE = 0.98f;
+			const real SAT_ABSOLUTE_TOLERANCE = 0.001f;
+
+			// the cross axes of the near parallel edges are skipped.
+			const real SAT_MIN_CROSS_SQ = 0.000001f;
+
+			// half length of the box along the axis.
+			inline real ProjectOBox(const Vector3& ext, const Vector3 axis[3], const Vector3& L) {
+				return ext.x * math::abs(axis[0].Dot(L))
+					+ ext.y * math::abs(axis[1].Dot(L))
+					+ ext.z * math::abs(axis[2].Dot(L));
+			}
+
+			// clip polygon by the plane, and keep the part behind it.
+			// (Sutherland-Hodgman)
+			uinteger ClipByPlane(const Vector3* in, uinteger count,
+				const Vector3& plane_n, real plane_d, Vector3* out)
+			{
+				uinteger outCount = 0;
+				for (uinteger i = 0; i < count; i++){
+					const Vector3& P = in[i];
+					const Vector3& Q = in[(i + 1) % count];
+					const real dP = plane_n.Dot(P) - plane_d;
+					const real dQ = plane_n.Dot(Q) - plane_d;
+					if (dP <= 0)
+						out[outCount++] = P;
+					if ((dP < 0 && dQ > 0) || (dP > 0 && dQ < 0))
+						out[outCount++] = P + (Q - P) * (dP / (dP - dQ));
+				}
+				return outCount;
+			}
+
+			// clip the incident face of the box by the side planes of the
+			// reference face of the other box.
+			// *param:
+			//     ref_*     - the box of the reference face.
+			//     refFace   - the axis of the reference face.
+			//     refNormal - outward unit normal of the reference face.
+			//     inc_*     - the box of the incident face.
+			//     out_points,out_separations - the clipped points, and their
+			//                                  heights over the reference face.
+			// *return: the number of clipped points.
+			uinteger ClipOBoxFaces(
+				const Vector3& ref_p, const Vector3& ref_ext, const Vector3 ref_axis[3],
+				uinteger refFace, const Vector3& refNormal,
+				const Vector3& inc_p, const Vector3& inc_ext, const Vector3 inc_axis[3],
+				Vector3* out_points, real* out_separations)
+			{
+				// the incident face is the most anti-parallel one.
+				uinteger incFace = 0;
+				real best = -1.f;
+				for (uinteger i = 0; i < 3; i++){
+					const real c = math::abs(inc_axis[i].Dot(refNormal));
+					if (c > best){
+						best = c;
+						incFace = i;
+					}
+				}
+				const Vector3 incNormal = (inc_axis[incFace].Dot(refNormal) > 0 ? -inc_axis[incFace] : inc_axis[incFace]);
+				const Vector3 incCenter = inc_p + incNormal * inc_ext.v[incFace];
+				const uinteger u = (incFace + 1) % 3, v = (incFace + 2) % 3;
+				const Vector3 eu = inc_axis[u] * inc_ext.v[u];
+				const Vector3 ev = inc_axis[v] * inc_ext.v[v];
+
+				Vector3 clip[2][OBOX_CONTACT_MAX_POINTS * 2];
+				clip[0][0] = incCenter + eu + ev;
+				clip[0][1] = incCenter - eu + ev;
+				clip[0][2] = incCenter - eu - ev;
+				clip[0][3] = incCenter + eu - ev;
+				uinteger count = 4, cur = 0;
+				for (uinteger i = 1; i < 3 && count > 0; i++){
+					const uinteger side = (refFace + i) % 3;
+					const Vector3& n = ref_axis[side];
+					const real c = n.Dot(ref_p);
+					count = ClipByPlane(clip[cur], count, n, c + ref_ext.v[side], clip[1 - cur]);
+					cur = 1 - cur;
+					count = ClipByPlane(clip[cur], count, -n, -c + ref_ext.v[side], clip[1 - cur]);
+					cur = 1 - cur;
+				}
+
+				const real refD = refNormal.Dot(ref_p) + ref_ext.v[refFace];
+				for (uinteger i = 0; i < count; i++){
+					out_points[i] = clip[cur][i];
+					out_separations[i] = refNormal.Dot(clip[cur][i]) - refD;
+				}
+				return count;
+			}
+
+		}
+
+		// oriented box - oriented box contact.
+		uinteger OBox_OBoxContact(
+			const Vector3& ob1_p, const Vector3& ob1_ext, const Vector3 ob1_axis[3],
+			const Vector3& ob2_p, const Vector3& ob2_ext, const Vector3 ob2_axis[3],
+			real margin, Vector3& out_n,
+			Vector3 out_points[OBOX_CONTACT_MAX_POINTS], real out_depths[OBOX_CONTACT_MAX_POINTS])
+		{
+			const Vector3 d = ob1_p - ob2_p;
+
+			// face axes of box 1, and then of box 2.
+			// 'axis' is 0-2 for box 1, 3-5 for box 2, and 6-14 for edges.
+			uinteger axis = 0;
+			real depth = REAL_MAX;
+			for (uinteger b = 0; b < 2; b++){
+				const Vector3* faces = (b == 0 ? ob1_axis : ob2_axis);
+				for (uinteger i = 0; i < 3; i++){
+					const Vector3& L = faces[i];
+					const real overlap = ProjectOBox(ob1_ext, ob1_axis, L) + ProjectOBox(ob2_ext, ob2_axis, L)
+						- math::abs(d.Dot(L));
+					if (overlap < 0)
+						return 0;
+					if (b == 0 ? overlap < depth
+						: overlap < SAT_RELATIVE_TOLERANCE * depth - SAT_ABSOLUTE_TOLERANCE)
+					{
+						depth = overlap;
+						axis = b * 3 + i;
+					}
+				}
+			}
+
+			// edge axes.
+			Vector3 edgeL(0.f);
+			for (uinteger i = 0; i < 3; i++){
+				for (uinteger j = 0; j < 3; j++){
+					Vector3 L = ob1_axis[i].Cross(ob2_axis[j]);
+					const real lenSq = L.MagnitudeSq();
+					if (lenSq < SAT_MIN_CROSS_SQ)
+						continue;
+					L = L / math::sqrt(lenSq);
+					const real overlap = ProjectOBox(ob1_ext, ob1_axis, L) + ProjectOBox(ob2_ext, ob2_axis, L)
+						- math::abs(d.Dot(L));
+					if (overlap < 0)
+						return 0;
+					if (overlap < SAT_RELATIVE_TOLERANCE * depth - SAT_ABSOLUTE_TOLERANCE){
+						depth = overlap;
+						axis = 6 + i * 3 + j;
+						edgeL = L;
+					}
+				}
+			}
+
+			// the normal from box 2 to box 1.
+			Vector3 n = (axis < 3 ? ob1_axis[axis] : (axis < 6 ? ob2_axis[axis - 3] : edgeL));
+			if (n.Dot(d) < 0)
+				n = -n;
+			out_n = n;
+
+			if (axis < 6){
+				Vector3 points[OBOX_CONTACT_MAX_POINTS];
+				real separations[OBOX_CONTACT_MAX_POINTS];
+				uinteger count;
+				uinteger out_count = 0;
+				if (axis >= 3){
+					// the reference face is on box 2, and the incident
+					// points are on box 1.
+					count = ClipOBoxFaces(ob2_p, ob2_ext, ob2_axis, axis - 3, n,
+						ob1_p, ob1_ext, ob1_axis, points, separations);
+					for (uinteger i = 0; i < count; i++){
+						if (separations[i] <= margin){
+							out_points[out_count] = points[i];
+							out_depths[out_count++] = math::max(-separations[i], 0);
+						}
+					}
+				}
+				else{
+					// the reference face is on box 1, and the incident
+					// points on box 2 are projected onto it.
+					count = ClipOBoxFaces(ob1_p, ob1_ext, ob1_axis, axis, -n,
+						ob2_p, ob2_ext, ob2_axis, points, separations);
+					for (uinteger i = 0; i < count; i++){
+						if (separations[i] <= margin){
+							out_points[out_count] = points[i] + n * separations[i];
+							out_depths[out_count++] = math::max(-separations[i], 0);
+						}
+					}
+				}
+				return out_count;
+			}
+
+			// the closest points of the edges. they are the edges of the
+			// supporting corners along the normal.
+			const uinteger edge1 = (axis - 6) / 3, edge2 = (axis - 6) % 3;
+			Vector3 P1 = ob1_p, P2 = ob2_p;
+			for (uinteger i = 0; i < 3; i++){
+				if (i != edge1)
+					P1 += ob1_axis[i] * (ob1_axis[i].Dot(n) > 0 ? -ob1_ext.v[i] : ob1_ext.v[i]);
+				if (i != edge2)
+					P2 += ob2_axis[i] * (ob2_axis[i].Dot(n) > 0 ? ob2_ext.v[i] : -ob2_ext.v[i]);
+			}
+			const Vector3& u1 = ob1_axis[edge1];
+			const Vector3& u2 = ob2_axis[edge2];
+			const Vector3 r = P1 - P2;
+			const real b = u1.Dot(u2);
+			const real denom = 1.f - b * b;
+			real t1 = 0;
+			if (denom > SAT_MIN_CROSS_SQ)
+				t1 = (b * u2.Dot(r) - u1.Dot(r)) / denom;
+			t1 = math::max(-ob1_ext.v[edge1], math::min(t1, ob1_ext.v[edge1]));
+			out_points[0] = P1 + u1 * t1;
+			out_depths[0] = depth;
+			return 1;
+		}
+
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "core.h"
+#include "primitives.hpp"
 
 namespace sark {
 	namespace tool {
@@ -31,6 +32,46 @@ namespace sark {
 		const Vector3 FarthestPointInDirection(
 			const std::vector<Vector3>& pointSet, const Vector3& direction);
 
+		// get index of farthest point in given direction by linear scan.
+		// the first one is chosen among the same distances.
+		// *param:
+		//     points    - point array.
+		//     count     - the number of points. it should be positive.
+		//     direction - search direction.
+		uinteger FarthestPointIndex(const Vector3* points, uinteger count,
+			const Vector3& direction);
+
+		// build vertex adjacency of triangle faces as compressed rows.
+		// neighbors of vertex i are
+		// out_adjacency[out_offsets[i]] ~ out_adjacency[out_offsets[i + 1] - 1].
+		// *param:
+		//     faces         - triangle faces.
+		//     pointCount    - the number of vertices.
+		//     out_offsets   - output row offsets. (pointCount + 1 elements)
+		//     out_adjacency - output neighbor indices.
+		void BuildVertexAdjacency(const std::vector<TriangleFace16>& faces, uinteger pointCount,
+			std::vector<uinteger>& out_offsets, std::vector<uint16>& out_adjacency);
+
+		// get index of farthest point in given direction by hill climbing
+		// over vertex adjacency of convex polyhedron.
+		// it moves to the farthest neighbor until no neighbor is farther,
+		// so its cost depends on the distance from 'start' to the result.
+		// where it stops, it also walks over the neighbors of the same
+		// distance, e.g. on the triangles of a flat polygon, and it falls
+		// back to the linear scan if they are too many.
+		// *note: it is correct only for the vertices of convex polyhedron,
+		// and 'start' should have one neighbor at least.
+		// *param:
+		//     points    - vertex array.
+		//     count     - the number of vertices.
+		//     offsets   - row offsets from BuildVertexAdjacency.
+		//     adjacency - neighbor indices from BuildVertexAdjacency.
+		//     direction - search direction.
+		//     start     - index of vertex to start. (e.g. the last result)
+		uinteger HillClimbFarthestPoint(const Vector3* points, uinteger count,
+			const uinteger* offsets, const uint16* adjacency,
+			const Vector3& direction, uinteger start);
+
 		// separate axis theorem
 		bool SeparateAxisTest(
 			const std::vector<Vector3>& pointsA, const std::vector<Vector3>& pointsB,
@@ -39,6 +80,66 @@ namespace sark {
 		// compute center of mass
 		const Vector3 ComputeCenterOfMass(const std::vector<Vector3>& points);
 
+		// ======================================================
+		//		batch transform functions of point sets
+		// ======================================================
+
+		// transform AoS positions by given matrix at once.
+		// out[i] = (M * Vector4(in[i], 1)).xyz
+		// *note: 'out' can be same as 'in'. the last row of M is
+		// ignored, so it is for affine transform only.
+		// *param:
+		//     M     - transform matrix.
+		//     in    - input positions.
+		//     count - the number of positions.
+		//     out   - output positions.
+		void TransformPoints(const Matrix4& M,
+			const Position3* in, uinteger count, Position3* out);
+
+		// transform SoA positions by given matrix at once.
+		// *note: output arrays can be same as input arrays.
+		// *param:
+		//     M                   - transform matrix.
+		//     in_x, in_y, in_z    - input coordinate arrays.
+		//     count               - the number of positions.
+		//     out_x, out_y, out_z - output coordinate arrays.
+		void TransformPoints(const Matrix4& M,
+			const real* in_x, const real* in_y, const real* in_z, uinteger count,
+			real* out_x, real* out_y, real* out_z);
+
+		// transform AoS direction vectors by given matrix at once.
+		// out[i] = (M * Vector4(in[i], 0)).xyz
+		// *note: 'out' can be same as 'in'. it does not normalize output.
+		// *param:
+		//     M     - transform matrix.
+		//     in    - input vectors.
+		//     count - the number of vectors.
+		//     out   - output vectors.
+		void TransformVectors(const Matrix4& M,
+			const Vector3* in, uinteger count, Vector3* out);
+
+		// transform axis aligned box by given matrix.
+		// the output is the axis aligned box bounding the transformed box,
+		// so it is larger than the original one on rotation.
+		// *note: outputs can not be same as inputs.
+		// *param:
+		//     M       - affine transform matrix.
+		//     min,max - input box.
+		//     out_min - output minimum position.
+		//     out_max - output maximum position.
+		void TransformAABox(const Matrix4& M,
+			const Vector3& min, const Vector3& max,
+			Vector3& out_min, Vector3& out_max);
+
+		// transform position set by given matrix at once.
+		// 'out' is resized as same as 'in'.
+		inline void TransformPoints(const Matrix4& M,
+			const std::vector<Position3>& in, std::vector<Position3>& out) {
+			out.resize(in.size());
+			if (!in.empty())
+				TransformPoints(M, &in[0], in.size(), &out[0]);
+		}
+
 		// ======================================================
 		//		intersection check functions of basic shapes
 		// ======================================================
@@ -224,6 +325,73 @@ namespace sark {
 			const Vector3& ob1_p, const Vector3& ob1_ext, const Vector3 ob1_axis[3],
 			const Vector3& ob2_p, const Vector3& ob2_ext, const Vector3 ob2_axis[3]);
 
+
+		// ======================================================
+		//		contact generation functions of basic shapes
+		// ======================================================
+		// the contact normal points from the second shape to the first,
+		// and the contact points are on the first shape. the matching
+		// point on the second shape is (P + normal * depth).
+
+		// sphere - sphere contact.
+		// *param:
+		//     sphere1_p - origin position of sphere 1.
+		//     sphere1_r - radius of sphere 1.
+		//     sphere2_p - origin position of sphere 2.
+		//     sphere2_r - radius of sphere 2.
+		//     out_n     - unit contact normal.
+		//     out_P     - the deepest point of sphere 1.
+		//     out_depth - penetration depth.
+		bool Sphere_SphereContact(
+			const Vector3& sphere1_p, const real& sphere1_r,
+			const Vector3& sphere2_p, const real& sphere2_r,
+			Vector3& out_n, Vector3& out_P, real& out_depth);
+
+		// sphere - oriented box contact.
+		// the sphere whose center is in the box is pushed out
+		// through the nearest face.
+		// *param:
+		//     sphere_p  - origin position of sphere.
+		//     sphere_r  - radius of sphere.
+		//     ob_p      - center position of oriented box.
+		//     ob_ext    - extention of oriented box.
+		//     ob_axis   - orthonormal axis of oriented box.
+		//     out_n     - unit contact normal. it points from the box.
+		//     out_P     - the deepest point of sphere.
+		//     out_depth - penetration depth.
+		bool Sphere_OBoxContact(
+			const Vector3& sphere_p, const real& sphere_r,
+			const Vector3& ob_p, const Vector3& ob_ext, const Vector3 ob_axis[3],
+			Vector3& out_n, Vector3& out_P, real& out_depth);
+
+		// the maximum number of points of OBox_OBoxContact.
+		const uinteger OBOX_CONTACT_MAX_POINTS = 8;
+
+		// oriented box - oriented box contact.
+		// the normal is the separating axis of the least penetration
+		// among the 15 axes of SAT, and the face axes are preferred to
+		// the edge axes on a near tie. the face contact clips the incident
+		// face by the side planes of the reference face, and the edge
+		// contact has the closest point of the two edges.
+		// *param:
+		//     ob1_p      - center position of oriented box 1.
+		//     ob1_ext    - extention of oriented box 1.
+		//     ob1_axis   - orthonormal axis of oriented box 1.
+		//     ob2_p      - center position of oriented box 2.
+		//     ob2_ext    - extention of oriented box 2.
+		//     ob2_axis   - orthonormal axis of oriented box 2.
+		//     margin     - the clipped points above the reference face
+		//                  within it are also contacts. (0 depth)
+		//     out_n      - unit contact normal.
+		//     out_points - contact points on box 1.
+		//     out_depths - penetration depths of the points.
+		// *return: the number of points, or 0 if they are separated.
+		uinteger OBox_OBoxContact(
+			const Vector3& ob1_p, const Vector3& ob1_ext, const Vector3 ob1_axis[3],
+			const Vector3& ob2_p, const Vector3& ob2_ext, const Vector3 ob2_axis[3],
+			real margin, Vector3& out_n,
+			Vector3 out_points[OBOX_CONTACT_MAX_POINTS], real out_depths[OBOX_CONTACT_MAX_POINTS]);
+
 	}
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+
+#include "core.h"
+#include "SweepAndPrune.h"
+#include "DynamicAABBTree.h"
+
+/**
+equivalence check of the broad-phases against the brute force.
+
+the proxies are added, removed, moved by small steps and teleported
+over frames, some of them have the infinite bounds as the components
+without collider (see Collision::FindPairs), and their user data are
+changed. on each frame,
+  - sweep and prune finds exactly the pairs of the overlapping boxes.
+  - the tree finds them, and the others only if their fat boxes overlap.
+  - no pair is duplicated, and 'a' is less than 'b'.
+it returns non-zero when any of them fails.
+*/
+
+using namespace sark;
+
+namespace {
+
+	int gFailures = 0;
+
+	void Check(const char* name, double value, double tolerance){
+		bool ok = (value <= tolerance);
+		printf("%-40s %12.4g (tolerance %.3g) %s\n", name, value, tolerance, ok ? "ok" : "FAILED");
+		if (!ok)
+			gFailures++;
+	}
+
+	// splitmix64 as the benchmark, with fixed seed.
+	uint64 gState = 0x42524f4144ULL;
+	double Rand(double lo, double hi){
+		uint64 z = (gState += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z = z ^ (z >> 31);
+		return lo + (hi - lo) * ((z >> 11) * (1.0 / 9007199254740992.0));
+	}
+
+	struct Object {
+		Vector3 min, max;
+		ABroadphase::ProxyID sap, tree;
+		uinteger userData;
+		bool alive;
+	};
+
+	bool Overlap(const Vector3& min1, const Vector3& max1, const Vector3& min2, const Vector3& max2){
+		return !(max1.x < min2.x || max2.x < min1.x
+			|| max1.y < min2.y || max2.y < min1.y
+			|| max1.z < min2.z || max2.z < min1.z);
+	}
+
+	void RandomBox(Object& o){
+		if (Rand(0, 1) < 0.02){
+			o.min = -REAL_MAX;
+			o.max = REAL_MAX;
+			return;
+		}
+		Vector3 c((real)Rand(-20, 20), (real)Rand(-20, 20), (real)Rand(-20, 20));
+		Vector3 e((real)Rand(0.1, 2.0), (real)Rand(0.1, 2.0), (real)Rand(0.1, 2.0));
+		o.min = c - e;
+		o.max = c + e;
+	}
+
+	typedef std::set<std::pair<uinteger, uinteger> > PairSet;
+
+	// pairs of the broad-phase as the set, and the count of the bad ones.
+	void Collect(const ABroadphase::PairArray& pairs, PairSet& out_set, int& inout_bad){
+		out_set.clear();
+		for (auto& p : pairs){
+			if (p.a >= p.b || !out_set.insert(std::make_pair(p.a, p.b)).second)
+				inout_bad++;
+		}
+	}
+
+	void CheckBroadphases(){
+		SweepAndPrune sap;
+		DynamicAABBTree tree;
+		std::vector<Object> objects;
+
+		int sapMissing = 0, sapExtra = 0, treeMissing = 0, treeExtra = 0, bad = 0;
+		uinteger maxPairs = 0;
+		uinteger nextUserData = 0;
+		for (int frame = 0; frame < 300; frame++){
+			// add and remove.
+			int adds = (frame == 0 ? 300 : (int)Rand(0, 4));
+			for (int i = 0; i < adds; i++){
+				Object o;
+				RandomBox(o);
+				o.userData = nextUserData++;
+				o.alive = true;
+				o.sap = sap.AddProxy(o.min, o.max, o.userData);
+				o.tree = tree.AddProxy(o.min, o.max, o.userData);
+				objects.push_back(o);
+			}
+			int removes = (int)Rand(0, 4);
+			for (int i = 0; i < removes; i++){
+				Object& o = objects[(uinteger)Rand(0, (double)objects.size())];
+				if (!o.alive)
+					continue;
+				sap.RemoveProxy(o.sap);
+				tree.RemoveProxy(o.tree);
+				o.alive = false;
+			}
+
+			// move by small steps, teleport a few, and give new user data
+			// on some frames, as Collision::FindPairs does by the order.
+			bool reorder = (frame % 50 == 25);
+			uinteger reordered = 0;
+			for (auto& o : objects){
+				if (!o.alive)
+					continue;
+				double r = Rand(0, 1);
+				if (r < 0.01){
+					RandomBox(o);
+				}
+				else if (o.max.x != REAL_MAX){
+					Vector3 d((real)Rand(-0.3, 0.3), (real)Rand(-0.3, 0.3), (real)Rand(-0.3, 0.3));
+					o.min += d;
+					o.max += d;
+				}
+				sap.UpdateProxy(o.sap, o.min, o.max);
+				tree.UpdateProxy(o.tree, o.min, o.max);
+				if (reorder){
+					o.userData = nextUserData + (reordered * 7919) % objects.size();
+					reordered++;
+					sap.SetUserData(o.sap, o.userData);
+					tree.SetUserData(o.tree, o.userData);
+				}
+			}
+
+			if (reorder)
+				nextUserData += objects.size();
+
+			// brute force by user data.
+			PairSet expected, fat;
+			for (uinteger i = 0; i < objects.size(); i++){
+				const Object& a = objects[i];
+				if (!a.alive)
+					continue;
+				Vector3 fatMinA, fatMaxA;
+				tree.GetFatBounds(a.tree, fatMinA, fatMaxA);
+				for (uinteger j = i + 1; j < objects.size(); j++){
+					const Object& b = objects[j];
+					if (!b.alive)
+						continue;
+					std::pair<uinteger, uinteger> key(std::min(a.userData, b.userData), std::max(a.userData, b.userData));
+					if (Overlap(a.min, a.max, b.min, b.max))
+						expected.insert(key);
+					Vector3 fatMinB, fatMaxB;
+					tree.GetFatBounds(b.tree, fatMinB, fatMaxB);
+					if (Overlap(fatMinA, fatMaxA, fatMinB, fatMaxB))
+						fat.insert(key);
+				}
+			}
+			maxPairs = std::max(maxPairs, (uinteger)expected.size());
+
+			PairSet found;
+			Collect(sap.FindPairs(), found, bad);
+			for (auto& p : expected)
+				sapMissing += (found.count(p) == 0);
+			for (auto& p : found)
+				sapExtra += (expected.count(p) == 0);
+
+			Collect(tree.FindPairs(), found, bad);
+			for (auto& p : expected)
+				treeMissing += (found.count(p) == 0);
+			for (auto& p : found)
+				treeExtra += (fat.count(p) == 0);
+		}
+
+		printf("%-40s %12u\n", "max pairs of a frame", (unsigned)maxPairs);
+		Check("sweep and prune missing pairs", sapMissing, 0);
+		Check("sweep and prune extra pairs", sapExtra, 0);
+		Check("tree missing pairs", treeMissing, 0);
+		Check("tree pairs of separated fat boxes", treeExtra, 0);
+		Check("duplicated or unordered pairs", bad, 0);
+		Check("proxy count difference", fabs((double)sap.GetProxyCount() - tree.GetProxyCount()), 0);
+	}
+}
+
+int main(){
+	CheckBroadphases();
+
+	printf("%d failure(s)\n", gFailures);
+	return (gFailures == 0 ? 0 : 1);
+}
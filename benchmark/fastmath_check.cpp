@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include "core.h"
+#include "tools.h"
+#include "fastmath.hpp"
+
+/**
+accuracy check of SARKLIB_USING_FASTMATH.
+
+it is built with the fast math mode, and compares the results with
+double precision references computed here by math.h.
+  1. error of every approx_* kernel against its documented bound.
+  2. rigid body rotation integrated for a long time (as RigidBody::Update).
+  3. angle between two vectors (as Vector3::Angle).
+  4. ray and box intersection tests on normalized inputs.
+it returns non-zero when any of them is out of tolerance.
+*/
+
+using namespace sark;
+
+namespace {
+
+	int gFailures = 0;
+
+	void Check(const char* name, double value, double tolerance){
+		bool ok = (value <= tolerance);
+		printf("%-34s %12.4g (tolerance %.3g) %s\n", name, value, tolerance, ok ? "ok" : "FAILED");
+		if (!ok)
+			gFailures++;
+	}
+
+	// splitmix64 as the benchmark, with fixed seed.
+	uint64 gState = 0x5a4b4c4942ULL;
+	double Rand(double lo, double hi){
+		uint64 z = (gState += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z = z ^ (z >> 31);
+		return lo + (hi - lo) * ((z >> 11) * (1.0 / 9007199254740992.0));
+	}
+
+	const Vector3 RandDirection(){
+		double x, y, z, m;
+		do{
+			x = Rand(-1, 1); y = Rand(-1, 1); z = Rand(-1, 1);
+			m = x*x + y*y + z*z;
+		} while (m < 0.01 || m > 1.0);
+		m = sqrt(m);
+		return Vector3((real)(x / m), (real)(y / m), (real)(z / m));
+	}
+
+
+	//=============================================
+	//		1. kernels
+	//=============================================
+
+	void CheckKernels(){
+		double e = 0.0;
+		for (float x = 1e-6f; x < 1e6f; x *= 1.0001f){
+			double ref = 1.0 / sqrt((double)x);
+			e = std::max(e, fabs(math::fast::approx_rsqrt(x) - ref) / ref);
+		}
+		Check("approx_rsqrt relative error", e, 5.0e-6);
+
+		double es = 0.0, ec = 0.0;
+		for (double d = -1000.0; d < 1000.0; d += 0.0007){
+			float x = (float)d;
+			es = std::max(es, fabs(math::fast::approx_sin(x) - sin((double)x)));
+			ec = std::max(ec, fabs(math::fast::approx_cos(x) - cos((double)x)));
+		}
+		Check("approx_sin absolute error", es, 2.0e-7);
+		Check("approx_cos absolute error", ec, 2.0e-7);
+
+		e = 0.0;
+		for (double d = -1.0; d <= 1.0; d += 1e-6){
+			float x = (float)d;
+			e = std::max(e, fabs(math::fast::approx_acos(x) - acos((double)x)));
+		}
+		Check("approx_acos absolute error", e, 5.0e-7);
+
+		e = 0.0;
+		const double scales[3] = { 1e-3, 1.0, 1e3 };
+		for (double a = -3.14159; a < 3.14159; a += 1e-5){
+			for (int i = 0; i < 3; i++){
+				float y = (float)(scales[i] * sin(a));
+				float x = (float)(scales[i] * cos(a));
+				e = std::max(e, fabs(math::fast::approx_atan2(y, x) - atan2((double)y, (double)x)));
+			}
+		}
+		Check("approx_atan2 absolute error", e, 2.0e-6);
+	}
+
+
+	//=============================================
+	//		2. rigid body rotation
+	//=============================================
+
+	// orientation integrated by q(t+dt) = q_w(t)q(t) for 100 seconds
+	// at 60Hz, with the library (fast math) and with double precision.
+	void CheckRotation(){
+		double maxAngle = 0.0;
+		double maxNormError = 0.0;
+		for (int body = 0; body < 32; body++){
+			Vector3 w = RandDirection() * (real)Rand(0.1, 20.0);
+			const real dt = 1.f / 60.f;
+
+			Quaternion q(0.f, 0.f, 0.f, 1.f);
+			double rq[4] = { 0.0, 0.0, 0.0, 1.0 }; // x, y, z, s
+
+			for (int step = 0; step < 6000; step++){
+				// library path, same as RigidBody::Update.
+				real magw = w.Magnitude();
+				real half_theta = magw*dt / 2.f;
+				Vector3 unitw = w / magw;
+				Quaternion q_w(math::fast::sin(half_theta)*unitw, math::fast::cos(half_theta));
+				q = q_w * q;
+				q.Normalize();
+
+				// reference
+				double hs = sin((double)half_theta), hc = cos((double)half_theta);
+				double wx = hs * unitw.x, wy = hs * unitw.y, wz = hs * unitw.z;
+				double x = rq[0], y = rq[1], z = rq[2], s = rq[3];
+				rq[0] = hc*x + wx*s + wy*z - wz*y;
+				rq[1] = hc*y + wy*s + wz*x - wx*z;
+				rq[2] = hc*z + wz*s + wx*y - wy*x;
+				rq[3] = hc*s - wx*x - wy*y - wz*z;
+				double m = sqrt(rq[0]*rq[0] + rq[1]*rq[1] + rq[2]*rq[2] + rq[3]*rq[3]);
+				for (int i = 0; i < 4; i++)
+					rq[i] /= m;
+			}
+
+			double dot = fabs(q.x*rq[0] + q.y*rq[1] + q.z*rq[2] + q.s*rq[3]);
+			maxAngle = std::max(maxAngle, 2.0 * acos(std::min(dot, 1.0)));
+			maxNormError = std::max(maxNormError, fabs((double)q.Magnitude() - 1.0));
+		}
+		Check("rotation drift after 6000 steps", maxAngle, 1.0e-2);
+		Check("rotation norm error", maxNormError, 1.0e-5);
+
+		// slerp of the shorter arc
+		double e = 0.0;
+		for (int i = 0; i < 1000; i++){
+			Quaternion q0(RandDirection(), (real)Rand(-3.0, 3.0), true);
+			Quaternion q1(RandDirection(), (real)Rand(-3.0, 3.0), true);
+			if (q0.Dot(q1) < 0.f)
+				q1 = -1.f * q1;
+			real t = (real)Rand(0.0, 1.0);
+			Quaternion q = Quaternion::Slerp(q0, q1, t);
+
+			double d = std::min(1.0, (double)q0.Dot(q1));
+			double phi = acos(d);
+			if (phi < 1e-6)
+				continue;
+			double a = sin(phi*(1.0 - t)) / sin(phi), b = sin(phi*t) / sin(phi);
+			e = std::max(e, fabs(q.x - (a*q0.x + b*q1.x)));
+			e = std::max(e, fabs(q.s - (a*q0.s + b*q1.s)));
+		}
+		Check("slerp absolute error", e, 1.0e-3);
+	}
+
+
+	//=============================================
+	//		3. angle between vectors
+	//=============================================
+
+	// the reference is taken from the same float inputs, so the error
+	// is of the normalization and the acos kernel only. it grows near
+	// the parallel vectors, where acos is ill-conditioned.
+	void CheckAngle(){
+		double e = 0.0;
+		for (int i = 0; i < 20000; i++){
+			Vector3 v1 = RandDirection() * (real)Rand(0.1, 100.0);
+			Vector3 v2 = RandDirection() * (real)Rand(0.1, 100.0);
+			double l1 = sqrt((double)v1.x*v1.x + (double)v1.y*v1.y + (double)v1.z*v1.z);
+			double l2 = sqrt((double)v2.x*v2.x + (double)v2.y*v2.y + (double)v2.z*v2.z);
+			double d = ((double)v1.x*v2.x + (double)v1.y*v2.y + (double)v1.z*v2.z) / (l1 * l2);
+			double ref = acos(std::max(-1.0, std::min(1.0, d)));
+			e = std::max(e, fabs(Vector3::Angle(v1, v2) - ref));
+		}
+		Check("vector3 angle absolute error", e, 1.0e-4);
+	}
+
+
+	//=============================================
+	//		4. intersections
+	//=============================================
+
+	void CheckIntersections(){
+		int mismatches = 0;
+		double maxPointError = 0.0;
+		for (int i = 0; i < 20000; i++){
+			// ray direction normalized by the library, and by double precision.
+			Vector3 v((real)Rand(-1, 1), (real)Rand(-1, 1), (real)Rand(-1, 1));
+			if (v.MagnitudeSq() < 0.01f)
+				continue;
+			double m = sqrt((double)v.x*v.x + (double)v.y*v.y + (double)v.z*v.z);
+			Vector3 fastV = v.Normal();
+			Vector3 refV((real)(v.x / m), (real)(v.y / m), (real)(v.z / m));
+
+			Vector3 p((real)Rand(-6, 6), (real)Rand(-6, 6), (real)Rand(-6, 6));
+			Vector3 c((real)Rand(-3, 3), (real)Rand(-3, 3), (real)Rand(-3, 3));
+			real r = (real)Rand(0.5, 2.5);
+
+			Vector3 fastP, refP;
+			bool fastHit = tool::Ray_SphereIntersection(p, fastV, 20.f, c, r, &fastP);
+			bool refHit = tool::Ray_SphereIntersection(p, refV, 20.f, c, r, &refP);
+			if (fastHit != refHit){
+				// allowed only for the grazing rays.
+				Vector3 toC = c - p;
+				double dist = (toC - toC.Dot(refV)*refV).Magnitude();
+				if (fabs(dist - r) > 1e-4)
+					mismatches++;
+			}
+			else if (fastHit){
+				maxPointError = std::max(maxPointError, (double)(fastP - refP).Magnitude());
+			}
+		}
+		Check("ray-sphere hit mismatches", mismatches, 0);
+		Check("ray-sphere hit point error", maxPointError, 1.0e-3);
+
+		// oriented boxes from the rotation quaternions.
+		mismatches = 0;
+		for (int i = 0; i < 20000; i++){
+			Vector3 axis1 = RandDirection(), axis2 = RandDirection();
+			real theta1 = (real)Rand(-3.0, 3.0), theta2 = (real)Rand(-3.0, 3.0);
+			Vector3 p1((real)Rand(-3, 3), (real)Rand(-3, 3), (real)Rand(-3, 3));
+			Vector3 p2((real)Rand(-3, 3), (real)Rand(-3, 3), (real)Rand(-3, 3));
+			Vector3 ext1((real)Rand(0.5, 2.5), (real)Rand(0.5, 2.5), (real)Rand(0.5, 2.5));
+			Vector3 ext2((real)Rand(0.5, 2.5), (real)Rand(0.5, 2.5), (real)Rand(0.5, 2.5));
+
+			Vector3 fastAxis1[3], fastAxis2[3], refAxis1[3], refAxis2[3];
+			const Vector3 units[3] = { Vector3::Right, Vector3::Up, Vector3::Forward };
+			for (int k = 0; k < 3; k++){
+				fastAxis1[k] = units[k]; Quaternion::Rotate(fastAxis1[k], axis1, theta1, true);
+				fastAxis2[k] = units[k]; Quaternion::Rotate(fastAxis2[k], axis2, theta2, true);
+
+				// Rodrigues' rotation by double precision
+				const Vector3* axes[2] = { &axis1, &axis2 };
+				const real thetas[2] = { theta1, theta2 };
+				Vector3* outs[2] = { &refAxis1[k], &refAxis2[k] };
+				for (int b = 0; b < 2; b++){
+					const Vector3& n = *axes[b];
+					double cs = cos((double)thetas[b]), sn = sin((double)thetas[b]);
+					const Vector3& u = units[k];
+					double d = (double)n.x*u.x + (double)n.y*u.y + (double)n.z*u.z;
+					double cx = (double)n.y*u.z - (double)n.z*u.y;
+					double cy = (double)n.z*u.x - (double)n.x*u.z;
+					double cz = (double)n.x*u.y - (double)n.y*u.x;
+					outs[b]->Set((real)(u.x*cs + cx*sn + n.x*d*(1 - cs)),
+						(real)(u.y*cs + cy*sn + n.y*d*(1 - cs)),
+						(real)(u.z*cs + cz*sn + n.z*d*(1 - cs)));
+				}
+			}
+
+			bool fastHit = tool::OBox_OBoxIntersection(p1, ext1, fastAxis1, p2, ext2, fastAxis2);
+			bool refHit = tool::OBox_OBoxIntersection(p1, ext1, refAxis1, p2, ext2, refAxis2);
+			if (fastHit != refHit){
+				// allowed only for the boxes just touching. shrink and grow
+				// the boxes slightly, and the reference must change its answer.
+				Vector3 shrink1 = ext1 - 1e-3f, shrink2 = ext2 - 1e-3f;
+				Vector3 grow1 = ext1 + 1e-3f, grow2 = ext2 + 1e-3f;
+				bool inner = tool::OBox_OBoxIntersection(p1, shrink1, refAxis1, p2, shrink2, refAxis2);
+				bool outer = tool::OBox_OBoxIntersection(p1, grow1, refAxis1, p2, grow2, refAxis2);
+				if (inner == outer)
+					mismatches++;
+			}
+		}
+		Check("obox-obox result mismatches", mismatches, 0);
+	}
+}
+
+int main(){
+#ifdef SARKLIB_USING_FASTMATH
+	printf("fast math mode: on\n");
+#else
+	printf("fast math mode: off\n");
+#endif
+	CheckKernels();
+	CheckRotation();
+	CheckAngle();
+	CheckIntersections();
+
+	printf("%d failure(s)\n", gFailures);
+	return (gFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "core.h"
+#include "ConvexHullBuilder.h"
+#include "tools.h"
+
+/**
+correctness check of ConvexHullBuilder.
+
+it builds the hulls of the point sets which are hard for quickhull,
+  1. points on a sphere, which make many sliver faces.
+  2. points on the faces of a box, which are coplanar.
+  3. points on an integer grid, which are coplanar and collinear.
+  4. them far from the origin, where the coordinates are rounded coarsely.
+and checks that
+  - every input point is inside or on every face, by double precision.
+  - the faces make a closed surface. (every edge has one opposite edge)
+  - the hull has no more vertices than SetMaxVertices.
+  - hill climbing finds the support point as far as the linear scan,
+    also in the directions perpendicular to the coplanar faces.
+it returns non-zero when any of them fails.
+*/
+
+using namespace sark;
+
+namespace {
+
+	int gFailures = 0;
+
+	void Check(const char* name, double value, double tolerance){
+		bool ok = (value <= tolerance);
+		printf("%-34s %12.4g (tolerance %.3g) %s\n", name, value, tolerance, ok ? "ok" : "FAILED");
+		if (!ok)
+			gFailures++;
+	}
+
+	// splitmix64 as the benchmark, with fixed seed.
+	uint64 gState = 0x48554c4cULL;
+	double Rand(double lo, double hi){
+		uint64 z = (gState += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		z = z ^ (z >> 31);
+		return lo + (hi - lo) * ((z >> 11) * (1.0 / 9007199254740992.0));
+	}
+
+	const Vector3 RandDirection(){
+		double x, y, z, m;
+		do{
+			x = Rand(-1, 1); y = Rand(-1, 1); z = Rand(-1, 1);
+			m = x*x + y*y + z*z;
+		} while (m < 0.01 || m > 1.0);
+		m = sqrt(m);
+		return Vector3((real)(x / m), (real)(y / m), (real)(z / m));
+	}
+
+	enum Shape { SPHERE, BOX, GRID };
+
+	void MakePoints(Shape shape, uinteger count, const Vector3& offset, std::vector<Vector3>& out_points){
+		out_points.resize(count);
+		for (uinteger i = 0; i < count; i++){
+			Vector3 p;
+			switch (shape){
+			case SPHERE:
+				p = RandDirection();
+				break;
+			case BOX:
+				p.Set((real)Rand(-1, 1), (real)Rand(-1, 1), (real)Rand(-1, 1));
+				p.v[i % 3] = (Rand(0, 1) < 0.5 ? -1.f : 1.f);
+				break;
+			case GRID:
+				p.Set((real)floor(Rand(-4, 5)), (real)floor(Rand(-4, 5)), (real)floor(Rand(-4, 5)));
+				break;
+			}
+			out_points[i] = p + offset;
+		}
+	}
+
+	// the largest distance of the points above the faces, relative to
+	// the tolerance of the builder. (see ConvexHullBuilder::Build)
+	double MaxOutside(const std::vector<Vector3>& points, const ConvexHullBuilder& builder){
+		double extent = 0.0, maxAbs = 0.0;
+		for (int a = 0; a < 3; a++){
+			double lo = points[0].v[a], hi = points[0].v[a];
+			for (const auto& p : points){
+				lo = std::min(lo, (double)p.v[a]);
+				hi = std::max(hi, (double)p.v[a]);
+			}
+			extent += hi - lo;
+			maxAbs += std::max(fabs(lo), fabs(hi));
+		}
+		const double eps = 3.0 * std::max(extent, maxAbs) * math::EPSILON;
+
+		const ConvexHullBuilder::PointSet& P = builder.GetPointSet();
+		double maxd = 0.0;
+		for (const auto& f : builder.GetFaceSet()){
+			const Vector3& a = P[f.idx[0]];
+			const Vector3& b = P[f.idx[1]];
+			const Vector3& c = P[f.idx[2]];
+			double u[3], w[3];
+			for (int k = 0; k < 3; k++){
+				u[k] = (double)b.v[k] - a.v[k];
+				w[k] = (double)c.v[k] - a.v[k];
+			}
+			double n[3] = { u[1] * w[2] - u[2] * w[1], u[2] * w[0] - u[0] * w[2], u[0] * w[1] - u[1] * w[0] };
+			double mag = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (mag == 0.0)
+				return 1e30;
+			for (const auto& p : points){
+				double d = (n[0] * ((double)p.x - a.x) + n[1] * ((double)p.y - a.y) + n[2] * ((double)p.z - a.z)) / mag;
+				maxd = std::max(maxd, d);
+			}
+		}
+		return maxd / eps;
+	}
+
+	// the number of edges which have no opposite edge or more than one.
+	int OpenEdges(const ConvexHullBuilder& builder){
+		std::map<std::pair<uint16, uint16>, int> edges;
+		for (const auto& f : builder.GetFaceSet()){
+			for (int k = 0; k < 3; k++)
+				edges[std::make_pair(f.idx[k], f.idx[(k + 1) % 3])]++;
+		}
+		int open = 0;
+		for (const auto& e : edges){
+			auto opposite = edges.find(std::make_pair(e.first.second, e.first.first));
+			if (e.second != 1 || opposite == edges.end() || opposite->second != 1)
+				open++;
+		}
+		return open;
+	}
+
+	// the largest shortfall of hill climbing from the linear scan.
+	// the directions near the axes and the diagonals hit the flat faces
+	// of the box and the grid, which are split into the triangles.
+	double SupportShortfall(const ConvexHullBuilder& builder){
+		const ConvexHullBuilder::PointSet& P = builder.GetPointSet();
+		std::vector<uinteger> offsets;
+		std::vector<uint16> adjacency;
+		tool::BuildVertexAdjacency(builder.GetFaceSet(), P.size(), offsets, adjacency);
+
+		double shortfall = 0.0;
+		uinteger last = builder.GetFaceSet()[0].a;
+		for (int i = 0; i < 200; i++){
+			Vector3 d;
+			if (i < 104){
+				int c = i / 4;
+				c = (c < 13 ? c : c + 1);
+				d.Set((real)(c % 3 - 1), (real)(c / 3 % 3 - 1), (real)(c / 9 - 1));
+				if (i % 4 != 0)
+					d += Vector3((real)Rand(-1e-5, 1e-5), (real)Rand(-1e-5, 1e-5), (real)Rand(-1e-5, 1e-5));
+			}
+			else {
+				d = RandDirection();
+			}
+			uinteger best = tool::FarthestPointIndex(&P[0], P.size(), d);
+			last = tool::HillClimbFarthestPoint(&P[0], P.size(), &offsets[0], &adjacency[0], d, last);
+			shortfall = std::max(shortfall, (double)d.Dot(P[best]) - d.Dot(P[last]));
+			// restart from a vertex which is far from the result.
+			if (i % 7 == 0)
+				last = tool::FarthestPointIndex(&P[0], P.size(), -d);
+		}
+		return shortfall;
+	}
+
+	void CheckShape(const char* name, Shape shape, uinteger count, uinteger runs){
+		const Vector3 offsets[2] = { Vector3(0.f, 0.f, 0.f), Vector3(100.f, -50.f, 100.f) };
+		double outside = 0.0, shortfall = 0.0;
+		int open = 0, failed = 0;
+		for (uinteger run = 0; run < runs; run++){
+			std::vector<Vector3> points;
+			MakePoints(shape, count, offsets[run % 2], points);
+
+			// welding moves the points, so it is checked without it.
+			ConvexHullBuilder builder;
+			builder.SetWeldDistance(0);
+			if (!builder.Build(points)){
+				failed++;
+				continue;
+			}
+			outside = std::max(outside, MaxOutside(points, builder));
+			open += OpenEdges(builder);
+			shortfall = std::max(shortfall, SupportShortfall(builder));
+		}
+
+		char label[64];
+		sprintf(label, "%s build failures", name);
+		Check(label, failed, 0);
+		sprintf(label, "%s outside / tolerance", name);
+		Check(label, outside, 2.0);
+		sprintf(label, "%s open edges", name);
+		Check(label, open, 0);
+		sprintf(label, "%s support shortfall", name);
+		Check(label, shortfall, 0);
+	}
+
+	void CheckMaxVertices(){
+		std::vector<Vector3> points;
+		MakePoints(SPHERE, 2000, Vector3(0.f, 0.f, 0.f), points);
+		ConvexHullBuilder builder;
+		builder.SetMaxVertices(64);
+		bool built = builder.Build(points);
+		Check("reduced hull build failures", built ? 0 : 1, 0);
+		Check("reduced hull vertices", (double)builder.GetPointSet().size(), 64);
+		Check("reduced hull open edges", OpenEdges(builder), 0);
+	}
+}
+
+int main(){
+	CheckShape("sphere", SPHERE, 2000, 60);
+	CheckShape("box", BOX, 2000, 20);
+	CheckShape("grid", GRID, 2000, 20);
+	CheckMaxVertices();
+
+	printf("%d failure(s)\n", gFailures);
+	return (gFailures == 0 ? 0 : 1);
+}
@@ -0,0 +1,1188 @@
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "core.h"
+#include "tools.h"
+#include "fastmath.hpp"
+#include "ConvexHullBuilder.h"
+#include "SweepAndPrune.h"
+#include "DynamicAABBTree.h"
+#include "ThreadPool.h"
+#include "ASceneComponent.h"
+#include "ConvexHull.h"
+#include "SphereCollider.h"
+#include "OBoxCollider.h"
+#include "ContactManifold.h"
+#include "GJK_EPA.h"
+#include "CollisionGeometry.h"
+
+/**
+headless micro benchmark of core.cpp and tools.cpp.
+
+every case runs on a fixed input set generated by the fixed seed,
+so two runs of different builds are comparable case by case.
+the result is printed as JSON to stdout (or the file given by --out).
+
+usage: sark_math_bench [--filter <substring>] [--min-time <ms>]
+                       [--samples <count>] [--seed <value>] [--out <file>]
+*/
+
+using namespace sark;
+
+namespace {
+
+	//=============================================
+	//		benchmark options and helpers
+	//=============================================
+
+	struct Options{
+		std::string filter;
+		std::string outPath;
+		double minTimeMs = 20.0;
+		int samples = 5;
+		uint64 seed = 0x5a4b4c4942ULL;
+	};
+
+	struct Result{
+		std::string name;
+		uint64 ops;
+		double nsPerOp;		// the best sample
+		double nsPerOpMedian;
+	};
+
+	// splitmix64. it is tiny and gives the same sequence on every platform,
+	// unlike the distributions of <random>.
+	class Random{
+	private:
+		uint64 state;
+
+	public:
+		explicit Random(uint64 seed) : state(seed){}
+
+		uint64 Next(){
+			uint64 z = (state += 0x9e3779b97f4a7c15ULL);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
+		}
+
+		// uniform real number in [lo, hi)
+		real Range(real lo, real hi){
+			return lo + (hi - lo) * (real)((Next() >> 11) * (1.0 / 9007199254740992.0));
+		}
+
+		const Vector3 InCube(real half){
+			real x = Range(-half, half);
+			real y = Range(-half, half);
+			real z = Range(-half, half);
+			return Vector3(x, y, z);
+		}
+
+		const Vector3 Direction(){
+			Vector3 v;
+			do{
+				v = InCube(1.f);
+			} while (v.MagnitudeSq() < 0.01f || v.MagnitudeSq() > 1.f);
+			return v.Normal();
+		}
+
+		Quaternion Rotation(){
+			Vector3 axis = Direction();
+			return Quaternion(axis, Range(-math::PI, math::PI), true);
+		}
+
+		// random rigid transform
+		const Matrix4 Rigid(real translation){
+			Matrix4 M = Rotation().ToMatrix4(true);
+			Vector3 t = InCube(translation);
+			M.m[0][3] = t.x; M.m[1][3] = t.y; M.m[2][3] = t.z;
+			return M;
+		}
+	};
+
+	// results of every case are folded into this, so that
+	// the compiler can not drop the measured code.
+	volatile real gSink = 0.f;
+
+	inline void Consume(real v){ gSink = gSink + v; }
+	inline void Consume(bool b){ gSink = gSink + (b ? 1.f : 0.f); }
+	inline void Consume(const Vector3& v){ Consume(v.x + v.y + v.z); }
+	inline void Consume(const Vector4& v){ Consume(v.x + v.y + v.z + v.w); }
+	inline void Consume(const Quaternion& q){ Consume(q.x + q.y + q.z + q.s); }
+	inline void Consume(const Matrix4& M){ Consume(M.m[0][0] + M.m[1][1] + M.m[2][2] + M.m[3][3] + M.m[0][3]); }
+
+
+	// input sets. the sizes are power of 2 to wrap indices with a mask.
+	const uinteger SET_SIZE = 1024;
+	const uinteger SET_MASK = SET_SIZE - 1;
+
+	class Runner{
+	private:
+		Options mOpt;
+		std::vector<Result> mResults;
+
+	public:
+		explicit Runner(const Options& opt) : mOpt(opt){}
+
+		const std::vector<Result>& GetResults() const{ return mResults; }
+
+		// run 'body(i)' with i = 0, 1, 2, ... until min time elapses.
+		// each call of body is counted as one operation.
+		template<class _Body>
+		void Run(const char* name, _Body body){
+			if (!mOpt.filter.empty() && strstr(name, mOpt.filter.c_str()) == NULL)
+				return;
+
+			typedef std::chrono::steady_clock Clock;
+
+			// calibrate the batch size, to make a sample takes about min time.
+			uint64 batch = 64;
+			for (;;){
+				Clock::time_point t0 = Clock::now();
+				for (uint64 i = 0; i < batch; i++)
+					body((uinteger)i & SET_MASK);
+				double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+				if (ms >= mOpt.minTimeMs || batch >= (1ULL << 40))
+					break;
+				batch *= (ms < mOpt.minTimeMs / 16.0 ? 8 : 2);
+			}
+
+			std::vector<double> samples;
+			for (int s = 0; s < mOpt.samples; s++){
+				Clock::time_point t0 = Clock::now();
+				for (uint64 i = 0; i < batch; i++)
+					body((uinteger)i & SET_MASK);
+				double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+				samples.push_back(ns / (double)batch);
+			}
+			std::sort(samples.begin(), samples.end());
+
+			Result r;
+			r.name = name;
+			r.ops = batch;
+			r.nsPerOp = samples.front();
+			r.nsPerOpMedian = samples[samples.size() / 2];
+			mResults.push_back(r);
+
+			fprintf(stderr, "%-40s %10.2f ns/op\n", name, r.nsPerOp);
+		}
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& opt){
+		for (int i = 1; i < argc; i++){
+			bool hasValue = (i + 1 < argc);
+			if (strcmp(argv[i], "--filter") == 0 && hasValue)
+				opt.filter = argv[++i];
+			else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+				opt.minTimeMs = atof(argv[++i]);
+			else if (strcmp(argv[i], "--samples") == 0 && hasValue)
+				opt.samples = std::max(1, atoi(argv[++i]));
+			else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+				opt.seed = strtoull(argv[++i], NULL, 0);
+			else if (strcmp(argv[i], "--out") == 0 && hasValue)
+				opt.outPath = argv[++i];
+			else{
+				fprintf(stderr, "unknown option: %s\n", argv[i]);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void WriteJSON(FILE* fp, const Options& opt, const std::vector<Result>& results){
+		fprintf(fp, "{\n");
+		fprintf(fp, "  \"suite\": \"sarklib-math\",\n");
+		fprintf(fp, "  \"seed\": %llu,\n", (unsigned long long)opt.seed);
+		fprintf(fp, "  \"config\": {\n");
+#ifdef SARKLIB_USING_SIMD
+		fprintf(fp, "    \"simd\": true,\n");
+#else
+		fprintf(fp, "    \"simd\": false,\n");
+#endif
+#ifdef SARKLIB_USING_FASTMATH
+		fprintf(fp, "    \"fastmath\": true,\n");
+#else
+		fprintf(fp, "    \"fastmath\": false,\n");
+#endif
+		fprintf(fp, "    \"real_size\": %u,\n", (unsigned)sizeof(real));
+		fprintf(fp, "    \"min_time_ms\": %.3f,\n", opt.minTimeMs);
+		fprintf(fp, "    \"samples\": %d\n", opt.samples);
+		fprintf(fp, "  },\n");
+		fprintf(fp, "  \"results\": [\n");
+		for (size_t i = 0; i < results.size(); i++){
+			const Result& r = results[i];
+			fprintf(fp, "    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.3f, "
+				"\"ns_per_op_median\": %.3f, \"ops_per_sec\": %.1f}%s\n",
+				r.name.c_str(), (unsigned long long)r.ops, r.nsPerOp, r.nsPerOpMedian,
+				1e9 / r.nsPerOp, (i + 1 < results.size() ? "," : ""));
+		}
+		fprintf(fp, "  ],\n");
+		fprintf(fp, "  \"checksum\": %.6g\n", (double)gSink);
+		fprintf(fp, "}\n");
+	}
+
+
+	//=============================================
+	//		benchmark cases
+	//=============================================
+
+	// functions of math::fast. they are the exact ones of math.h
+	// unless SARKLIB_USING_FASTMATH is defined.
+	void BenchScalar(Runner& run, Random& rnd){
+		std::vector<real> a(SET_SIZE), b(SET_SIZE), c(SET_SIZE);
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			a[i] = rnd.Range(0.01f, 100.f);
+			b[i] = rnd.Range(-10.f, 10.f);
+			c[i] = rnd.Range(-1.f, 1.f);
+		}
+
+		run.Run("math.rsqrt", [&](uinteger i){ Consume(math::fast::rsqrt(a[i])); });
+		run.Run("math.sin", [&](uinteger i){ Consume(math::fast::sin(b[i])); });
+		run.Run("math.cos", [&](uinteger i){ Consume(math::fast::cos(b[i])); });
+		run.Run("math.acos", [&](uinteger i){ Consume(math::fast::acos(c[i])); });
+		run.Run("math.atan2", [&](uinteger i){ Consume(math::fast::atan2(b[i], c[i])); });
+	}
+
+	void BenchVector3(Runner& run, Random& rnd){
+		std::vector<Vector3> a(SET_SIZE), b(SET_SIZE);
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			a[i] = rnd.InCube(10.f);
+			b[i] = rnd.InCube(10.f);
+		}
+		Matrix3 invI(0.3f, 0.01f, 0.f, 0.01f, 0.2f, 0.f, 0.f, 0.f, 0.25f);
+
+		run.Run("vector3.add", [&](uinteger i){ Consume(a[i] + b[i]); });
+		run.Run("vector3.dot", [&](uinteger i){ Consume(a[i].Dot(b[i])); });
+		run.Run("vector3.cross", [&](uinteger i){ Consume(a[i].Cross(b[i])); });
+		run.Run("vector3.normal", [&](uinteger i){ Consume(a[i].Normal()); });
+		run.Run("vector3.magnitude", [&](uinteger i){ Consume(a[i].Magnitude()); });
+
+		// the face normal of EPA, and the denominator of contact impulse.
+		run.Run("kernel.face_normal", [&](uinteger i){
+			Consume((b[i] - a[i]).Cross(b[(i + 1) & SET_MASK] - a[i]).Normal());
+		});
+		run.Run("kernel.impulse_denominator", [&](uinteger i){
+			const Vector3& r = a[i];
+			Vector3 CN = b[i].Normal();
+			Consume(CN.Dot((invI * r.Cross(CN)).Cross(r)));
+		});
+	}
+
+	void BenchVector4(Runner& run, Random& rnd){
+		std::vector<Vector4> a(SET_SIZE), b(SET_SIZE);
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			a[i] = Vector4(rnd.InCube(10.f), rnd.Range(-10.f, 10.f));
+			b[i] = Vector4(rnd.InCube(10.f), rnd.Range(-10.f, 10.f));
+		}
+
+		run.Run("vector4.add", [&](uinteger i){ Consume(a[i] + b[i]); });
+		run.Run("vector4.dot", [&](uinteger i){ Consume(a[i].Dot(b[i])); });
+		run.Run("vector4.normal", [&](uinteger i){ Consume(a[i].Normal()); });
+	}
+
+	void BenchMatrix4(Runner& run, Random& rnd){
+		std::vector<Matrix4> A(SET_SIZE), B(SET_SIZE);
+		std::vector<Vector4> v(SET_SIZE);
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			A[i] = rnd.Rigid(50.f);
+			B[i] = rnd.Rigid(50.f);
+			v[i] = Vector4(rnd.InCube(10.f), 1.f);
+		}
+
+		run.Run("matrix4.mul", [&](uinteger i){ Consume(A[i] * B[i]); });
+		run.Run("matrix4.affine_mul", [&](uinteger i){ Consume(A[i].AffineMul(B[i])); });
+		run.Run("matrix4.mul_vector4", [&](uinteger i){ Consume(A[i] * v[i]); });
+		run.Run("matrix4.transposition", [&](uinteger i){ Consume(A[i].Transposition()); });
+		run.Run("matrix4.inverse", [&](uinteger i){ Consume(A[i].Inverse()); });
+		run.Run("matrix4.affine_inverse", [&](uinteger i){ Consume(A[i].AffineInverse()); });
+		run.Run("matrix4.rigid_inverse", [&](uinteger i){ Consume(A[i].RigidInverse()); });
+	}
+
+	void BenchQuaternion(Runner& run, Random& rnd){
+		std::vector<Quaternion> p(SET_SIZE), q(SET_SIZE);
+		std::vector<real> t(SET_SIZE);
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			p[i] = rnd.Rotation();
+			q[i] = rnd.Rotation();
+			// take the shorter arc, as the animation code does.
+			if (p[i].Dot(q[i]) < 0.f)
+				q[i] = -1.f * q[i];
+			t[i] = rnd.Range(0.f, 1.f);
+		}
+
+		run.Run("quaternion.mul", [&](uinteger i){ Consume(p[i] * q[i]); });
+		run.Run("quaternion.normal", [&](uinteger i){ Consume(p[i].Normal()); });
+		run.Run("quaternion.to_matrix4", [&](uinteger i){ Consume(p[i].ToMatrix4(true)); });
+		run.Run("quaternion.slerp", [&](uinteger i){ Consume(Quaternion::Slerp(p[i], q[i], t[i])); });
+	}
+
+	void BenchTransform(Runner& run, Random& rnd){
+		const uinteger count = 256;
+		std::vector<Position3> in(count), out(count);
+		for (uinteger i = 0; i < count; i++)
+			in[i] = rnd.InCube(5.f);
+		Matrix4 M = rnd.Rigid(20.f);
+
+		// one operation is a whole point set here.
+		run.Run("tool.transform_points_256", [&](uinteger){
+			tool::TransformPoints(M, &in[0], count, &out[0]);
+			Consume(out[count - 1]);
+		});
+	}
+
+	// convex polyhedron for support search. the box for 8 points,
+	// and uv spheres of (rings - 1) * segments + 2 points for the others.
+	struct Hull{
+		std::vector<Vector3> points;
+		std::vector<TriangleFace16> faces;
+		std::vector<uinteger> offsets;
+		std::vector<uint16> adjacency;
+	};
+
+	void MakeBoxHull(Hull& hull){
+		for (uinteger i = 0; i < 8; i++)
+			hull.points.push_back(Vector3((i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : -1.f));
+		const uint16 quads[6][4] = {
+			{ 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 },
+			{ 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 }
+		};
+		for (uinteger i = 0; i < 6; i++){
+			hull.faces.push_back(TriangleFace16(quads[i][0], quads[i][1], quads[i][2]));
+			hull.faces.push_back(TriangleFace16(quads[i][0], quads[i][2], quads[i][3]));
+		}
+	}
+
+	void MakeSphereHull(Hull& hull, uinteger rings, uinteger segments){
+		hull.points.push_back(Vector3(0.f, 1.f, 0.f));
+		for (uinteger r = 1; r < rings; r++){
+			real phi = math::PI * r / rings;
+			for (uinteger s = 0; s < segments; s++){
+				real theta = 2.f * math::PI * s / segments;
+				hull.points.push_back(Vector3(
+					math::sin(phi) * math::cos(theta), math::cos(phi), math::sin(phi) * math::sin(theta)));
+			}
+		}
+		hull.points.push_back(Vector3(0.f, -1.f, 0.f));
+
+		uint16 bottom = (uint16)(hull.points.size() - 1);
+		for (uinteger s = 0; s < segments; s++){
+			uint16 s1 = (uint16)((s + 1) % segments);
+			hull.faces.push_back(TriangleFace16(0, (uint16)(1 + s1), (uint16)(1 + s)));
+			for (uinteger r = 1; r + 1 < rings; r++){
+				uint16 a = (uint16)(1 + (r - 1) * segments + s), b = (uint16)(1 + (r - 1) * segments + s1);
+				uint16 c = (uint16)(a + segments), d = (uint16)(b + segments);
+				hull.faces.push_back(TriangleFace16(a, b, d));
+				hull.faces.push_back(TriangleFace16(a, d, c));
+			}
+			uint16 base = (uint16)(1 + (rings - 2) * segments);
+			hull.faces.push_back(TriangleFace16(bottom, (uint16)(base + s), (uint16)(base + s1)));
+		}
+	}
+
+	// support search on the hulls of 8, 100 and 1002 points.
+	// the directions change gradually, as GJK and EPA of a pair do, and
+	// the hill climbing starts from the last result.
+	void BenchSupport(Runner& run, Random& rnd){
+		std::vector<Vector3> dirs(SET_SIZE);
+		dirs[0] = rnd.Direction();
+		for (uinteger i = 1; i < SET_SIZE; i++)
+			dirs[i] = (dirs[i - 1] + 0.3f * rnd.Direction()).Normal();
+
+		Hull hulls[3];
+		MakeBoxHull(hulls[0]);
+		MakeSphereHull(hulls[1], 8, 14);
+		MakeSphereHull(hulls[2], 21, 50);
+
+		for (uinteger h = 0; h < 3; h++){
+			Hull& hull = hulls[h];
+			tool::BuildVertexAdjacency(hull.faces, hull.points.size(), hull.offsets, hull.adjacency);
+
+			char name[64];
+			sprintf(name, "support.scan_%u", (unsigned)hull.points.size());
+			run.Run(name, [&](uinteger i){
+				Consume(hull.points[tool::FarthestPointIndex(&hull.points[0], hull.points.size(), dirs[i])]);
+			});
+
+			uinteger last = 0;
+			sprintf(name, "support.hillclimb_%u", (unsigned)hull.points.size());
+			run.Run(name, [&](uinteger i){
+				last = tool::HillClimbFarthestPoint(&hull.points[0], hull.points.size(), &hull.offsets[0], &hull.adjacency[0], dirs[i], last);
+				Consume(hull.points[last]);
+			});
+		}
+	}
+
+	// convex hull building of 4096 points around a sphere.
+	// the hull has about one third of them, so most of the time is
+	// in the face updates, not in the point classification.
+	void BenchHullBuild(Runner& run, Random& rnd){
+		std::vector<Vector3> points(4096);
+		for (uinteger i = 0; i < points.size(); i++)
+			points[i] = rnd.Direction() * rnd.Range(0.95f, 1.f);
+
+		ConvexHullBuilder builder;
+		run.Run("hull.build_4096", [&](uinteger){
+			builder.Build(points);
+			Consume(builder.GetPointSet()[0]);
+		});
+		builder.SetMaxVertices(64);
+		run.Run("hull.build_4096_max64", [&](uinteger){
+			builder.Build(points);
+			Consume(builder.GetPointSet()[0]);
+		});
+	}
+
+	// moving boxes for broad-phase. the volume grows with the count,
+	// so that each box overlaps with about two others at any count.
+	struct BoxScene{
+		std::vector<Vector3> pos, vel, ext;
+		real half;
+
+		BoxScene(Random& rnd, uinteger count)
+			: pos(count), vel(count), ext(count)
+		{
+			half = 2.f * math::pow((real)count, 1.f / 3.f);
+			for (uinteger i = 0; i < count; i++){
+				pos[i] = rnd.InCube(half);
+				vel[i] = rnd.Direction() * 0.02f;
+				ext[i] = Vector3(rnd.Range(0.5f, 1.f), rnd.Range(0.5f, 1.f), rnd.Range(0.5f, 1.f));
+			}
+		}
+
+		// move one frame. the boxes bounce on the walls of the volume.
+		void Step(){
+			for (uinteger i = 0; i < pos.size(); i++){
+				pos[i] += vel[i];
+				for (uinteger a = 0; a < 3; a++){
+					if (math::abs(pos[i].v[a]) > half)
+						vel[i].v[a] = -vel[i].v[a];
+				}
+			}
+		}
+	};
+
+	// a frame of broad-phase: moving all the boxes and finding the pairs.
+	// the brute force is the full pair loop of the bounding boxes.
+	void BenchBroadphase(Runner& run, Random& rnd){
+		const uinteger counts[3] = { 100, 1000, 10000 };
+		for (uinteger c = 0; c < 3; c++){
+			BoxScene scene(rnd, counts[c]);
+			char name[64];
+
+			SweepAndPrune sap;
+			std::vector<SweepAndPrune::ProxyID> proxies(counts[c]);
+			for (uinteger i = 0; i < counts[c]; i++)
+				proxies[i] = sap.AddProxy(scene.pos[i] - scene.ext[i], scene.pos[i] + scene.ext[i], i);
+			sap.FindPairs();
+
+			sprintf(name, "broadphase.sap_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger){
+				scene.Step();
+				for (uinteger i = 0; i < counts[c]; i++)
+					sap.UpdateProxy(proxies[i], scene.pos[i] - scene.ext[i], scene.pos[i] + scene.ext[i]);
+				Consume((real)sap.FindPairs().size());
+			});
+
+			DynamicAABBTree tree;
+			for (uinteger i = 0; i < counts[c]; i++)
+				proxies[i] = tree.AddProxy(scene.pos[i] - scene.ext[i], scene.pos[i] + scene.ext[i], i);
+			tree.FindPairs();
+
+			sprintf(name, "broadphase.tree_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger){
+				scene.Step();
+				for (uinteger i = 0; i < counts[c]; i++)
+					tree.UpdateProxy(proxies[i], scene.pos[i] - scene.ext[i], scene.pos[i] + scene.ext[i]);
+				Consume((real)tree.FindPairs().size());
+			});
+
+			if (counts[c] > 1000)
+				continue;
+			std::vector<Vector3> mins(counts[c]), maxs(counts[c]);
+			sprintf(name, "broadphase.brute_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger){
+				scene.Step();
+				for (uinteger i = 0; i < counts[c]; i++){
+					mins[i] = scene.pos[i] - scene.ext[i];
+					maxs[i] = scene.pos[i] + scene.ext[i];
+				}
+				uinteger pairs = 0;
+				for (uinteger i = 0; i < counts[c]; i++){
+					for (uinteger j = i + 1; j < counts[c]; j++){
+						if (tool::AABox_AABoxIntersection(mins[i], maxs[i], mins[j], maxs[j]))
+							pairs++;
+					}
+				}
+				Consume((real)pairs);
+			});
+		}
+	}
+
+	// nearest hit of a ray among the boxes, like picking of a scene.
+	// the tree clips the ray by the nearest hit, and the brute force
+	// tests all the boxes.
+	void BenchRaycast(Runner& run, Random& rnd){
+		const uinteger counts[2] = { 1000, 10000 };
+		for (uinteger c = 0; c < 2; c++){
+			BoxScene scene(rnd, counts[c]);
+			std::vector<Vector3> mins(counts[c]), maxs(counts[c]);
+			DynamicAABBTree tree;
+			for (uinteger i = 0; i < counts[c]; i++){
+				mins[i] = scene.pos[i] - scene.ext[i];
+				maxs[i] = scene.pos[i] + scene.ext[i];
+				tree.AddProxy(mins[i], maxs[i], i);
+			}
+
+			const uinteger N = 256;
+			std::vector<Vector3> origins(N), dirs(N);
+			for (uinteger i = 0; i < N; i++){
+				origins[i] = rnd.InCube(scene.half);
+				dirs[i] = rnd.Direction();
+			}
+			const real limit = scene.half * 4.f;
+			char name[64];
+
+			sprintf(name, "raycast.tree_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger i){
+				const Vector3& p = origins[i % N];
+				const Vector3& d = dirs[i % N];
+				real nearest = limit;
+				tree.RayCast(p, d, limit, [&](DynamicAABBTree::ProxyID id, real l)->real{
+					const uinteger k = tree.GetUserData(id);
+					Vector3 P;
+					if (!tool::Ray_AABoxIntersection(p, d, l, mins[k], maxs[k], &P))
+						return l;
+					const real t = (P - p).Dot(d);
+					if (t < nearest)
+						nearest = t;
+					return nearest;
+				});
+				Consume(nearest);
+			});
+
+			sprintf(name, "raycast.brute_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger i){
+				const Vector3& p = origins[i % N];
+				const Vector3& d = dirs[i % N];
+				real nearest = limit;
+				for (uinteger k = 0; k < counts[c]; k++){
+					Vector3 P;
+					if (tool::Ray_AABoxIntersection(p, d, nearest, mins[k], maxs[k], &P)){
+						const real t = (P - p).Dot(d);
+						if (t < nearest)
+							nearest = t;
+					}
+				}
+				Consume(nearest);
+			});
+
+			// coherent packets, like the neighbouring pixels of a camera.
+			const uinteger PACKET_SIZE = DynamicAABBTree::PACKET_SIZE;
+			std::vector<Vector3> packetDirs(N * PACKET_SIZE);
+			for (uinteger i = 0; i < N; i++){
+				for (uinteger k = 0; k < PACKET_SIZE; k++)
+					packetDirs[i * PACKET_SIZE + k] = (dirs[i] + rnd.InCube(0.01f)).Normal();
+			}
+
+			sprintf(name, "raycast.tree_x4_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger i){
+				const Vector3& p = origins[i % N];
+				for (uinteger k = 0; k < PACKET_SIZE; k++){
+					const Vector3& d = packetDirs[(i % N) * PACKET_SIZE + k];
+					real nearest = limit;
+					tree.RayCast(p, d, limit, [&](DynamicAABBTree::ProxyID id, real l)->real{
+						const uinteger b = tree.GetUserData(id);
+						Vector3 P;
+						if (tool::Ray_AABoxIntersection(p, d, l, mins[b], maxs[b], &P))
+							nearest = std::min(nearest, (P - p).Dot(d));
+						return nearest;
+					});
+					Consume(nearest);
+				}
+			});
+
+			sprintf(name, "raycast.packet_x4_%u", (unsigned)counts[c]);
+			run.Run(name, [&](uinteger i){
+				Vector3 pos[PACKET_SIZE];
+				real limits[PACKET_SIZE];
+				const Vector3* d = &packetDirs[(i % N) * PACKET_SIZE];
+				for (uinteger k = 0; k < PACKET_SIZE; k++){
+					pos[k] = origins[i % N];
+					limits[k] = limit;
+				}
+				tree.RayCastPacket(pos, d, limits,
+					[&](DynamicAABBTree::ProxyID id, uinteger mask, real* l){
+					const uinteger b = tree.GetUserData(id);
+					for (uinteger k = 0; k < PACKET_SIZE; k++){
+						Vector3 P;
+						if ((mask & (1 << k)) != 0
+							&& tool::Ray_AABoxIntersection(pos[k], d[k], l[k], mins[b], maxs[b], &P))
+							l[k] = std::min(l[k], (P - pos[k]).Dot(d[k]));
+					}
+				});
+				for (uinteger k = 0; k < PACKET_SIZE; k++)
+					Consume(limits[k]);
+			});
+		}
+	}
+
+	// scene component which only has a convex hull.
+	class HullComponent : public ASceneComponent{
+		ConvexHull* mHull;
+	public:
+		HullComponent(const ConvexHullBuilder& builder)
+			: ASceneComponent("hull", NULL, true)
+		{
+			mHull = new ConvexHull(this, builder.GetPointSet(), builder.GetFaceSet());
+		}
+		~HullComponent(){ delete mHull; }
+		void Update() override{ mHull->Update(); }
+		void Render() override{}
+		ACollider* GetCollider() override{ return mHull; }
+		Mesh* GetMesh() override{ return NULL; }
+		const CollisionGeometry* GetCollisionGeometry() override{ return NULL; }
+		RigidBody* GetRigidBody() override{ return NULL; }
+	};
+
+	// narrow-phase of the convex pairs on the thread pool, as
+	// Collision::ProcessConvexCollision does: GJK and EPA on the workers,
+	// the results into per-worker buffers, then merged and sorted.
+	// each case runs all the pairs of a pile of hulls.
+	void BenchNarrowphase(Runner& run, Random& rnd){
+		std::vector<Vector3> points(64);
+		for (uinteger i = 0; i < points.size(); i++)
+			points[i] = rnd.Direction();
+		ConvexHullBuilder builder;
+		builder.Build(points);
+
+		const uinteger count = 128;
+		std::vector<HullComponent*> comps;
+		for (uinteger i = 0; i < count; i++){
+			HullComponent* comp = new HullComponent(builder);
+			comp->GetTransform().Translate(rnd.InCube(4.f));
+			comp->GetTransform().Rotate(rnd.Rotation());
+			comp->Update();
+			comps.push_back(comp);
+		}
+
+		// pairs whose bounding boxes overlap.
+		std::vector<std::pair<uinteger, uinteger>> pairs;
+		for (uinteger i = 0; i < count; i++){
+			Vector3 min1, max1, min2, max2;
+			comps[i]->GetCollider()->GetBounds(min1, max1);
+			for (uinteger j = i + 1; j < count; j++){
+				comps[j]->GetCollider()->GetBounds(min2, max2);
+				if (tool::AABox_AABoxIntersection(min1, max1, min2, max2))
+					pairs.push_back(std::make_pair(i, j));
+			}
+		}
+
+		struct Contact{
+			uinteger a, b;
+		};
+		const uinteger threads[5] = { 1, 2, 4, 8, 16 };
+		for (uinteger t = 0; t < 5; t++){
+			ThreadPool pool(threads[t]);
+			std::vector<std::vector<Contact>> buffers(threads[t]);
+			std::vector<Contact> contacts;
+			char name[64];
+			sprintf(name, "narrowphase.convex_%u_t%u", (unsigned)pairs.size(), (unsigned)threads[t]);
+			run.Run(name, [&](uinteger){
+				for (auto& buffer : buffers)
+					buffer.clear();
+				pool.ParallelFor(pairs.size(), 4, [&](uinteger begin, uinteger end, uinteger worker){
+					for (uinteger i = begin; i < end; i++){
+						const ConvexHull* A = (const ConvexHull*)comps[pairs[i].first]->GetCollider();
+						const ConvexHull* B = (const ConvexHull*)comps[pairs[i].second]->GetCollider();
+						GJK_EPA::Simplex simplex;
+						Vector3 normal;
+						real depth;
+						if (GJK_EPA::DoGJK(A, B, &simplex) && GJK_EPA::DoEPA(A, B, simplex, &normal, &depth)){
+							Contact contact = { pairs[i].first, pairs[i].second };
+							buffers[worker].push_back(contact);
+						}
+					}
+				});
+				contacts.clear();
+				for (auto& buffer : buffers)
+					contacts.insert(contacts.end(), buffer.begin(), buffer.end());
+				std::sort(contacts.begin(), contacts.end(), [](const Contact& l, const Contact& r){
+					return (l.a < r.a || (l.a == r.a && l.b < r.b));
+				});
+				Consume((real)contacts.size());
+			});
+		}
+
+		// a frame of GJK on the moving pile, without and with the cache
+		// of each pair. (see GJK_EPA::SupportHint)
+		std::vector<Vector3> vel(count);
+		for (uinteger i = 0; i < count; i++)
+			vel[i] = rnd.Direction() * 0.01f;
+		auto step = [&](uinteger frame){
+			const real sign = ((frame >> 6) & 1 ? -1.f : 1.f);
+			for (uinteger i = 0; i < count; i++){
+				comps[i]->GetTransform().TranslateMore(vel[i] * sign);
+				comps[i]->GetTransform().RotateMore(Vector3::Up, 0.01f);
+				comps[i]->Update();
+			}
+		};
+		std::vector<GJK_EPA::SupportHint> hints(pairs.size());
+		for (uinteger warm = 0; warm < 2; warm++){
+			char name[64];
+			sprintf(name, "narrowphase.gjk_%s_%u", (warm ? "warm" : "cold"), (unsigned)pairs.size());
+			uinteger frame = 0;
+			run.Run(name, [&](uinteger){
+				step(frame++);
+				uinteger hits = 0;
+				for (uinteger i = 0; i < pairs.size(); i++){
+					const ConvexHull* A = (const ConvexHull*)comps[pairs[i].first]->GetCollider();
+					const ConvexHull* B = (const ConvexHull*)comps[pairs[i].second]->GetCollider();
+					if (GJK_EPA::DoGJK(A, B, NULL, (warm ? &hints[i] : NULL)))
+						hits++;
+				}
+				Consume((real)hits);
+			});
+		}
+
+		for (auto comp : comps)
+			delete comp;
+	}
+
+	// GJK and EPA of the resting contacts, as the box stacking scene of
+	// test_main: columns of boxes on a floor, each sinking a little into
+	// the one below with a small yaw. the pile of random hulls has the
+	// deep overlaps, which expand the polytope more.
+	void BenchEPA(Runner& run, Random& rnd){
+		std::vector<Vector3> corners;
+		for (uinteger i = 0; i < 8; i++)
+			corners.push_back(Vector3((i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : -1.f));
+		ConvexHullBuilder boxBuilder;
+		boxBuilder.Build(corners);
+
+		std::vector<HullComponent*> boxes;
+		HullComponent* floor = new HullComponent(boxBuilder);
+		floor->GetTransform().Scale(25.f, 0.5f, 25.f);
+		floor->Update();
+		boxes.push_back(floor);
+		for (uinteger x = 0; x < 4; x++){
+			for (uinteger z = 0; z < 4; z++){
+				for (uinteger y = 0; y < 6; y++){
+					HullComponent* box = new HullComponent(boxBuilder);
+					box->GetTransform().Translate(x * 3.f - 4.5f, 1.48f + y * 1.98f, z * 3.f - 4.5f);
+					box->GetTransform().Rotate(Vector3::Up, rnd.Range(-0.1f, 0.1f), true);
+					box->Update();
+					boxes.push_back(box);
+				}
+			}
+		}
+
+		std::vector<Vector3> points(64);
+		for (uinteger i = 0; i < points.size(); i++)
+			points[i] = rnd.Direction();
+		ConvexHullBuilder hullBuilder;
+		hullBuilder.Build(points);
+		std::vector<HullComponent*> pile;
+		for (uinteger i = 0; i < 128; i++){
+			HullComponent* comp = new HullComponent(hullBuilder);
+			comp->GetTransform().Translate(rnd.InCube(4.f));
+			comp->GetTransform().Rotate(rnd.Rotation());
+			comp->Update();
+			pile.push_back(comp);
+		}
+
+		const char* names[2] = { "stack", "pile" };
+		std::vector<HullComponent*>* scenes[2] = { &boxes, &pile };
+		for (uinteger s = 0; s < 2; s++){
+			std::vector<HullComponent*>& comps = *scenes[s];
+
+			// the intersecting pairs, with the terminating simplex of GJK.
+			std::vector<std::pair<uinteger, uinteger>> pairs;
+			std::vector<GJK_EPA::Simplex> simplices;
+			for (uinteger i = 0; i < comps.size(); i++){
+				for (uinteger j = i + 1; j < comps.size(); j++){
+					GJK_EPA::Simplex simplex;
+					if (GJK_EPA::DoGJK((const ConvexHull*)comps[i]->GetCollider(),
+						(const ConvexHull*)comps[j]->GetCollider(), &simplex))
+					{
+						pairs.push_back(std::make_pair(i, j));
+						simplices.push_back(simplex);
+					}
+				}
+			}
+
+			char name[64];
+			sprintf(name, "epa.%s_%u", names[s], (unsigned)pairs.size());
+			run.Run(name, [&](uinteger){
+				real sum = 0;
+				for (uinteger i = 0; i < pairs.size(); i++){
+					Vector3 normal;
+					real depth = 0;
+					GJK_EPA::DoEPA((const ConvexHull*)comps[pairs[i].first]->GetCollider(),
+						(const ConvexHull*)comps[pairs[i].second]->GetCollider(),
+						simplices[i], &normal, &depth);
+					sum += depth;
+				}
+				Consume(sum);
+			});
+		}
+
+		for (auto comp : boxes)
+			delete comp;
+		for (auto comp : pile)
+			delete comp;
+	}
+
+	// contact manifolds of the resting box pairs of the stacking scene,
+	// as the narrow-phase makes them. the hulls take GJK, EPA and the
+	// polygon clipping, and the oriented boxes take the separating axis
+	// test and the face clipping. (see Collision::ContactLevelDetection)
+	void BenchContacts(Runner& run, Random& rnd){
+		std::vector<Vector3> corners;
+		for (uinteger i = 0; i < 8; i++)
+			corners.push_back(Vector3((i & 1) ? 1.f : -1.f, (i & 2) ? 1.f : -1.f, (i & 4) ? 1.f : -1.f));
+		ConvexHullBuilder boxBuilder;
+		boxBuilder.Build(corners);
+
+		std::vector<HullComponent*> boxes;
+		HullComponent* floor = new HullComponent(boxBuilder);
+		floor->GetTransform().Scale(25.f, 0.5f, 25.f);
+		floor->Update();
+		boxes.push_back(floor);
+		for (uinteger x = 0; x < 4; x++){
+			for (uinteger z = 0; z < 4; z++){
+				for (uinteger y = 0; y < 6; y++){
+					HullComponent* box = new HullComponent(boxBuilder);
+					box->GetTransform().Translate(x * 3.f - 4.5f, 1.48f + y * 1.98f, z * 3.f - 4.5f);
+					box->GetTransform().Rotate(Vector3::Up, rnd.Range(-0.1f, 0.1f), true);
+					box->Update();
+					boxes.push_back(box);
+				}
+			}
+		}
+
+		// the same boxes as the colliders of the implicit shape.
+		std::vector<OBoxCollider*> oboxes;
+		for (auto box : boxes){
+			OBoxCollider* obox = new OBoxCollider(box, Vector3(0.f), Vector3(1.f));
+			obox->Update();
+			oboxes.push_back(obox);
+		}
+
+		std::vector<std::pair<uinteger, uinteger>> pairs;
+		for (uinteger i = 0; i < boxes.size(); i++){
+			for (uinteger j = i + 1; j < boxes.size(); j++){
+				if (GJK_EPA::DoGJK((const ConvexHull*)boxes[i]->GetCollider(),
+					(const ConvexHull*)boxes[j]->GetCollider()))
+					pairs.push_back(std::make_pair(i, j));
+			}
+		}
+
+		char name[64];
+		sprintf(name, "contact.stack_hull_%u", (unsigned)pairs.size());
+		run.Run(name, [&](uinteger){
+			real sum = 0;
+			ContactManifold manifold;
+			for (uinteger i = 0; i < pairs.size(); i++){
+				const ConvexHull* convex1 = (const ConvexHull*)boxes[pairs[i].first]->GetCollider();
+				const ConvexHull* convex2 = (const ConvexHull*)boxes[pairs[i].second]->GetCollider();
+				GJK_EPA::Simplex simplex;
+				Vector3 normal;
+				real depth = 0;
+				if (!GJK_EPA::DoGJK(convex1, convex2, &simplex)
+					|| !GJK_EPA::DoEPA(convex1, convex2, simplex, &normal, &depth))
+					continue;
+				const Vector3 P = convex1->SupportPoint(normal);
+				manifold.Build(convex1, convex2, -normal, P, depth);
+				sum += manifold.GetPointCount();
+			}
+			Consume(sum);
+		});
+
+		sprintf(name, "contact.stack_obox_%u", (unsigned)pairs.size());
+		run.Run(name, [&](uinteger){
+			real sum = 0;
+			ContactManifold manifold;
+			Vector3 points[tool::OBOX_CONTACT_MAX_POINTS];
+			real depths[tool::OBOX_CONTACT_MAX_POINTS];
+			for (uinteger i = 0; i < pairs.size(); i++){
+				const OBoxCollider* ob1 = oboxes[pairs[i].first];
+				const OBoxCollider* ob2 = oboxes[pairs[i].second];
+				Vector3 ext1, axis1[3], ext2, axis2[3];
+				ob1->GetOrthonormal(ext1, axis1);
+				ob2->GetOrthonormal(ext2, axis2);
+				Vector3 normal;
+				const uinteger count = tool::OBox_OBoxContact(ob1->pos, ext1, axis1, ob2->pos, ext2, axis2,
+					ContactManifold::CONTACT_MARGIN, normal, points, depths);
+				if (count == 0)
+					continue;
+				manifold.Build(normal, points, depths, count,
+					boxes[pairs[i].first]->GetTransform().GetMatrix(),
+					boxes[pairs[i].second]->GetTransform().GetMatrix());
+				sum += manifold.GetPointCount();
+			}
+			Consume(sum);
+		});
+
+		for (auto obox : oboxes)
+			delete obox;
+		for (auto box : boxes)
+			delete box;
+	}
+
+	// triangle mesh - triangle mesh detection of two overlapping spheres,
+	// as Collision::MeshLevelDetection. the brute force one transforms
+	// whole vertices and tests every pair of the triangles, and the other
+	// tests only the pairs of the overlapping leaves of the hierarchies.
+	void BenchMeshLevel(Runner& run, Random& rnd){
+		const uinteger slices = 32, stacks = 16;
+		std::vector<Position3> points;
+		std::vector<TriangleFace16> faces;
+		for (uinteger y = 0; y <= stacks; y++){
+			const real phi = math::PI * y / stacks;
+			for (uinteger x = 0; x <= slices; x++){
+				const real theta = 2.f * math::PI * x / slices;
+				points.push_back(Position3(sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta)));
+			}
+		}
+		for (uinteger y = 0; y < stacks; y++){
+			for (uinteger x = 0; x < slices; x++){
+				const uint16 a = (uint16)(y * (slices + 1) + x);
+				const uint16 b = (uint16)(a + slices + 1);
+				faces.push_back(TriangleFace16(a, b, a + 1));
+				faces.push_back(TriangleFace16(a + 1, b, b + 1));
+			}
+		}
+
+		CollisionGeometry geometry;
+		geometry.Build(&points[0], points.size(), &faces[0], faces.size());
+		const TriangleBVH& bvh = geometry.GetTriangleBVH();
+
+		// the second one sinks into the first by about a quarter.
+		const Matrix4 TM1 = rnd.Rigid(0.f);
+		Matrix4 TM2 = rnd.Rigid(0.f);
+		TM2.m[0][3] = TM1.m[0][3] + rnd.Range(1.7f, 1.8f);
+		TM2.m[1][3] = TM1.m[1][3] + rnd.Range(-0.2f, 0.2f);
+		TM2.m[2][3] = TM1.m[2][3] + rnd.Range(-0.2f, 0.2f);
+
+		char name[64];
+		sprintf(name, "mesh.brute_%u", (unsigned)faces.size());
+		std::vector<Position3> trans1(points.size()), trans2(points.size());
+		run.Run(name, [&](uinteger){
+			tool::TransformPoints(TM1, &points[0], points.size(), &trans1[0]);
+			tool::TransformPoints(TM2, &points[0], points.size(), &trans2[0]);
+			Vector3 P, Q, n;
+			uinteger hits = 0;
+			for (uinteger i = 0; i < faces.size(); i++){
+				for (uinteger j = 0; j < faces.size(); j++){
+					if (tool::Triangle_TriangleIntersection(
+						trans1[faces[i].a], trans1[faces[i].b], trans1[faces[i].c],
+						trans2[faces[j].a], trans2[faces[j].b], trans2[faces[j].c], &P, &Q, &n))
+						hits++;
+				}
+			}
+			Consume((real)hits);
+		});
+
+		sprintf(name, "mesh.bvh_%u", (unsigned)faces.size());
+		run.Run(name, [&](uinteger){
+			Position3 A1, B1, C1, A2, B2, C2;
+			Vector3 P, Q, n;
+			uinteger hits = 0;
+			bvh.FindOverlaps(TM1, bvh, TM2, [&](uinteger tri1, uinteger tri2){
+				bvh.GetWorldTriangle(tri1, TM1, A1, B1, C1);
+				bvh.GetWorldTriangle(tri2, TM2, A2, B2, C2);
+				if (tool::Triangle_TriangleIntersection(A1, B1, C1, A2, B2, C2, &P, &Q, &n))
+					hits++;
+			});
+			Consume((real)hits);
+		});
+	}
+
+	// GJK of a unit sphere and the boxes around it. the sphere is the
+	// hull of the points of a sphere mesh with and without the faces, and
+	// the implicit one whose support point is a single evaluation.
+	void BenchImplicitShapes(Runner& run, Random& rnd){
+		Hull sphere;
+		MakeSphereHull(sphere, 21, 50);
+		const ConvexHull sphereHull(NULL, sphere.points, sphere.faces);
+		const ConvexHull sphereCloud(NULL, sphere.points);
+		const SphereCollider sphereShape(NULL, Vector3(0.f), 1.f);
+
+		std::vector<Vector3> corners;
+		for (uinteger i = 0; i < 8; i++)
+			corners.push_back(Vector3((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f));
+		ConvexHullBuilder boxBuilder;
+		boxBuilder.Build(corners);
+
+		// about half of them touch the sphere.
+		std::vector<HullComponent*> boxes;
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			HullComponent* box = new HullComponent(boxBuilder);
+			box->GetTransform().Translate(rnd.Direction() * rnd.Range(1.f, 2.f));
+			box->GetTransform().Rotate(rnd.Rotation());
+			box->Update();
+			boxes.push_back(box);
+		}
+
+		const ASupportShape* shapes[3] = { &sphereCloud, &sphereHull, &sphereShape };
+		const char* names[3] = { "cloud", "hull", "implicit" };
+		for (uinteger s = 0; s < 3; s++){
+			char name[64];
+			sprintf(name, "gjk.sphere_%s_%u", names[s], (unsigned)(s < 2 ? sphere.points.size() : 1));
+			run.Run(name, [&](uinteger i){
+				Consume((real)GJK_EPA::DoGJK(shapes[s], (const ConvexHull*)boxes[i]->GetCollider()));
+			});
+		}
+
+		for (auto box : boxes)
+			delete box;
+	}
+
+	// random oriented box. the extents are in [0.5, 2.5).
+	struct OBox{
+		Vector3 p;
+		Vector3 ext;
+		Vector3 axis[3];
+		Vector3 min, max; // bounds of axis aligned case
+	};
+
+	void BenchIntersections(Runner& run, Random& rnd){
+		// the shapes are in a small volume, so the rate of hit is
+		// about half on most cases and both branches are measured.
+		std::vector<Vector3> rayP(SET_SIZE), rayV(SET_SIZE);
+		std::vector<Vector3> A(SET_SIZE), B(SET_SIZE), C(SET_SIZE);
+		std::vector<Vector3> sphereP(SET_SIZE);
+		std::vector<real> sphereR(SET_SIZE);
+		std::vector<OBox> box(SET_SIZE);
+		for (uinteger i = 0; i < SET_SIZE; i++){
+			rayP[i] = rnd.InCube(6.f);
+			rayV[i] = rnd.Direction();
+			A[i] = rnd.InCube(3.f);
+			B[i] = A[i] + rnd.InCube(3.f);
+			C[i] = A[i] + rnd.InCube(3.f);
+			sphereP[i] = rnd.InCube(4.f);
+			sphereR[i] = rnd.Range(0.5f, 2.5f);
+
+			OBox& b = box[i];
+			b.p = rnd.InCube(3.f);
+			b.ext = Vector3(rnd.Range(0.5f, 2.5f), rnd.Range(0.5f, 2.5f), rnd.Range(0.5f, 2.5f));
+			Matrix3 R = rnd.Rotation().ToMatrix3(true);
+			b.axis[0] = Vector3(R.m[0][0], R.m[1][0], R.m[2][0]);
+			b.axis[1] = Vector3(R.m[0][1], R.m[1][1], R.m[2][1]);
+			b.axis[2] = Vector3(R.m[0][2], R.m[1][2], R.m[2][2]);
+			b.min = b.p - b.ext;
+			b.max = b.p + b.ext;
+		}
+		const real rayL = 20.f;
+
+#define NEXT(i) (((i) + 1) & SET_MASK)
+
+		run.Run("tool.ray_triangle", [&](uinteger i){
+			Vector3 P;
+			Consume(tool::Ray_TriangleIntersection(rayP[i], rayV[i], rayL, A[i], B[i], C[i], &P));
+		});
+		run.Run("tool.ray_plane", [&](uinteger i){
+			Vector3 P;
+			Consume(tool::Ray_PlaneIntersection(rayP[i], rayV[i], rayL, rayV[NEXT(i)], A[i], &P));
+		});
+		run.Run("tool.ray_plane_d", [&](uinteger i){
+			Vector3 P;
+			Consume(tool::Ray_PlaneIntersection(rayP[i], rayV[i], rayL, rayV[NEXT(i)], sphereR[i], &P));
+		});
+		run.Run("tool.ray_sphere", [&](uinteger i){
+			Vector3 P;
+			Consume(tool::Ray_SphereIntersection(rayP[i], rayV[i], rayL, sphereP[i], sphereR[i], &P));
+		});
+		run.Run("tool.ray_aabox", [&](uinteger i){
+			Vector3 P;
+			Consume(tool::Ray_AABoxIntersection(rayP[i], rayV[i], rayL, box[i].min, box[i].max, &P));
+		});
+		run.Run("tool.ray_obox", [&](uinteger i){
+			Vector3 P;
+			Consume(tool::Ray_OBoxIntersection(rayP[i], rayV[i], rayL, box[i].p, box[i].ext, box[i].axis, &P));
+		});
+		run.Run("tool.ray_barycentric", [&](uinteger i){
+			real t, u, v;
+			Consume(tool::Ray_BarycentricCoordIntersection(rayP[i], rayV[i], A[i], B[i] - A[i], C[i] - A[i], &t, &u, &v));
+		});
+		run.Run("tool.triangle_plane", [&](uinteger i){
+			Vector3 P, Q;
+			Consume(tool::Triangle_PlaneIntersection(A[i], B[i], C[i], rayV[i], sphereP[i], &P, &Q));
+		});
+		run.Run("tool.triangle_triangle", [&](uinteger i){
+			uinteger j = NEXT(i);
+			Vector3 P, Q, n;
+			Consume(tool::Triangle_TriangleIntersection(A[i], B[i], C[i], A[j], B[j], C[j], &P, &Q, &n));
+		});
+		run.Run("tool.sphere_sphere", [&](uinteger i){
+			uinteger j = NEXT(i);
+			Vector3 P;
+			Consume(tool::Sphere_SphereIntersection(sphereP[i], sphereR[i], sphereP[j], sphereR[j], &P));
+		});
+		run.Run("tool.sphere_aabox", [&](uinteger i){
+			Consume(tool::Sphere_AABoxIntersection(sphereP[i], sphereR[i], box[i].min, box[i].max));
+		});
+		run.Run("tool.sphere_obox", [&](uinteger i){
+			Consume(tool::Sphere_OBoxIntersection(sphereP[i], sphereR[i], box[i].p, box[i].ext, box[i].axis));
+		});
+		run.Run("tool.aabox_aabox", [&](uinteger i){
+			uinteger j = NEXT(i);
+			Consume(tool::AABox_AABoxIntersection(box[i].min, box[i].max, box[j].min, box[j].max));
+		});
+		run.Run("tool.aabox_obox", [&](uinteger i){
+			uinteger j = NEXT(i);
+			Consume(tool::AABox_OBoxIntersection(box[i].min, box[i].max, box[j].p, box[j].ext, box[j].axis));
+		});
+		run.Run("tool.obox_obox", [&](uinteger i){
+			uinteger j = NEXT(i);
+			Consume(tool::OBox_OBoxIntersection(box[i].p, box[i].ext, box[i].axis, box[j].p, box[j].ext, box[j].axis));
+		});
+
+#undef NEXT
+	}
+}
+
+int main(int argc, char** argv){
+	Options opt;
+	if (!ParseOptions(argc, argv, opt))
+		return 1;
+
+	Runner run(opt);
+
+	// each group has its own generator, so that adding a case
+	// to a group does not change the inputs of the others.
+	{ Random rnd(opt.seed + 1); BenchVector3(run, rnd); }
+	{ Random rnd(opt.seed + 2); BenchVector4(run, rnd); }
+	{ Random rnd(opt.seed + 3); BenchMatrix4(run, rnd); }
+	{ Random rnd(opt.seed + 4); BenchQuaternion(run, rnd); }
+	{ Random rnd(opt.seed + 5); BenchTransform(run, rnd); }
+	{ Random rnd(opt.seed + 6); BenchIntersections(run, rnd); }
+	{ Random rnd(opt.seed + 7); BenchScalar(run, rnd); }
+	{ Random rnd(opt.seed + 8); BenchSupport(run, rnd); }
+	{ Random rnd(opt.seed + 9); BenchHullBuild(run, rnd); }
+	{ Random rnd(opt.seed + 10); BenchBroadphase(run, rnd); }
+	{ Random rnd(opt.seed + 11); BenchRaycast(run, rnd); }
+	{ Random rnd(opt.seed + 12); BenchNarrowphase(run, rnd); }
+	{ Random rnd(opt.seed + 13); BenchEPA(run, rnd); }
+	{ Random rnd(opt.seed + 14); BenchMeshLevel(run, rnd); }
+	{ Random rnd(opt.seed + 15); BenchImplicitShapes(run, rnd); }
+	{ Random rnd(opt.seed + 16); BenchContacts(run, rnd); }
+
+	FILE* fp = stdout;
+	if (!opt.outPath.empty()){
+		fp = fopen(opt.outPath.c_str(), "w");
+		if (fp == NULL){
+			fprintf(stderr, "can not open %s\n", opt.outPath.c_str());
+			return 1;
+		}
+	}
+	WriteJSON(fp, opt, run.GetResults());
+	if (fp != stdout)
+		fclose(fp);
+
+	return 0;
+}
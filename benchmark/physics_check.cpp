@@ -0,0 +1,392 @@
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+
+#include "core.h"
+#include "AScene.h"
+#include "Collision.h"
+#include "GJK_EPA.h"
+#include "RigidBody.h"
+#include "SphereCollider.h"
+#include "OBoxCollider.h"
+#include "CapsuleCollider.h"
+#include "ConvexHull.h"
+#include "ConvexHullBuilder.h"
+
+/**
+behavior check of the rigid body simulation.
+
+it runs the small scenes headless (1/60 second a frame) and checks
+  1. the contacts of the analytic, the polygon and the GJK/EPA paths,
+     and the margin of the support shapes.
+  2. the linear casts (time of impact) of a sphere and a capsule.
+  3. a box stack resolved by the contact solver, its islands going to
+     sleep, and a force waking up only its island.
+  4. a bullet which stops at a thin wall, which a normal body tunnels.
+  5. the trigger overlaps and the category and mask filtering.
+  6. the same results at any thread count of the narrow-phase.
+it returns non-zero when any of them fails.
+*/
+
+using namespace sark;
+
+namespace {
+
+	int gFailures = 0;
+
+	void Check(const char* name, double value, double tolerance){
+		bool ok = (value <= tolerance);
+		printf("%-40s %12.4g (tolerance %.3g) %s\n", name, value, tolerance, ok ? "ok" : "FAILED");
+		if (!ok)
+			gFailures++;
+	}
+
+	void CheckTrue(const char* name, bool value){
+		Check(name, value ? 0 : 1, 0);
+	}
+
+	// scene component of a collider and a rigid body, which is
+	// updated as StaticModel. (collider first, then the body)
+	class Body : public ASceneComponent {
+	public:
+		enum Shape { SPHERE, BOX, CAPSULE, HULL };
+
+	private:
+		ACollider* mCollider;
+		RigidBody* mRigidBody;
+
+	public:
+		// 'size' is the radius of sphere, the extents of box and hull,
+		// and (radius, half length) of capsule.
+		Body(Shape shape, const Vector3& size, real invMass, const Vector3& position)
+			: ASceneComponent("", NULL, true)
+		{
+			Vector3 ext = size;
+			switch (shape){
+			case SPHERE:
+				mCollider = new SphereCollider(this, Vector3(0.f), size.x);
+				ext = Vector3(size.x);
+				break;
+			case BOX:
+				mCollider = new OBoxCollider(this, Vector3(0.f), size);
+				break;
+			case CAPSULE:
+				mCollider = new CapsuleCollider(this, Vector3(0.f), size.y, size.x);
+				ext = Vector3(size.x, size.x + size.y, size.x);
+				break;
+			case HULL:{
+				std::vector<Vector3> corners;
+				for (int i = 0; i < 8; i++)
+					corners.push_back(Vector3((i & 1) ? size.x : -size.x, (i & 2) ? size.y : -size.y, (i & 4) ? size.z : -size.z));
+				ConvexHullBuilder builder;
+				builder.Build(corners);
+				mCollider = new ConvexHull(this, builder.GetPointSet(), builder.GetFaceSet());
+				break;
+			}
+			}
+
+			// inertia of the box of the extents.
+			Matrix3 invI;
+			invI.MakeIdentity();
+			invI.m[0][0] = invMass * 3.f / (ext.y * ext.y + ext.z * ext.z);
+			invI.m[1][1] = invMass * 3.f / (ext.x * ext.x + ext.z * ext.z);
+			invI.m[2][2] = invMass * 3.f / (ext.x * ext.x + ext.y * ext.y);
+			mRigidBody = new RigidBody(this, invMass, invI, Vector3(0.f), Vector3(0.f), invMass != 0);
+
+			GetTransform().Translate(position);
+			mCollider->Update();
+		}
+
+		~Body(){
+			delete mCollider;
+			delete mRigidBody;
+		}
+
+		void Update() override{
+			mCollider->Update();
+			mRigidBody->Update();
+		}
+		void Render() override{}
+		ACollider* GetCollider() override{ return mCollider; }
+		Mesh* GetMesh() override{ return NULL; }
+		const CollisionGeometry* GetCollisionGeometry() override{ return NULL; }
+		RigidBody* GetRigidBody() override{ return mRigidBody; }
+
+		const Vector3 GetPosition(){ return GetTransform().GetPosition(); }
+	};
+
+	// bodies of a scene, which are deleted together.
+	class Scene {
+	public:
+		AScene::Layer layer;
+		std::vector<Body*> bodies;
+
+		Body* Add(Body::Shape shape, const Vector3& size, real invMass, const Vector3& position){
+			Body* body = new Body(shape, size, invMass, position);
+			layer.Push(body);
+			bodies.push_back(body);
+			return body;
+		}
+
+		void Step(uinteger frames = 1){
+			for (uinteger f = 0; f < frames; f++){
+				for (auto itr = layer.Begin(); itr != layer.End(); itr++)
+					(*itr)->Update();
+				Collision::ProcessConvexCollision(layer);
+			}
+		}
+
+		~Scene(){
+			// the collision keeps the pairs of the last process, so
+			// it processes an empty layer before the bodies go.
+			AScene::Layer empty;
+			Collision::ProcessConvexCollision(empty);
+			layer.Clear();
+			for (auto body : bodies)
+				delete body;
+		}
+	};
+
+
+	//=============================================
+	//		1. contacts
+	//=============================================
+
+	// contact of the pair, and the errors of its depth and normal.
+	void CheckContact(const char* name, Body& body1, Body& body2,
+		real depth, const Vector3& normal, uinteger minPoints)
+	{
+		ContactManifold manifold;
+		bool hit = Collision::ContactLevelDetection(body1.GetCollider(), body2.GetCollider(), manifold);
+		char label[64];
+		sprintf(label, "%s contact found", name);
+		CheckTrue(label, hit && manifold.GetPointCount() >= minPoints);
+		if (!hit)
+			return;
+		sprintf(label, "%s depth error", name);
+		Check(label, fabs(manifold.GetMaxDepth() - depth), 2e-3);
+		sprintf(label, "%s normal error", name);
+		Check(label, (manifold.GetNormal() - normal).Magnitude(), 2e-3);
+	}
+
+	void CheckContacts(){
+		// analytic sphere-sphere, sphere-box and box-box.
+		Body s1(Body::SPHERE, Vector3(1.f), 1, Vector3(0.f, 0.f, 0.f));
+		Body s2(Body::SPHERE, Vector3(1.f), 1, Vector3(1.5f, 0.f, 0.f));
+		CheckContact("sphere-sphere", s2, s1, 0.5f, Vector3(1.f, 0.f, 0.f), 1);
+
+		Body box(Body::BOX, Vector3(1.f), 0, Vector3(0.f));
+		Body s3(Body::SPHERE, Vector3(0.5f), 1, Vector3(0.2f, 1.3f, 0.f));
+		CheckContact("sphere-box", s3, box, 0.2f, Vector3(0.f, 1.f, 0.f), 1);
+
+		Body b2(Body::BOX, Vector3(1.f), 1, Vector3(0.3f, 1.9f, 0.2f));
+		CheckContact("box-box", b2, box, 0.1f, Vector3(0.f, 1.f, 0.f), 4);
+
+		// polygons of the hulls.
+		Body h1(Body::HULL, Vector3(1.f), 0, Vector3(0.f));
+		Body h2(Body::HULL, Vector3(0.5f), 1, Vector3(0.2f, 1.45f, -0.1f));
+		CheckContact("hull-hull", h2, h1, 0.05f, Vector3(0.f, 1.f, 0.f), 4);
+
+		// GJK and EPA of the capsule.
+		Body c1(Body::CAPSULE, Vector3(0.5f, 1.f, 0.f), 1, Vector3(0.1f, 2.4f, 0.f));
+		CheckContact("capsule-box", c1, box, 0.1f, Vector3(0.f, 1.f, 0.f), 1);
+
+		// the margin rounds the hull, and the pair takes GJK and EPA.
+		Body h3(Body::HULL, Vector3(0.5f), 1, Vector3(0.f, 1.55f, 0.f));
+		dynamic_cast<ConvexHull*>(h3.GetCollider())->SetMargin(0.1f);
+		h3.GetCollider()->Update();
+		CheckContact("hull with margin-box", h3, box, 0.05f, Vector3(0.f, 1.f, 0.f), 1);
+	}
+
+
+	//=============================================
+	//		2. linear casts
+	//=============================================
+
+	void CheckLinearCast(const char* name, Body& body, Body& target, const Vector3& translation,
+		real toi, const Vector3& normal)
+	{
+		real t = -1;
+		Vector3 n;
+		bool hit = GJK_EPA::DoLinearCast(ACollider::GetSupportShape(body.GetCollider()),
+			ACollider::GetSupportShape(target.GetCollider()), translation, &t, &n);
+		char label[64];
+		sprintf(label, "%s hit", name);
+		CheckTrue(label, hit);
+		sprintf(label, "%s time of impact error", name);
+		Check(label, fabs(t - toi), 1e-3);
+		sprintf(label, "%s normal error", name);
+		Check(label, (n - normal).Magnitude(), 1e-2);
+	}
+
+	void CheckLinearCasts(){
+		Body box(Body::BOX, Vector3(1.f), 0, Vector3(0.f));
+
+		// the sphere touches the box at x = -1 - 0.5.
+		Body sphere(Body::SPHERE, Vector3(0.5f), 1, Vector3(-5.f, 0.2f, 0.f));
+		CheckLinearCast("sphere cast", sphere, box, Vector3(10.f, 0.f, 0.f), 0.35f, Vector3(-1.f, 0.f, 0.f));
+
+		// the capsule falls onto the box by its lower cap.
+		Body capsule(Body::CAPSULE, Vector3(0.5f, 1.f, 0.f), 1, Vector3(0.3f, 6.f, 0.f));
+		CheckLinearCast("capsule cast", capsule, box, Vector3(0.f, -8.f, 0.f), 0.4375f, Vector3(0.f, 1.f, 0.f));
+
+		CheckTrue("cast miss", !GJK_EPA::DoLinearCast(ACollider::GetSupportShape(sphere.GetCollider()),
+			ACollider::GetSupportShape(box.GetCollider()), Vector3(0.f, 0.f, 10.f)));
+	}
+
+
+	//=============================================
+	//		3. stack, islands and sleeping
+	//=============================================
+
+	void CheckStack(){
+		Collision::SetSolverIterations(16);
+		{
+			Scene scene;
+			scene.Add(Body::BOX, Vector3(10.f, 0.5f, 10.f), 0, Vector3(0.f));
+			Body* boxes[3];
+			for (int i = 0; i < 3; i++)
+				boxes[i] = scene.Add(Body::BOX, Vector3(0.5f), 1, Vector3(0.f, 1.f + i, 0.f));
+			Body* lone = scene.Add(Body::SPHERE, Vector3(0.5f), 1, Vector3(5.f, 1.f, 0.f));
+
+			// 5 seconds
+			scene.Step(300);
+			const Vector3 top = boxes[2]->GetPosition();
+			Check("stack top sink", fabs(top.y - 3.f), 0.05);
+			Check("stack top drift", sqrt(top.x * top.x + top.z * top.z), 0.05);
+
+			bool asleep = true;
+			for (auto body : scene.bodies)
+				asleep = asleep && !body->GetRigidBody()->IsActive();
+			CheckTrue("resting bodies asleep", asleep);
+
+			// a push on the bottom wakes its island, not the lone sphere.
+			boxes[0]->GetRigidBody()->AddForce(Vector3(0.f, 0.f, 1.f));
+			scene.Step();
+			bool awake = true;
+			for (int i = 0; i < 3; i++)
+				awake = awake && boxes[i]->GetRigidBody()->IsAwake();
+			CheckTrue("pushed island awake", awake);
+			CheckTrue("other island asleep", !lone->GetRigidBody()->IsAwake());
+
+			// and the island sleeps again.
+			scene.Step(300);
+			CheckTrue("pushed island asleep again", !boxes[2]->GetRigidBody()->IsAwake());
+			Check("stack top sink after push", fabs(boxes[2]->GetPosition().y - 3.f), 0.05);
+		}
+		Collision::SetSolverIterations(ContactSolver::DEFAULT_ITERATIONS);
+	}
+
+
+	//=============================================
+	//		4. bullets
+	//=============================================
+
+	// x of the small sphere shot at 600 m/s onto the thin wall at x = 0.
+	real Shoot(bool bullet){
+		Scene scene;
+		scene.Add(Body::BOX, Vector3(0.05f, 2.f, 2.f), 0, Vector3(0.f));
+		Body* shot = scene.Add(Body::SPHERE, Vector3(0.1f), 1, Vector3(-3.f, 0.f, 0.f));
+		shot->GetRigidBody()->GravityOn(false);
+		shot->GetRigidBody()->SetVelocity(Vector3(600.f, 0.f, 0.f));
+		shot->GetRigidBody()->SetBullet(bullet);
+		scene.Step(10);
+		return shot->GetPosition().x;
+	}
+
+	void CheckBullets(){
+		CheckTrue("normal body tunnels", Shoot(false) > 0.f);
+		CheckTrue("bullet stops at wall", Shoot(true) < 0.f);
+	}
+
+
+	//=============================================
+	//		5. triggers and filtering
+	//=============================================
+
+	void CheckFiltering(){
+		{
+			// a sphere falls through a trigger box.
+			Scene scene;
+			Body* trigger = scene.Add(Body::BOX, Vector3(1.f), 0, Vector3(0.f));
+			trigger->GetCollider()->SetTrigger(true);
+			Body* ball = scene.Add(Body::SPHERE, Vector3(0.5f), 1, Vector3(0.f, 2.f, 0.f));
+
+			int begins = 0, overlaps = 0;
+			for (int f = 0; f < 120; f++){
+				scene.Step();
+				for (auto& o : Collision::GetTriggerOverlaps()){
+					overlaps++;
+					if (o.begin)
+						begins++;
+				}
+			}
+			Check("trigger overlap begins", fabs(begins - 1.0), 0);
+			CheckTrue("trigger overlaps over frames", overlaps > 1);
+			CheckTrue("trigger overlaps end", Collision::GetTriggerOverlaps().empty());
+			CheckTrue("trigger has no response", ball->GetPosition().y < -2.f);
+		}
+		{
+			// the box whose mask excludes the category of the floor falls through.
+			Scene scene;
+			Body* floor = scene.Add(Body::BOX, Vector3(10.f, 0.5f, 10.f), 0, Vector3(0.f));
+			floor->GetCollider()->SetCategory(1 << 1);
+			Body* kept = scene.Add(Body::BOX, Vector3(0.5f), 1, Vector3(-2.f, 1.f, 0.f));
+			Body* dropped = scene.Add(Body::BOX, Vector3(0.5f), 1, Vector3(2.f, 1.f, 0.f));
+			dropped->GetCollider()->SetMask(ACollider::ALL_CATEGORIES & ~(1 << 1));
+			scene.Step(120);
+			Check("masked-in box rests", fabs(kept->GetPosition().y - 1.f), 0.05);
+			CheckTrue("masked-out box falls through", dropped->GetPosition().y < -2.f);
+		}
+	}
+
+
+	//=============================================
+	//		6. thread count
+	//=============================================
+
+	// positions of a pile of mixed bodies after 3 seconds.
+	void RunPile(uinteger threads, std::vector<Vector3>& out_positions){
+		Collision::SetThreadCount(threads);
+		Scene scene;
+		scene.Add(Body::BOX, Vector3(10.f, 0.5f, 10.f), 0, Vector3(0.f));
+		const Body::Shape shapes[4] = { Body::BOX, Body::SPHERE, Body::CAPSULE, Body::HULL };
+		for (int i = 0; i < 24; i++){
+			Vector3 p(-1.5f + (i % 4) * 1.1f, 1.f + (i / 4) * 1.2f, -0.5f + (i % 3) * 0.6f);
+			Body* body = scene.Add(shapes[i % 4], Vector3(0.4f, 0.3f, 0.35f), 1, p);
+			body->GetTransform().Rotate(Vector3(1.f, 1.f, 0.f).Normal(), 0.3f * i, true);
+		}
+		scene.Step(180);
+		out_positions.clear();
+		for (auto body : scene.bodies)
+			out_positions.push_back(body->GetPosition());
+	}
+
+	void CheckThreadCount(){
+		std::vector<Vector3> serial, parallel;
+		RunPile(1, serial);
+		RunPile(4, parallel);
+		Collision::SetThreadCount(0);
+
+		int differences = 0;
+		for (uinteger i = 0; i < serial.size(); i++){
+			if (memcmp(&serial[i], &parallel[i], sizeof(Vector3)) != 0)
+				differences++;
+		}
+		Check("positions differing by thread count", differences, 0);
+	}
+}
+
+int main(){
+	CheckContacts();
+	CheckLinearCasts();
+	CheckStack();
+	CheckBullets();
+	CheckFiltering();
+	CheckThreadCount();
+
+	printf("%d failure(s)\n", gFailures);
+	return (gFailures == 0 ? 0 : 1);
+}